@@ -0,0 +1,154 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ARCH_H_
+#define _ARCH_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/internal/arch/scalar/quote.h>
+#include <sonic/internal/arch/scalar/skip.h>
+#include <sonic/internal/arch/scalar/structural.h>
+#include <sonic/internal/arch/sonic_cpu_feature.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <sonic/internal/arch/avx2/quote.h>
+#include <sonic/internal/arch/avx2/skip.h>
+#include <sonic/internal/arch/avx2/structural.h>
+#include <sonic/internal/arch/avx512/quote.h>
+#include <sonic/internal/arch/avx512/skip.h>
+#include <sonic/internal/arch/avx512/structural.h>
+#include <sonic/internal/arch/sse/quote.h>
+#include <sonic/internal/arch/sse/skip.h>
+#include <sonic/internal/arch/sse/structural.h>
+#endif
+
+// The kernels of the arch backends, to compare the scalar fallback with the
+// SIMD ones on the same machine. The x86 kernels have their own target
+// attributes, so they are called by pointers whatever the compiler flags.
+struct ArchKernels {
+  const char* name;
+  bool (*skip_container)(const uint8_t*, size_t&, size_t, uint8_t, uint8_t);
+  uint8_t (*next_token)(const uint8_t*, size_t&, size_t, const char (&)[2]);
+  int (*skip_string)(const uint8_t*, size_t&, size_t);
+  size_t (*build_index)(const uint8_t*, size_t, uint32_t*);
+  char* (*quote)(const char*, size_t, char*);
+};
+
+#define SONIC_ARCH_KERNELS(arch)                          \
+  ArchKernels {                                           \
+    #arch, sonic_json::internal::arch::SkipContainer,     \
+        sonic_json::internal::arch::GetNextToken<2>,      \
+        sonic_json::internal::arch::SkipString,           \
+        sonic_json::internal::arch::BuildStructuralIndex, \
+        sonic_json::internal::arch::Quote                 \
+  }
+
+// Skip the whole json, which must be an object or array.
+static void BM_ArchSkip(benchmark::State& state, ArchKernels arch,
+                        std::string_view json) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+  uint8_t left = data[0], right = left + 2;
+  for (auto _ : state) {
+    size_t pos = 1;
+    if (!arch.skip_container(data, pos, json.size(), left, right)) {
+      state.SkipWithError("Failed to skip");
+      return;
+    }
+    benchmark::DoNotOptimize(pos);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+// Skip all strings in the json one by one, as the on-demand parsing does.
+static void BM_ArchString(benchmark::State& state, ArchKernels arch,
+                          std::string_view json) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+  for (auto _ : state) {
+    size_t pos = 0, n = 0;
+    while (arch.next_token(data, pos, json.size(), "\"") == '"') {
+      pos++;
+      if (!arch.skip_string(data, pos, json.size())) {
+        state.SkipWithError("Failed to skip string");
+        return;
+      }
+      n++;
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void BM_ArchIndex(benchmark::State& state, ArchKernels arch,
+                         std::string_view json) {
+  std::vector<uint32_t> index(json.size() + 8);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+  for (auto _ : state) {
+    size_t n = arch.build_index(data, json.size(), index.data());
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+// Quote the whole json text as a string, most chars are not escaped.
+static void BM_ArchQuote(benchmark::State& state, ArchKernels arch,
+                         std::string_view json) {
+  std::vector<char> buf(json.size() * 6 + 32);
+  for (auto _ : state) {
+    char* end = arch.quote(json.data(), json.size(), buf.data());
+    benchmark::DoNotOptimize(end);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Arch(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  std::vector<ArchKernels> archs = {
+      SONIC_ARCH_KERNELS(scalar),
+#if defined(__x86_64__)
+      SONIC_ARCH_KERNELS(sse),
+      SONIC_ARCH_KERNELS(avx2),
+#endif
+  };
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512bw")) {
+    archs.push_back(SONIC_ARCH_KERNELS(avx512));
+  }
+#endif
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    char c = json.second.empty() ? 0 : json.second[0];
+    for (const auto& arch : archs) {
+      std::string suffix = std::string("_") + arch.name;
+      if (c == '{' || c == '[') {
+        benchmark::RegisterBenchmark((name + "/ArchSkip" + suffix).c_str(),
+                                     BM_ArchSkip, arch, json.second);
+      }
+      benchmark::RegisterBenchmark((name + "/ArchString" + suffix).c_str(),
+                                   BM_ArchString, arch, json.second);
+      benchmark::RegisterBenchmark((name + "/ArchIndex" + suffix).c_str(),
+                                   BM_ArchIndex, arch, json.second);
+      benchmark::RegisterBenchmark((name + "/ArchQuote" + suffix).c_str(),
+                                   BM_ArchQuote, arch, json.second);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _COMPACT_H_
+#define _COMPACT_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "packed.hpp"
+
+// Compare the 8-byte nodes of CompactDocument with the 16-byte DNodes: the
+// parsing with the bytes of the DOM, the traversal of all values and the
+// serializing.
+
+// Visit all values, with the string bytes and the numbers summed.
+template <typename NodeType>
+static double visit_all(const NodeType& node) {
+  double sum = 0;
+  if (node.IsObject()) {
+    for (auto m = node.MemberBegin(); m != node.MemberEnd(); ++m) {
+      sum += m->name.GetStringView().size() + visit_all(m->value);
+    }
+  } else if (node.IsArray()) {
+    for (auto it = node.Begin(); it != node.End(); ++it) {
+      sum += visit_all(*it);
+    }
+  } else if (node.IsString()) {
+    sum += node.GetStringView().size();
+  } else if (node.IsNumber()) {
+    sum += node.GetDouble();
+  }
+  return sum;
+}
+
+static void BM_CompactParse_DNode(benchmark::State& state,
+                                  std::string_view json) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    CountingDocument doc;
+    doc.Parse(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    bytes = doc.GetAllocator().bytes;
+  }
+  state.counters["bytes"] = bytes;
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void BM_CompactParse_Compact(benchmark::State& state,
+                                    std::string_view json) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    sonic_json::CompactDocument doc;
+    doc.Parse(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    bytes = doc.GetMemoryUsage();
+  }
+  state.counters["bytes"] = bytes;
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+template <typename DocType>
+static const auto& compact_root(const DocType& doc) {
+  if constexpr (std::is_same<DocType, sonic_json::CompactDocument>::value) {
+    return doc.GetRoot();
+  } else {
+    return doc;
+  }
+}
+
+template <typename DocType>
+static void BM_CompactTraverse(benchmark::State& state, std::string_view json) {
+  DocType doc;
+  doc.Parse(json.data(), json.size());
+  if (doc.HasParseError()) {
+    state.SkipWithError("Failed to parse");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(visit_all(compact_root(doc)));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+template <typename DocType>
+static void BM_CompactSerialize(benchmark::State& state,
+                                std::string_view json) {
+  DocType doc;
+  doc.Parse(json.data(), json.size());
+  if (doc.HasParseError()) {
+    state.SkipWithError("Failed to parse");
+    return;
+  }
+  sonic_json::WriteBuffer wb;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(doc.Serialize(wb));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Compact(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    if (name != "twitter" && name != "citm_catalog" && name != "canada") {
+      continue;
+    }
+    benchmark::RegisterBenchmark((name + "/Compact_Parse_DNode").c_str(),
+                                 BM_CompactParse_DNode, json.second);
+    benchmark::RegisterBenchmark((name + "/Compact_Parse_Compact").c_str(),
+                                 BM_CompactParse_Compact, json.second);
+    benchmark::RegisterBenchmark((name + "/Compact_Traverse_DNode").c_str(),
+                                 BM_CompactTraverse<sonic_json::Document>,
+                                 json.second);
+    benchmark::RegisterBenchmark(
+        (name + "/Compact_Traverse_Compact").c_str(),
+        BM_CompactTraverse<sonic_json::CompactDocument>, json.second);
+    benchmark::RegisterBenchmark((name + "/Compact_Serialize_DNode").c_str(),
+                                 BM_CompactSerialize<sonic_json::Document>,
+                                 json.second);
+    benchmark::RegisterBenchmark(
+        (name + "/Compact_Serialize_Compact").c_str(),
+        BM_CompactSerialize<sonic_json::CompactDocument>, json.second);
+  }
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LAZY_H_
+#define _LAZY_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Compare LazyDocument with Document when only one field of the json is read,
+// and the json is serialized back, as a proxy that forwards the payloads.
+
+static sonic_json::JsonPointer lazy_path(const std::string& name) {
+  if (name == "twitter") {
+    return sonic_json::JsonPointer({"statuses", 1, "user", "screen_name"});
+  }
+  if (name == "citm_catalog") {
+    return sonic_json::JsonPointer({"events", "138586341", "name"});
+  }
+  return sonic_json::JsonPointer({"features", 0, "type"});
+}
+
+template <typename DocType>
+static const auto& lazy_root(const DocType& doc) {
+  if constexpr (std::is_same<DocType, sonic_json::LazyDocument>::value) {
+    return doc.GetRoot();
+  } else {
+    return doc;
+  }
+}
+
+template <typename DocType>
+static void BM_LazyParse(benchmark::State& state, std::string_view json) {
+  for (auto _ : state) {
+    DocType doc;
+    doc.Parse(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    benchmark::DoNotOptimize(lazy_root(doc).Size());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+template <typename DocType>
+static void BM_LazyParseAt(benchmark::State& state, std::string_view json,
+                           std::string name) {
+  sonic_json::JsonPointer path = lazy_path(name);
+  for (auto _ : state) {
+    DocType doc;
+    doc.Parse(json.data(), json.size());
+    auto node = lazy_root(doc).AtPointer(path);
+    if (doc.HasParseError() || !node) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    benchmark::DoNotOptimize(node->GetStringView());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+template <typename DocType>
+static void BM_LazyParseAtSerialize(benchmark::State& state,
+                                    std::string_view json, std::string name) {
+  sonic_json::JsonPointer path = lazy_path(name);
+  sonic_json::WriteBuffer wb;
+  for (auto _ : state) {
+    DocType doc;
+    doc.Parse(json.data(), json.size());
+    auto node = lazy_root(doc).AtPointer(path);
+    if (doc.HasParseError() || !node) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    benchmark::DoNotOptimize(node->GetStringView());
+    wb.Clear();
+    doc.Serialize(wb);
+    benchmark::DoNotOptimize(wb.ToString());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Lazy(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    if (name != "twitter" && name != "citm_catalog" && name != "canada") {
+      continue;
+    }
+    benchmark::RegisterBenchmark((name + "/Lazy_Parse_DNode").c_str(),
+                                 BM_LazyParse<sonic_json::Document>,
+                                 json.second);
+    benchmark::RegisterBenchmark((name + "/Lazy_Parse_Lazy").c_str(),
+                                 BM_LazyParse<sonic_json::LazyDocument>,
+                                 json.second);
+    benchmark::RegisterBenchmark((name + "/Lazy_ParseAt_DNode").c_str(),
+                                 BM_LazyParseAt<sonic_json::Document>,
+                                 json.second, name);
+    benchmark::RegisterBenchmark((name + "/Lazy_ParseAt_Lazy").c_str(),
+                                 BM_LazyParseAt<sonic_json::LazyDocument>,
+                                 json.second, name);
+    benchmark::RegisterBenchmark(
+        (name + "/Lazy_ParseAtSerialize_DNode").c_str(),
+        BM_LazyParseAtSerialize<sonic_json::Document>, json.second, name);
+    benchmark::RegisterBenchmark(
+        (name + "/Lazy_ParseAtSerialize_Lazy").c_str(),
+        BM_LazyParseAtSerialize<sonic_json::LazyDocument>, json.second, name);
+  }
+}
+
+#endif
@@ -22,12 +22,21 @@
 #include <sstream>
 #include <string_view>
 
+#include "arch.hpp"
 #include "cjson.hpp"
+#include "compact.hpp"
 #include "jsoncpp.hpp"
+#include "lazy.hpp"
+#include "member_map.hpp"
+#include "ndjson.hpp"
 #include "ondemand.hpp"
+#include "packed.hpp"
 #include "rapidjson.hpp"
 #include "simdjson.hpp"
+#include "small.hpp"
 #include "sonic.hpp"
+#include "tape.hpp"
+#include "validate.hpp"
 #include "yyjson.hpp"
 
 static std::string get_json(const std::string_view file) {
@@ -195,6 +204,7 @@ static void regitser_OnDemand() {
     benchmark::RegisterBenchmark(name.c_str(), BM_##JSON##OnDemand, t);      \
   }
     REG_ONDEMAND(Sonic);
+    REG_ONDEMAND(SonicCursor);
     REG_ONDEMAND(RapidjsonSax);
     REG_ONDEMAND(SIMDjson);
   }
@@ -211,6 +221,15 @@ int main(int argc, char **argv) {
           std::make_pair(entry.path(), get_json(entry.path().string())));
 
   regitser_OnDemand();
+  register_Ndjson();
+  register_Small();
+  register_MemberMap(jsons);
+  register_Packed(jsons);
+  register_Compact(jsons);
+  register_Tape(jsons);
+  register_Lazy(jsons);
+  register_Validate(jsons);
+  register_Arch(jsons);
 #define ADD_JSON_BMK(JSON, ACT)                                      \
   do {                                                               \
     benchmark::RegisterBenchmark(                                    \
@@ -232,6 +251,9 @@ int main(int argc, char **argv) {
 
   ADD_BMK(Decode);
   ADD_BMK(Encode);
+  for (const auto &json : jsons) {
+    ADD_JSON_BMK(SonicTwoStage, Decode);
+  }
   // ADD_BMK(Stat);
   // ADD_BMK(Find);
   do {
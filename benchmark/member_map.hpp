@@ -0,0 +1,254 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _MEMBER_MAP_H_
+#define _MEMBER_MAP_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compare the member index of CreateMap with the std::multimap it replaced,
+// on the objects of N members. The FindMember of the parsed objects also
+// compares the linear scan, the key tags and the member index, on synthetic
+// objects and on the objects of citm_catalog.json and twitter.json.
+
+// SimpleAllocator that counts the malloc bytes, for the bytes per member.
+struct CountingAllocator : public sonic_json::SimpleAllocator {
+  void* Malloc(size_t size) {
+    bytes += size;
+    return sonic_json::SimpleAllocator::Malloc(size);
+  }
+  size_t bytes = 0;
+};
+
+using MapNode = sonic_json::DNode<CountingAllocator>;
+using MultiMap = std::multimap<
+    sonic_json::StringView, size_t, std::less<sonic_json::StringView>,
+    sonic_json::MapAllocator<std::pair<const sonic_json::StringView, size_t>,
+                             CountingAllocator>>;
+
+static std::vector<std::string> member_keys(size_t n) {
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < n; i++) {
+    keys.push_back("field_" + std::to_string(i * 7919 % 100003));
+  }
+  return keys;
+}
+
+// The keys to look up, in random order and not sharing the key strings.
+static std::vector<std::string> query_keys(size_t n) {
+  std::vector<std::string> keys = member_keys(n);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+static void build_object(MapNode& obj, const std::vector<std::string>& keys,
+                         CountingAllocator& alloc) {
+  obj.SetObject();
+  for (size_t i = 0; i < keys.size(); i++) {
+    obj.AddMember(keys[i], MapNode(int64_t(i)), alloc);
+  }
+}
+
+static void build_multimap(MultiMap& map, const MapNode& obj) {
+  size_t i = 0;
+  for (auto m = obj.MemberBegin(); m != obj.MemberEnd(); ++m, ++i) {
+    map.emplace(m->name.GetStringView(), i);
+  }
+}
+
+static void BM_MemberMapBuildIndex(benchmark::State& state) {
+  CountingAllocator alloc;
+  MapNode obj;
+  build_object(obj, member_keys(state.range(0)), alloc);
+  size_t before = alloc.bytes;
+  obj.CreateMap(alloc);
+  size_t bytes = alloc.bytes - before;
+  obj.DestroyMap();
+  for (auto _ : state) {
+    obj.CreateMap(alloc);
+    obj.DestroyMap();
+  }
+  state.counters["bytes_per_member"] = double(bytes) / state.range(0);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MemberMapBuildMultimap(benchmark::State& state) {
+  CountingAllocator alloc;
+  MapNode obj;
+  build_object(obj, member_keys(state.range(0)), alloc);
+  size_t bytes = 0;
+  {
+    size_t before = alloc.bytes;
+    MultiMap map(&alloc);
+    build_multimap(map, obj);
+    bytes = alloc.bytes - before;
+  }
+  for (auto _ : state) {
+    MultiMap map(&alloc);
+    build_multimap(map, obj);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.counters["bytes_per_member"] = double(bytes) / state.range(0);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MemberMapFindIndex(benchmark::State& state) {
+  CountingAllocator alloc;
+  MapNode obj;
+  build_object(obj, member_keys(state.range(0)), alloc);
+  obj.CreateMap(alloc);
+  std::vector<std::string> queries = query_keys(state.range(0));
+  for (auto _ : state) {
+    for (const auto& q : queries) {
+      benchmark::DoNotOptimize(obj.FindMember(q));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_MemberMapFindMultimap(benchmark::State& state) {
+  CountingAllocator alloc;
+  MapNode obj;
+  build_object(obj, member_keys(state.range(0)), alloc);
+  MultiMap map(&alloc);
+  build_multimap(map, obj);
+  std::vector<std::string> queries = query_keys(state.range(0));
+  for (auto _ : state) {
+    for (const auto& q : queries) {
+      auto it = map.find(sonic_json::StringView(q));
+      benchmark::DoNotOptimize(obj.MemberBegin() + it->second);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Parse an object of n members, and the lookup of it is decided by the map
+// threshold of kParseCreateMap.
+template <unsigned parseFlags>
+static void BM_MemberMapFindParsed(benchmark::State& state,
+                                   size_t threshold) {
+  std::vector<std::string> keys = member_keys(state.range(0));
+  std::string json = "{";
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i) json += ",";
+    json += "\"" + keys[i] + "\":" + std::to_string(i);
+  }
+  json += "}";
+  sonic_json::Document doc;
+  doc.SetMapThreshold(threshold).Parse<parseFlags>(json);
+  if (doc.HasParseError()) state.SkipWithError("Failed to parse");
+  std::vector<std::string> queries = query_keys(state.range(0));
+  for (auto _ : state) {
+    for (const auto& q : queries) {
+      benchmark::DoNotOptimize(doc.FindMember(q));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+using FindQuery = std::pair<const sonic_json::Document::NodeType*, std::string>;
+
+// Collect each member key of the objects with at least 8 members, which are
+// the objects FindMember scans.
+static void collect_queries(const sonic_json::Document::NodeType& node,
+                            std::vector<FindQuery>& queries) {
+  if (node.IsObject()) {
+    for (auto m = node.MemberBegin(); m != node.MemberEnd(); ++m) {
+      if (node.Size() >= 8) {
+        queries.emplace_back(&node, std::string(m->name.GetStringView()));
+      }
+      collect_queries(m->value, queries);
+    }
+  } else if (node.IsArray()) {
+    for (auto it = node.Begin(); it != node.End(); ++it) {
+      collect_queries(*it, queries);
+    }
+  }
+}
+
+// FindMember of all keys in the objects of a json file.
+template <unsigned parseFlags>
+static void BM_MemberMapFindFile(benchmark::State& state,
+                                 std::string_view json, size_t threshold) {
+  sonic_json::Document doc;
+  doc.SetMapThreshold(threshold).Parse<parseFlags>(json.data(), json.size());
+  if (doc.HasParseError()) {
+    state.SkipWithError("Failed to parse");
+    return;
+  }
+  std::vector<FindQuery> queries;
+  collect_queries(doc, queries);
+  std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+  for (auto _ : state) {
+    for (const auto& q : queries) {
+      benchmark::DoNotOptimize(q.first->FindMember(q.second));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void register_MemberMap(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    if (name != "citm_catalog" && name != "twitter") continue;
+    benchmark::RegisterBenchmark((name + "/FindMember_Scan").c_str(),
+                                 BM_MemberMapFindFile<kParseDefault>,
+                                 json.second, SIZE_MAX);
+    benchmark::RegisterBenchmark((name + "/FindMember_Tags").c_str(),
+                                 BM_MemberMapFindFile<kParseCreateMap>,
+                                 json.second, SIZE_MAX - 1);
+  }
+  for (int n : {8, 16, 32, 64}) {
+    benchmark::RegisterBenchmark(
+        "member_map/Find_Scan",
+        BM_MemberMapFindParsed<kParseDefault>, SIZE_MAX)
+        ->Arg(n);
+    benchmark::RegisterBenchmark(
+        "member_map/Find_Tags",
+        BM_MemberMapFindParsed<kParseCreateMap>, SIZE_MAX - 1)
+        ->Arg(n);
+    benchmark::RegisterBenchmark(
+        "member_map/Find_Parsed_Index",
+        BM_MemberMapFindParsed<kParseCreateMap>, 0)
+        ->Arg(n);
+  }
+  for (int n : {16, 128, 1024, 16384}) {
+    benchmark::RegisterBenchmark("member_map/Build_Index",
+                                 BM_MemberMapBuildIndex)
+        ->Arg(n);
+    benchmark::RegisterBenchmark("member_map/Build_Multimap",
+                                 BM_MemberMapBuildMultimap)
+        ->Arg(n);
+    benchmark::RegisterBenchmark("member_map/Find_Index",
+                                 BM_MemberMapFindIndex)
+        ->Arg(n);
+    benchmark::RegisterBenchmark("member_map/Find_Multimap",
+                                 BM_MemberMapFindMultimap)
+        ->Arg(n);
+  }
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _NDJSON_H_
+#define _NDJSON_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// The size of generated NDJSON is 1 GiB by default, and can be changed by the
+// environment variable SONIC_BENCH_NDJSON_SIZE (in bytes).
+static size_t ndjson_size() {
+  const char* env = std::getenv("SONIC_BENCH_NDJSON_SIZE");
+  if (env) return std::strtoull(env, nullptr, 10);
+  return size_t(1) << 30;
+}
+
+// Generate log-like records, such as
+// {"ts":1650000000123,"level":"INFO","service":"svc-7","latency":0.125,...}
+static std::string gen_ndjson(size_t size) {
+  static const char* levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+  std::string json;
+  json.reserve(size + 512);
+  for (uint64_t i = 0; json.size() < size; i++) {
+    json += "{\"ts\":" + std::to_string(1650000000000ull + i * 7) +
+            ",\"level\":\"" + levels[i % 4] + "\",\"service\":\"svc-" +
+            std::to_string(i % 13) +
+            "\",\"latency\":" + std::to_string((i % 1000) / 8.0) +
+            ",\"ok\":" + (i % 5 ? "true" : "false") +
+            ",\"tags\":[\"a\",\"b\\\"c\",\"\\u4e2d\"],\"msg\":\"request " +
+            std::to_string(i) + " finished\",\"user\":{\"id\":" +
+            std::to_string(i * 31 % 100003) + ",\"name\":null}}\n";
+  }
+  return json;
+}
+
+// Generated lazily, only when the ndjson benchmarks are run.
+static std::string_view ndjson_data() {
+  static const std::string json = gen_ndjson(ndjson_size());
+  return json;
+}
+
+static void BM_SonicNdjsonDocPerRecord(benchmark::State& state) {
+  std::string_view json = ndjson_data();
+  size_t records = 0;
+  for (auto _ : state) {
+    size_t start = 0;
+    while (start < json.size()) {
+      size_t end = json.find('\n', start);
+      if (end == std::string_view::npos) end = json.size();
+      sonic_json::Document doc;
+      doc.Parse(json.data() + start, end - start);
+      if (doc.HasParseError()) {
+        state.SkipWithError("Failed to parse record");
+        return;
+      }
+      records++;
+      start = end + 1;
+    }
+  }
+  state.counters["records"] =
+      benchmark::Counter(records, benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void BM_SonicNdjsonDocumentStream(benchmark::State& state) {
+  std::string_view json = ndjson_data();
+  size_t records = 0;
+  for (auto _ : state) {
+    sonic_json::DocumentStream stream(
+        sonic_json::StringView(json.data(), json.size()));
+    while (stream.Next()) {
+      if (stream.Doc().HasParseError()) {
+        state.SkipWithError("Failed to parse record");
+        return;
+      }
+      records++;
+    }
+  }
+  state.counters["records"] =
+      benchmark::Counter(records, benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+// The scaling curve of parallel parsing, the thread count is state.range(0).
+static void BM_SonicNdjsonParallel(benchmark::State& state, bool ordered) {
+  std::string_view json = ndjson_data();
+  sonic_json::ParallelOptions opts;
+  opts.threads = state.range(0);
+  opts.ordered = ordered;
+  sonic_json::ParallelDocumentStream ps(opts);
+  std::atomic<size_t> records{0};
+  std::atomic<bool> failed{false};
+  for (auto _ : state) {
+    ps.Parse(sonic_json::StringView(json.data(), json.size()),
+             [&](size_t, sonic_json::Document& doc) {
+               if (doc.HasParseError()) failed = true;
+               records.fetch_add(1, std::memory_order_relaxed);
+             });
+  }
+  if (failed) {
+    state.SkipWithError("Failed to parse record");
+    return;
+  }
+  state.counters["records"] =
+      benchmark::Counter(records.load(), benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Ndjson() {
+  benchmark::RegisterBenchmark("ndjson/Decode_SonicDocPerRecord",
+                               BM_SonicNdjsonDocPerRecord)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("ndjson/Decode_SonicDocumentStream",
+                               BM_SonicNdjsonDocumentStream)
+      ->Unit(benchmark::kMillisecond);
+
+  size_t cores = std::thread::hardware_concurrency();
+  for (bool ordered : {false, true}) {
+    auto bm = benchmark::RegisterBenchmark(
+        ordered ? "ndjson/Decode_SonicParallelOrdered"
+                : "ndjson/Decode_SonicParallel",
+        BM_SonicNdjsonParallel, ordered);
+    for (size_t t = 1; t < cores; t *= 2) bm->Arg(t);
+    bm->Arg(cores ? cores : 1)->UseRealTime()->Unit(benchmark::kMillisecond);
+  }
+}
+
+#endif
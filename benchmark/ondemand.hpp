@@ -59,6 +59,36 @@ static void BM_SonicOnDemand(benchmark::State& state, const OnDemand& data) {
                           int64_t(data.json.size()));
 }
 
+static inline bool SonicCursorOnDemand(
+    const std::string& json, const std::vector<std::string_view>& path,
+    uint64_t& val) {
+  sonic_json::JsonCursor cur(json);
+  for (const auto key : path) {
+    sonic_json::JsonCursor next;
+    if (cur.FindField(key, next) != sonic_json::kErrorNone) return false;
+    cur = next;
+  }
+  return cur.GetUint64(val) == sonic_json::kErrorNone;
+}
+
+static void BM_SonicCursorOnDemand(benchmark::State& state,
+                                   const OnDemand& data) {
+  uint64_t get = 0;
+  bool existed = SonicCursorOnDemand(data.json, data.path, get);
+  bool ok = existed == data.existed && get == data.value;
+  if (!ok) {
+    state.SkipWithError("Verify failed");
+    return;
+  }
+
+  for (auto _ : state) {
+    SonicCursorOnDemand(data.json, data.path, get);
+  }
+  state.SetLabel(data.name);
+  state.SetBytesProcessed(int64_t(state.iterations()) *
+                          int64_t(data.json.size()));
+}
+
 static inline bool SIMDjsonOnDemand(simdjson::ondemand::parser& parser,
                                     simdjson::padded_string& json_pad,
                                     const std::vector<std::string_view>& path,
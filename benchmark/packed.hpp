@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PACKED_H_
+#define _PACKED_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "member_map.hpp"
+
+// Compare the packed arrays of kParsePackNumbers with the arrays of nodes, on
+// the number-dense canada.json: the parsing with the allocated bytes, and the
+// sum of all numbers.
+
+using CountingDocument =
+    sonic_json::GenericDocument<sonic_json::DNode<CountingAllocator>>;
+
+template <typename NodeType>
+static double sum_numbers(const NodeType& node) {
+  double sum = 0;
+  switch (node.GetType()) {
+    case sonic_json::kReal:
+      return node.GetDouble();
+    case sonic_json::kSint:
+      return double(node.GetInt64());
+    case sonic_json::kUint:
+      return double(node.GetUint64());
+    case sonic_json::kPackedReal: {
+      const double* vals = node.GetPackedDoubles();
+      for (size_t i = 0; i < node.Size(); i++) sum += vals[i];
+      break;
+    }
+    case sonic_json::kPackedInt: {
+      const int64_t* vals = node.GetPackedInt64s();
+      for (size_t i = 0; i < node.Size(); i++) sum += double(vals[i]);
+      break;
+    }
+    case sonic_json::kArray:
+      for (auto it = node.Begin(); it != node.End(); ++it) {
+        sum += sum_numbers(*it);
+      }
+      break;
+    case sonic_json::kObject:
+      for (auto m = node.MemberBegin(); m != node.MemberEnd(); ++m) {
+        sum += sum_numbers(m->value);
+      }
+      break;
+    default:
+      break;
+  }
+  return sum;
+}
+
+template <unsigned parseFlags>
+static void BM_PackedParse(benchmark::State& state, std::string_view json) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    CountingDocument doc;
+    doc.Parse<parseFlags>(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    bytes = doc.GetAllocator().bytes;
+  }
+  state.counters["bytes"] = bytes;
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+template <unsigned parseFlags>
+static void BM_PackedSum(benchmark::State& state, std::string_view json) {
+  sonic_json::Document doc;
+  doc.Parse<parseFlags>(json.data(), json.size());
+  if (doc.HasParseError()) {
+    state.SkipWithError("Failed to parse");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sum_numbers(doc));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Packed(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    if (name != "canada") continue;
+    benchmark::RegisterBenchmark((name + "/PackNumbers_Parse_Nodes").c_str(),
+                                 BM_PackedParse<kParseDefault>, json.second);
+    benchmark::RegisterBenchmark((name + "/PackNumbers_Parse_Packed").c_str(),
+                                 BM_PackedParse<kParsePackNumbers>,
+                                 json.second);
+    benchmark::RegisterBenchmark((name + "/PackNumbers_Sum_Nodes").c_str(),
+                                 BM_PackedSum<kParseDefault>, json.second);
+    benchmark::RegisterBenchmark((name + "/PackNumbers_Sum_Packed").c_str(),
+                                 BM_PackedSum<kParsePackNumbers>, json.second);
+  }
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SMALL_H_
+#define _SMALL_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <string>
+
+// A message of about 200 bytes, to measure the per-call overhead of parsing.
+static const std::string& small_message() {
+  static const std::string json =
+      R"({"id":1234567,"method":"order.create","ts":1650000000123,)"
+      R"("user":{"uid":98765,"name":"alice","vip":true},)"
+      R"("items":[{"sku":"A-1","qty":2,"price":9.99},)"
+      R"({"sku":"B-22","qty":1,"price":120.5}],"note":null})";
+  return json;
+}
+
+static void BM_SonicSmallParse(benchmark::State& state) {
+  const std::string& json = small_message();
+  sonic_json::Document doc;
+  for (auto _ : state) {
+    doc.Parse(json);
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void BM_SonicSmallParseContext(benchmark::State& state) {
+  const std::string& json = small_message();
+  sonic_json::ParserContext ctx;
+  sonic_json::Document doc;
+  for (auto _ : state) {
+    doc.Parse(json, ctx);
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Small() {
+  benchmark::RegisterBenchmark("small/Decode_Sonic", BM_SonicSmallParse);
+  benchmark::RegisterBenchmark("small/Decode_SonicContext",
+                               BM_SonicSmallParseContext);
+}
+
+#endif
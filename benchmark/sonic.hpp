@@ -116,9 +116,17 @@ class SonicParseResult : public ParseResult<SonicParseResult<NodeType>,
         stat.arrays++;
         stat.elements += v.Size();
         break;
+      case sonic_json::kPackedReal:
+      case sonic_json::kPackedInt:
+        if (depth > stat.depth) stat.depth = depth;
+        stat.arrays++;
+        stat.elements += v.Size();
+        stat.numbers += v.Size();
+        break;
       case sonic_json::kStringCopy:
       case sonic_json::kStringFree:
       case sonic_json::kStringConst:
+      case sonic_json::kStringInline:
         stat.strings++;
         stat.length += v.Size();
         break;
@@ -133,14 +141,15 @@ class SonicParseResult : public ParseResult<SonicParseResult<NodeType>,
   }
 };
 
-template <typename NodeType>
-class Sonic : public JsonBase<Sonic<NodeType>, SonicParseResult<NodeType>> {
+template <typename NodeType, unsigned parseFlags = kParseDefault>
+class Sonic : public JsonBase<Sonic<NodeType, parseFlags>,
+                              SonicParseResult<NodeType>> {
  public:
   using node_type = NodeType;
   bool parse_impl(std::string_view json, SonicParseResult<NodeType> &pr) const {
     // sonic_json::Parser<NodeType> parser;
     // auto ret = parser.Parse(json.data(), json.size(), pr.doc);
-    pr.doc.Parse(json.data(), json.size());
+    pr.doc.template Parse<parseFlags>(json.data(), json.size());
     if (pr.doc.HasParseError()) {
       return false;
     }
@@ -152,4 +161,9 @@ using SonicDynParseResult = SonicParseResult<sonic_json::DNode<>>;
 using SonicDynStringResult = SonicStringResult<sonic_json::DNode<>>;
 using SonicDyn = Sonic<sonic_json::DNode<>>;
 
+// SonicTwoStage parses with the structural index built at first.
+using SonicTwoStageParseResult = SonicDynParseResult;
+using SonicTwoStageStringResult = SonicDynStringResult;
+using SonicTwoStage = Sonic<sonic_json::DNode<>, kParseTwoStage>;
+
 #endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TAPE_H_
+#define _TAPE_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "compact.hpp"
+
+// Compare the tape of TapeDocument with the tree of DNodes: the parsing with
+// the bytes of the DOM, and the traversal of all values.
+
+static void BM_TapeParse(benchmark::State& state, std::string_view json) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    sonic_json::TapeDocument doc;
+    doc.Parse(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+    bytes = doc.GetMemoryUsage();
+  }
+  state.counters["bytes"] = bytes;
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void BM_TapeTraverse(benchmark::State& state, std::string_view json) {
+  sonic_json::TapeDocument doc;
+  doc.Parse(json.data(), json.size());
+  if (doc.HasParseError()) {
+    state.SkipWithError("Failed to parse");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(visit_all(doc.GetRoot()));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Tape(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    if (name != "twitter" && name != "citm_catalog" && name != "canada") {
+      continue;
+    }
+    benchmark::RegisterBenchmark((name + "/Tape_Parse_DNode").c_str(),
+                                 BM_CompactParse_DNode, json.second);
+    benchmark::RegisterBenchmark((name + "/Tape_Parse_Tape").c_str(),
+                                 BM_TapeParse, json.second);
+    benchmark::RegisterBenchmark((name + "/Tape_Traverse_DNode").c_str(),
+                                 BM_CompactTraverse<sonic_json::Document>,
+                                 json.second);
+    benchmark::RegisterBenchmark((name + "/Tape_Traverse_Tape").c_str(),
+                                 BM_TapeTraverse, json.second);
+    benchmark::RegisterBenchmark((name + "/Tape_Serialize_DNode").c_str(),
+                                 BM_CompactSerialize<sonic_json::Document>,
+                                 json.second);
+    benchmark::RegisterBenchmark(
+        (name + "/Tape_Serialize_Tape").c_str(),
+        BM_CompactSerialize<sonic_json::TapeDocument>, json.second);
+  }
+}
+
+#endif
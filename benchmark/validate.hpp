@@ -0,0 +1,69 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _VALIDATE_H_
+#define _VALIDATE_H_
+
+#include <benchmark/benchmark.h>
+#include <sonic/sonic.h>
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+static void BM_SonicValidate(benchmark::State& state, std::string_view json) {
+  for (auto _ : state) {
+    if (sonic_json::Validate(json).Error()) {
+      state.SkipWithError("Failed to validate");
+      return;
+    }
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+// Validate by parsing into a document and discarding it. With
+// kParseValidateUtf8, it shows the cost of the utf-8 validation in parsing.
+template <unsigned parseFlags>
+static void BM_SonicParseDiscard(benchmark::State& state,
+                                 std::string_view json) {
+  for (auto _ : state) {
+    sonic_json::Document doc;
+    doc.Parse<parseFlags>(json.data(), json.size());
+    if (doc.HasParseError()) {
+      state.SkipWithError("Failed to parse");
+      return;
+    }
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(json.size()));
+}
+
+static void register_Validate(
+    const std::vector<std::pair<std::filesystem::path, std::string>>& jsons) {
+  for (const auto& json : jsons) {
+    std::string name = json.first.stem().string();
+    benchmark::RegisterBenchmark((name + "/Validate_Sonic").c_str(),
+                                 BM_SonicValidate, json.second);
+    benchmark::RegisterBenchmark((name + "/ParseDiscard_Sonic").c_str(),
+                                 BM_SonicParseDiscard<kParseDefault>,
+                                 json.second);
+    benchmark::RegisterBenchmark((name + "/ParseDiscardUtf8_Sonic").c_str(),
+                                 BM_SonicParseDiscard<kParseValidateUtf8>,
+                                 json.second);
+  }
+}
+
+#endif
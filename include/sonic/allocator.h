@@ -332,6 +332,52 @@ class MemoryPoolAllocator {
     shared_->chunkHead->size = 0;
   }
 
+  //! Deallocates all memory blocks, but keeps the current chunk for reuse.
+  /*! The other chunks are deallocated, excluding the first/user one. It
+     avoids allocating a chunk again when parsing many small documents.
+  */
+  void Rewind() noexcept {
+    sonic_assert(shared_->refcount > 0);
+    ChunkHeader* head = shared_->chunkHead;
+    ChunkHeader* c = head->next;
+    if (c) {
+      while (c->next) {
+        ChunkHeader* next = c->next;
+        baseAllocator_->Free(c);
+        c = next;
+      }
+      head->next = c;
+      c->size = 0;
+    }
+    head->size = 0;
+  }
+
+  //! Takes over the memory chunks of rhs, excluding the first/user one.
+  /*! The memory blocks allocated by rhs are released with this allocator
+     then. It is used to merge the memory of the nodes parsed by different
+     threads. The chunks must be allocated by the same kind of BaseAllocator.
+  */
+  void Absorb(MemoryPoolAllocator& rhs) noexcept {
+    sonic_assert(shared_->refcount > 0);
+    sonic_assert(rhs.shared_->refcount > 0);
+    if (shared_ == rhs.shared_) return;
+    ChunkHeader* first = rhs.shared_->chunkHead;
+    if (!first->next) return;
+    ChunkHeader* last = first;
+    while (last->next->next) last = last->next;
+    rhs.shared_->chunkHead = last->next;
+    ChunkHeader* head = shared_->chunkHead;
+    if (!head->next) {
+      // the head is the first/user chunk, which must be the last one
+      last->next = head;
+      shared_->chunkHead = first;
+    } else {
+      // keep the current chunk as the head, which serves the allocation
+      last->next = head->next;
+      head->next = first;
+    }
+  }
+
   //! Computes the total capacity of allocated memory chunks.
   /*! \return total capacity in bytes.
    */
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+
+#include "sonic/dom/compactnode.h"
+#include "sonic/dom/flags.h"
+#include "sonic/dom/parser.h"
+#include "sonic/dom/readonly_document.h"
+#include "sonic/error.h"
+#include "sonic/internal/utils.h"
+
+namespace sonic_json {
+
+/**
+ * @brief A read-only document of the 8-byte CompactNodes.
+ *
+ * All nodes, strings and the numbers that do not fit in the nodes are in one
+ * arena, and the json is not kept after parsing. It is for the messages of
+ * less than 32 GB of nodes, with less than 2^24 children in each container,
+ * and the parsing of the others fails with kErrorCompactLimit.
+ */
+class CompactDocument : public ReadOnlyDocument<CompactDocument, CompactNode> {
+ public:
+  CompactDocument() noexcept = default;
+  CompactDocument(const CompactDocument&) = delete;
+  CompactDocument& operator=(const CompactDocument&) = delete;
+
+  CompactDocument(CompactDocument&& rhs) noexcept
+      : ReadOnlyDocument(rhs), arena_(rhs.arena_), size_(rhs.size_) {
+    rhs.arena_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  CompactDocument& operator=(CompactDocument&& rhs) noexcept {
+    if (this != &rhs) {
+      std::free(arena_);
+      arena_ = rhs.arena_;
+      size_ = rhs.size_;
+      parse_result_ = rhs.parse_result_;
+      rhs.arena_ = nullptr;
+      rhs.size_ = 0;
+    }
+    return *this;
+  }
+
+  ~CompactDocument() { std::free(arena_); }
+
+  /**
+   * @brief Parse a json into the compact nodes.
+   * @param parseFlags combination of kParseTwoStage and kParseValidateUtf8,
+   * and the other flags are ignored, as the nodes are not mutable and the
+   * strings are always copied into the arena.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  CompactDocument& Parse(StringView json) {
+    return Parse<parseFlags>(json.data(), json.size());
+  }
+
+  template <unsigned parseFlags = kParseDefault>
+  CompactDocument& Parse(const char* data, size_t len) {
+    std::free(arena_);
+    arena_ = nullptr;
+    size_ = 0;
+    // the parser unescapes the strings in place, and needs the padding
+    std::unique_ptr<char, decltype(&std::free)> buf(
+        internal::MallocPaddedJson(data, len), &std::free);
+    CompactSAXHandler sax;
+    if (!buf || !sax.SetUp(StringView(data, len))) {
+      parse_result_ = kErrorNoMem;
+      return *this;
+    }
+    Parser p;
+    parse_result_ = p.template Parse<parseFlags>(buf.get(), len, sax);
+    if (sonic_unlikely(sax.err_ != kErrorNone)) {
+      parse_result_ = ParseResult(sax.err_, parse_result_.Offset());
+    }
+    if (HasParseError() || !sax.finish()) {
+      if (!HasParseError()) parse_result_ = sax.err_;
+      return *this;
+    }
+    arena_ = sax.arena_;
+    size_ = sax.size_;
+    sax.arena_ = nullptr;
+    return *this;
+  }
+
+  /**
+   * @brief Get the bytes of the arena, which are all memory of the nodes.
+   */
+  sonic_force_inline size_t GetMemoryUsage() const noexcept {
+    return size_ * sizeof(CompactNode);
+  }
+
+ private:
+  friend class ReadOnlyDocument<CompactDocument, CompactNode>;
+
+  // the root is the last node in the arena
+  const CompactNode* rootImpl() const noexcept {
+    return arena_ ? arena_ + size_ - 1 : nullptr;
+  }
+
+  CompactNode* arena_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace sonic_json
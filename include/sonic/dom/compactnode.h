@@ -0,0 +1,546 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "sonic/dom/genericnode.h"
+#include "sonic/dom/json_pointer.h"
+#include "sonic/dom/serialize.h"
+#include "sonic/dom/type.h"
+#include "sonic/error.h"
+#include "sonic/string_view.h"
+#include "sonic/writebuffer.h"
+
+namespace sonic_json {
+
+class CompactSAXHandler;
+class CompactDocument;
+
+/**
+ * @brief A read-only JSON value of 8 bytes, the node of CompactDocument.
+ *
+ * The node is the type byte, a 24-bit length and a 32-bit payload. The payload
+ * is the value of the numbers that fit in 32 bits and of the strings of at
+ * most 4 bytes, or else the distance in 8-byte words back to the data in the
+ * arena of the document: the children of a container, the number, or the
+ * string bytes. The data is always before the node, as the children are
+ * written into the arena before their parents.
+ */
+class CompactNode {
+ public:
+  using MemberNode = MemberNodeT<CompactNode>;
+  using ConstMemberIterator = const MemberNode*;
+  using ConstValueIterator = const CompactNode*;
+
+  // The number is in the arena, and the payload is the distance to it.
+  static constexpr uint8_t kBoxed = 1 << 5;
+  // The max of the 24-bit length. The containers have at most kMaxLength
+  // children, and the strings that are not shorter keep the length in the
+  // arena before the bytes.
+  static constexpr uint32_t kMaxLength = (1 << 24) - 1;
+  static constexpr size_t kInlineMax = 4;
+
+  CompactNode() noexcept = default;
+  CompactNode(const CompactNode&) = delete;
+  CompactNode& operator=(const CompactNode&) = delete;
+
+  // Check APIs
+  sonic_force_inline TypeFlag GetType() const noexcept {
+    return static_cast<TypeFlag>(raw_ & kSubTypeMask);
+  }
+  sonic_force_inline bool IsNull() const noexcept {
+    return getBasicType() == kNull;
+  }
+  sonic_force_inline bool IsBool() const noexcept {
+    return getBasicType() == kBool;
+  }
+  sonic_force_inline bool IsString() const noexcept {
+    return getBasicType() == kString;
+  }
+  sonic_force_inline bool IsNumber() const noexcept {
+    return getBasicType() == kNumber;
+  }
+  sonic_force_inline bool IsArray() const noexcept {
+    return getBasicType() == kArray;
+  }
+  sonic_force_inline bool IsObject() const noexcept {
+    return getBasicType() == kObject;
+  }
+  sonic_force_inline bool IsRaw() const noexcept { return false; }
+  sonic_force_inline bool IsPackedArray() const noexcept { return false; }
+  sonic_force_inline bool IsContainer() const noexcept {
+    return (raw_ & kContainerMask) == static_cast<uint8_t>(kContainerMask);
+  }
+  sonic_force_inline bool IsTrue() const noexcept { return GetType() == kTrue; }
+  sonic_force_inline bool IsFalse() const noexcept {
+    return GetType() == kFalse;
+  }
+  sonic_force_inline bool IsDouble() const noexcept {
+    return GetType() == kReal;
+  }
+  sonic_force_inline bool IsUint64() const noexcept {
+    return GetType() == kUint;
+  }
+  sonic_force_inline bool IsInt64() const noexcept {
+    return GetType() == kSint ||
+           (GetType() == kUint &&
+            GetUint64() <=
+                static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+  }
+
+  // Get APIs
+  sonic_force_inline bool GetBool() const noexcept {
+    sonic_assert(IsBool());
+    return GetType() == kTrue;
+  }
+  sonic_force_inline int64_t GetInt64() const noexcept {
+    sonic_assert(IsInt64());
+    if (isBoxed()) return static_cast<int64_t>(ref()->raw_);
+    if (GetType() == kSint) return static_cast<int32_t>(payload());
+    return payload();
+  }
+  sonic_force_inline uint64_t GetUint64() const noexcept {
+    sonic_assert(IsUint64());
+    return isBoxed() ? ref()->raw_ : payload();
+  }
+  sonic_force_inline double GetDouble() const noexcept {
+    sonic_assert(IsNumber());
+    if (GetType() == kUint) return static_cast<double>(GetUint64());
+    if (GetType() == kSint) return static_cast<double>(GetInt64());
+    if (isBoxed()) {
+      double d;
+      std::memcpy(&d, &ref()->raw_, sizeof(d));
+      return d;
+    }
+    float f;
+    uint32_t bits = payload();
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+  sonic_force_inline StringView GetStringView() const noexcept {
+    sonic_assert(IsString());
+    return StringView(stringData(), Size());
+  }
+  sonic_force_inline std::string GetString() const {
+    sonic_assert(IsString());
+    return std::string(stringData(), Size());
+  }
+
+  /**
+   * @brief Get the length of a string, or the children count of a container.
+   */
+  sonic_force_inline size_t Size() const noexcept {
+    sonic_assert(IsContainer() || IsString());
+    size_t len = length();
+    if (sonic_unlikely(len == kMaxLength && GetType() == kStringCopy)) {
+      return static_cast<size_t>(ref()->raw_);
+    }
+    return len;
+  }
+  sonic_force_inline bool Empty() const noexcept { return length() == 0; }
+
+  // Array APIs
+  sonic_force_inline ConstValueIterator Begin() const noexcept {
+    sonic_assert(IsArray());
+    return getArrChildrenFirstUnsafe();
+  }
+  sonic_force_inline ConstValueIterator End() const noexcept {
+    sonic_assert(IsArray());
+    return getArrChildrenFirstUnsafe() + length();
+  }
+  sonic_force_inline const CompactNode& operator[](size_t idx) const noexcept {
+    sonic_assert(IsArray() && idx < Size());
+    return getArrChildrenFirstUnsafe()[idx];
+  }
+
+  // Object APIs
+  sonic_force_inline ConstMemberIterator MemberBegin() const noexcept {
+    sonic_assert(IsObject());
+    return reinterpret_cast<const MemberNode*>(getObjChildrenFirstUnsafe());
+  }
+  sonic_force_inline ConstMemberIterator MemberEnd() const noexcept {
+    sonic_assert(IsObject());
+    return MemberBegin() + length();
+  }
+
+  /**
+   * @brief Find a specific member in an object.
+   * @param key string view of the string key
+   * @retval MemberEnd() not found
+   * @retval others iterator for found member
+   */
+  ConstMemberIterator FindMember(StringView key) const noexcept {
+    auto it = MemberBegin();
+    for (auto e = MemberEnd(); it != e; ++it) {
+      const CompactNode& name = it->name;
+      // the short keys are compared as the payload, without loading the arena
+      if (name.length() != key.size() && name.length() != kMaxLength) continue;
+      if (name.GetType() == kStringInline) {
+        if (name.payload() == inlineBits(key.data(), key.size())) break;
+      } else if (name.GetStringView() == key) {
+        break;
+      }
+    }
+    return it;
+  }
+
+  sonic_force_inline bool HasMember(StringView key) const noexcept {
+    return FindMember(key) != MemberEnd();
+  }
+
+  /**
+   * @brief Get a specific child node in the object by key.
+   * @retval null-node Expected node doesn't exist.
+   */
+  sonic_force_inline const CompactNode& operator[](
+      StringView key) const noexcept {
+    auto m = FindMember(key);
+    if (m != MemberEnd()) return m->value;
+    static const CompactNode kNullNode;
+    return kNullNode;
+  }
+
+  /**
+   * @brief get specific node by json pointer(RFC 6901)
+   * @retval nullptr get node failed
+   */
+  template <typename StringType>
+  const CompactNode* AtPointer(
+      const GenericJsonPointer<StringType>& pointer) const {
+    const CompactNode* re = this;
+    for (auto& node : pointer) {
+      if (node.IsStr()) {
+        if (!re->IsObject()) return nullptr;
+        auto m = re->FindMember(node.GetStr());
+        if (m == re->MemberEnd()) return nullptr;
+        re = &(m->value);
+      } else {
+        int idx = node.GetNum();
+        if (!re->IsArray() || idx < 0 || idx >= static_cast<int>(re->Size())) {
+          return nullptr;
+        }
+        re = &(*re)[static_cast<size_t>(idx)];
+      }
+    }
+    return re;
+  }
+
+  // Serialize APIs
+  template <unsigned serializeFlags = kSerializeDefault>
+  SonicError Serialize(WriteBuffer& wb) const {
+    return internal::SerializeImpl<serializeFlags>(this, wb);
+  }
+
+  template <unsigned serializeFlags = kSerializeDefault>
+  std::string Dump() const {
+    WriteBuffer wb;
+    SonicError err = Serialize<serializeFlags>(wb);
+    return err == kErrorNone ? wb.ToString() : "";
+  }
+
+ private:
+  friend class CompactSAXHandler;
+  friend class CompactDocument;
+  template <unsigned serializeFlags, typename NodeType>
+  friend SonicError internal::SerializeImpl(const NodeType*, WriteBuffer&);
+
+  explicit CompactNode(uint64_t raw) noexcept : raw_(raw) {}
+
+  sonic_force_inline TypeFlag getBasicType() const noexcept {
+    return static_cast<TypeFlag>(raw_ & kBasicTypeMask);
+  }
+  sonic_force_inline size_t length() const noexcept {
+    return static_cast<size_t>((raw_ >> kTotalTypeBits) & kMaxLength);
+  }
+  sonic_force_inline uint32_t payload() const noexcept {
+    return static_cast<uint32_t>(raw_ >> 32);
+  }
+  sonic_force_inline bool isBoxed() const noexcept { return raw_ & kBoxed; }
+  sonic_force_inline const CompactNode* ref() const noexcept {
+    return this - payload();
+  }
+  sonic_force_inline const char* stringData() const noexcept {
+    if (GetType() == kStringInline) {
+      return reinterpret_cast<const char*>(&raw_) + 4;
+    }
+    return reinterpret_cast<const char*>(ref() + (length() == kMaxLength));
+  }
+  sonic_force_inline const CompactNode* getArrChildrenFirstUnsafe()
+      const noexcept {
+    return ref();
+  }
+  sonic_force_inline const CompactNode* getObjChildrenFirstUnsafe()
+      const noexcept {
+    return ref();
+  }
+  // The siblings are adjacent in the arena.
+  sonic_force_inline const CompactNode* next() const noexcept {
+    return this + 1;
+  }
+
+  // SerializeImpl writes kRaw nodes, which are never parsed here.
+  StringView GetRaw() const noexcept { return StringView(); }
+
+  // The payload of the inline string of at most kInlineMax bytes.
+  static sonic_force_inline uint32_t inlineBits(const char* s,
+                                                size_t len) noexcept {
+    uint32_t bits = 0;
+    std::memcpy(&bits, s, len);
+    return bits;
+  }
+
+  // Whether the payload is the distance to the data in arena.
+  static sonic_force_inline bool hasRef(uint64_t raw) noexcept {
+    uint8_t t = raw & kSubTypeMask;
+    if ((t & kBasicTypeMask) == kNumber) return raw & kBoxed;
+    if (t == kStringCopy) return true;
+    return (t & kContainerMask) == kContainerMask &&
+           ((raw >> kTotalTypeBits) & kMaxLength) != 0;
+  }
+
+  uint64_t raw_ = 0;
+};
+
+static_assert(sizeof(CompactNode) == 8, "CompactNode must be 8 bytes");
+
+/**
+ * @brief The SAX handler that writes the CompactNodes into an arena.
+ *
+ * The values are pushed on a node stack, where the payload of a node is the
+ * arena index of its data. At the end of a container, its children are moved
+ * from the stack to the arena, with the indexes turned into the distances.
+ * EndObject and EndArray can not fail the parsing, so the errors are kept in
+ * err_ and checked by CompactDocument.
+ */
+class CompactSAXHandler {
+ public:
+  CompactSAXHandler() noexcept = default;
+  CompactSAXHandler(const CompactSAXHandler&) = delete;
+  ~CompactSAXHandler() {
+    std::free(st_);
+    std::free(arena_);
+  }
+
+  sonic_force_inline bool SetUp(StringView json) {
+    size_t len = json.size();
+    size_t cap = len / 2 + 2;
+    if (cap < 16) cap = 16;
+    st_ = static_cast<uint64_t*>(std::malloc(sizeof(uint64_t) * cap));
+    if (!st_) return false;
+    scap_ = cap;
+    // about the bytes of json, which is grown for the dense jsons
+    cap = len / 8 + 16;
+    arena_ = static_cast<CompactNode*>(std::malloc(sizeof(CompactNode) * cap));
+    if (!arena_) return false;
+    cap_ = cap;
+    return true;
+  }
+
+  sonic_force_inline bool Null() noexcept { return push(kNull); }
+  sonic_force_inline bool Bool(bool val) noexcept {
+    return push(val ? kTrue : kFalse);
+  }
+  sonic_force_inline bool Uint(uint64_t val) noexcept {
+    if (val <= UINT32_MAX) return push(kUint | (val << 32));
+    return pushBoxed(kUint, val);
+  }
+  sonic_force_inline bool Int(int64_t val) noexcept {
+    if (val >= 0) return Uint(static_cast<uint64_t>(val));
+    if (val >= INT32_MIN) {
+      return push(kSint | (uint64_t(uint32_t(int32_t(val))) << 32));
+    }
+    return pushBoxed(kSint, static_cast<uint64_t>(val));
+  }
+  sonic_force_inline bool Double(double val) noexcept {
+    // the doubles that are exact floats are inline
+    if (std::fabs(val) <= FLT_MAX) {
+      float f = static_cast<float>(val);
+      if (static_cast<double>(f) == val) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return push(kReal | (uint64_t(bits) << 32));
+      }
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    return pushBoxed(kReal, bits);
+  }
+
+  sonic_force_inline bool Key(StringView s) { return String(s); }
+
+  sonic_force_inline bool String(StringView s) {
+    size_t len = s.size();
+    if (len <= CompactNode::kInlineMax) {
+      return push(kStringInline | (uint64_t(len) << kTotalTypeBits) |
+                  (uint64_t(CompactNode::inlineBits(s.data(), len)) << 32));
+    }
+    bool long_str = len >= CompactNode::kMaxLength;
+    size_t words = (len + 7) / 8 + long_str;
+    size_t idx;
+    if (!alloc(words, idx)) return false;
+    // zero the last word, so that the padding bytes are deterministic
+    arena_[idx + words - 1].raw_ = 0;
+    if (long_str) {
+      arena_[idx].raw_ = len;
+      len = CompactNode::kMaxLength;
+    }
+    std::memcpy((void*)(arena_ + idx + long_str), s.data(), s.size());
+    return push(kStringCopy | (uint64_t(len) << kTotalTypeBits) |
+                (uint64_t(idx) << 32));
+  }
+
+  sonic_force_inline bool StartObject() noexcept { return startContainer(); }
+  sonic_force_inline bool StartArray() noexcept { return startContainer(); }
+
+  sonic_force_inline bool EndObject(uint32_t pairs) {
+    return endContainer(kObject, pairs, size_t(pairs) * 2);
+  }
+  sonic_force_inline bool EndArray(uint32_t count) {
+    return endContainer(kArray, count, count);
+  }
+
+ private:
+  friend class CompactDocument;
+
+  sonic_force_inline bool push(uint64_t raw) noexcept {
+    if (sonic_unlikely(np_ == scap_) && !grow()) return false;
+    st_[np_++] = raw;
+    return true;
+  }
+
+  sonic_force_inline bool pushBoxed(TypeFlag type, uint64_t bits) noexcept {
+    size_t idx;
+    if (!alloc(1, idx)) return false;
+    arena_[idx].raw_ = bits;
+    return push(type | CompactNode::kBoxed | (uint64_t(idx) << 32));
+  }
+
+  // The open container is null until its end, and keeps the parent index.
+  sonic_force_inline bool startContainer() noexcept {
+    if (!push(kNull | (uint64_t(parent_) << 32))) return false;
+    parent_ = np_ - 1;
+    return true;
+  }
+
+  sonic_force_inline bool endContainer(TypeFlag type, size_t count,
+                                       size_t nodes) {
+    size_t old = static_cast<size_t>(st_[parent_] >> 32);
+    uint64_t raw = type;
+    size_t idx;
+    if (sonic_unlikely(count > CompactNode::kMaxLength)) {
+      err_ = kErrorCompactLimit;
+    } else if (count && alloc(nodes, idx)) {
+      move(&st_[parent_ + 1], nodes, idx);
+      raw |= (uint64_t(count) << kTotalTypeBits) | (uint64_t(idx) << 32);
+    }
+    st_[parent_] = raw;
+    np_ = parent_ + 1;
+    parent_ = old;
+    return err_ == kErrorNone;
+  }
+
+  // Move the nodes into the arena at idx, and turn the indexes of their data
+  // into the distances.
+  sonic_force_inline void move(const uint64_t* nodes, size_t n,
+                               size_t idx) noexcept {
+    for (size_t i = 0; i < n; i++) {
+      uint64_t raw = nodes[i];
+      if (CompactNode::hasRef(raw)) {
+        uint64_t dist = idx + i - (raw >> 32);
+        raw = (raw & UINT32_MAX) | (dist << 32);
+      }
+      arena_[idx + i].raw_ = raw;
+    }
+  }
+
+  // Allocate the words in the arena, which is at most 2^32 words, as the
+  // distances are 32 bits.
+  sonic_force_inline bool alloc(size_t words, size_t& idx) noexcept {
+    if (sonic_unlikely(size_ + words > cap_) && !growArena(words)) {
+      return false;
+    }
+    idx = size_;
+    size_ += words;
+    return true;
+  }
+
+  sonic_never_inline bool growArena(size_t words) noexcept {
+    constexpr size_t kMaxWords = size_t(1) << 32;
+    if (size_ + words > kMaxWords) {
+      err_ = kErrorCompactLimit;
+      return false;
+    }
+    size_t cap = cap_ * 2;
+    if (cap < size_ + words) cap = size_ + words;
+    if (cap > kMaxWords) cap = kMaxWords;
+    CompactNode* arena = static_cast<CompactNode*>(
+        std::realloc((void*)arena_, sizeof(CompactNode) * cap));
+    if (!arena) {
+      err_ = kErrorNoMem;
+      return false;
+    }
+    arena_ = arena;
+    cap_ = cap;
+    return true;
+  }
+
+  sonic_never_inline bool grow() noexcept {
+    size_t cap = scap_ * 2;
+    uint64_t* st =
+        static_cast<uint64_t*>(std::realloc(st_, sizeof(uint64_t) * cap));
+    if (!st) {
+      err_ = kErrorNoMem;
+      return false;
+    }
+    st_ = st;
+    scap_ = cap;
+    return true;
+  }
+
+  // Move the root into the end of arena, and shrink the arena to fit.
+  bool finish() noexcept {
+    size_t idx;
+    if (err_ != kErrorNone || !alloc(1, idx)) return false;
+    move(st_, 1, idx);
+    CompactNode* arena = static_cast<CompactNode*>(
+        std::realloc((void*)arena_, sizeof(CompactNode) * size_));
+    if (arena) {
+      arena_ = arena;
+      cap_ = size_;
+    }
+    return true;
+  }
+
+  uint64_t* st_{nullptr};
+  size_t np_{0};
+  size_t scap_{0};
+  size_t parent_{0};
+
+  CompactNode* arena_{nullptr};
+  size_t size_{0};
+  size_t cap_{0};
+  SonicError err_{kErrorNone};
+};
+
+}  // namespace sonic_json
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "sonic/dom/generic_document.h"
+#include "sonic/internal/arch/simd_skip.h"
+
+namespace sonic_json {
+
+namespace internal {
+
+// Release the memory of the last record before parsing the next one.
+template <typename Allocator>
+sonic_force_inline void RewindAllocator(Allocator&) {}
+
+template <typename BaseAllocator, typename ChunkPolicy>
+sonic_force_inline void RewindAllocator(
+    MemoryPoolAllocator<BaseAllocator, ChunkPolicy>& alloc) {
+  alloc.Rewind();
+}
+
+// Find the next non-blank line from pos, and move pos after it. A raw newline
+// is invalid in json strings, so it always ends the record.
+sonic_force_inline bool NextRecord(const uint8_t* data, size_t& pos,
+                                   size_t len, size_t& start, size_t& end) {
+  while (pos < len) {
+    start = pos;
+    GetNextToken(data, pos, len, "\n");
+    end = pos;
+    if (pos < len) pos++;
+    for (size_t i = start; i < end; i++) {
+      if (!IsSpace(data[i])) return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+
+/**
+ * @brief GenericDocumentStream iterates the newline-delimited jsons (NDJSON or
+ * JSON Lines) in a buffer. Each record is parsed into the same document, and
+ * the parser, the node stack and the allocator chunks are reused between
+ * records. The blank lines are skipped.
+ *
+ * A parse error only fails the current record, and Next continues with the
+ * following one.
+ */
+template <typename NodeType>
+class GenericDocumentStream {
+ public:
+  using DocType = GenericDocument<NodeType>;
+  using Allocator = typename NodeType::AllocatorType;
+
+  /**
+   * @brief Constructor.
+   * @param json the newline-delimited jsons, must be alive when iterating.
+   * @param allocator Allocator pointer for the document. If it is nullptr,
+   * the document will create one by itself.
+   * @note Only the memory of the allocator created by the document is reused
+   * between records. The given allocator may hold the memory of others, so it
+   * is never rewound, and keeps the memory of all records until the caller
+   * releases it.
+   */
+  explicit GenericDocumentStream(StringView json = StringView(),
+                                 Allocator* allocator = nullptr)
+      : json_(json), doc_(allocator), sax_(doc_.GetAllocator()) {}
+
+  GenericDocumentStream(const GenericDocumentStream&) = delete;
+  GenericDocumentStream& operator=(const GenericDocumentStream&) = delete;
+
+  /**
+   * @brief Iterate a new buffer from the beginning.
+   */
+  void Reset(StringView json) {
+    json_ = json;
+    pos_ = 0;
+    start_ = 0;
+    record_ = StringView();
+  }
+
+  /**
+   * @brief Parse the next record into the document.
+   * @return false if there are no more records.
+   * @note The nodes of the last record are released, so they must not be
+   * used after calling Next.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  bool Next() {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(json_.data());
+    size_t end;
+    if (!internal::NextRecord(data, pos_, json_.size(), start_, end)) {
+      return false;
+    }
+    record_ = StringView(json_.data() + start_, end - start_);
+    doc_.destroyDom();
+    if (doc_.own_alloc_) internal::RewindAllocator(doc_.GetAllocator());
+    doc_.template parseImpl<parseFlags>(record_.data(), record_.size(),
+                                        parser_, sax_);
+    return true;
+  }
+
+  /**
+   * @brief Get the document of the current record. Check its parse error
+   * before using it.
+   */
+  sonic_force_inline DocType& Doc() { return doc_; }
+  sonic_force_inline const DocType& Doc() const { return doc_; }
+
+  /**
+   * @brief Get the raw json of the current record.
+   */
+  sonic_force_inline StringView Record() const { return record_; }
+
+  /**
+   * @brief Get the offset of the current record in the buffer.
+   */
+  sonic_force_inline size_t Offset() const { return start_; }
+
+ private:
+  StringView json_;
+  size_t pos_{0};
+  size_t start_{0};
+  StringView record_{};
+  DocType doc_;
+  Parser parser_{};
+  SAXHandler<NodeType> sax_;
+};
+
+using DocumentStream = GenericDocumentStream<DNode<SONIC_DEFAULT_ALLOCATOR>>;
+
+}  // namespace sonic_json
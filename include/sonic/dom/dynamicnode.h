@@ -16,13 +16,15 @@
 
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 
 #include "sonic/allocator.h"
 #include "sonic/dom/genericnode.h"
 #include "sonic/dom/handler.h"
+#include "sonic/dom/member_index.h"
 #include "sonic/dom/serialize.h"
 #include "sonic/dom/type.h"
 #include "sonic/error.h"
@@ -95,7 +97,12 @@ class DNode : public GenericNode<DNode<Allocator>> {
       case kArray: {
         size_t a_size = rhs.Size();
         this->a.len = rhs.getTypeAndLen();  // Copy size and type.
-        if (a_size > 0) {
+        if (rhs.IsPackedArray()) {
+          void* mem = containerMalloc<uint64_t>(a_size, alloc);
+          std::memcpy((char*)mem + sizeof(MetaNode), rhs.getPackedFirstUnsafe(),
+                      a_size * sizeof(uint64_t));
+          setChildren(mem);
+        } else if (a_size > 0) {
           rhsNodeType* rn = rhs.getArrChildrenFirst();
           void* mem = containerMalloc<DNode>(a_size, alloc);
           DNode* ln = (DNode*)((char*)mem + sizeof(MetaNode));
@@ -168,6 +175,9 @@ class DNode : public GenericNode<DNode<Allocator>> {
     if (this->getBasicType() != rhs.getBasicType()) {
       return false;
     }
+    if (sonic_unlikely(this->IsPackedArray() || rhs.IsPackedArray())) {
+      return packedEqual(rhs);
+    }
     switch (this->GetType()) {
       case kObject: {
         if (this->Size() != rhs.Size()) {
@@ -201,6 +211,7 @@ class DNode : public GenericNode<DNode<Allocator>> {
       case kStringCopy:
       case kStringFree:
       case kStringConst:
+      case kStringInline:
         return this->GetStringView() == rhs.GetStringView();
 
       case kReal:
@@ -247,13 +258,13 @@ class DNode : public GenericNode<DNode<Allocator>> {
       this->memberReserveImpl(16, alloc);
     }
     if (getMapUnsfe()) return true;
-    map_type* map = static_cast<map_type*>(alloc.Malloc(sizeof(map_type)));
-    new (map) map_type(MAType(&alloc));
-    // SetMap(map);
+    map_type* map = map_type::Create(this->Size(), alloc);
+    if (nullptr == map) return false;
     MemberNode* m = (MemberNode*)getObjChildrenFirstUnsafe();
     for (size_t i = 0; i < this->Size(); ++i) {
-      map->emplace(std::make_pair((m + i)->name.GetStringView(), i));
+      map->Insert(map_type::Hash((m + i)->name.GetStringView()), i);
     }
+    dropTags();
     setMap(map);
     return true;
   }
@@ -265,7 +276,6 @@ class DNode : public GenericNode<DNode<Allocator>> {
   void DestroyMap() {
     sonic_assert(this->IsObject());
     if (getMap()) {
-      getMap()->~map_type();
       Allocator::Free(getMap());
       setMap(nullptr);
     }
@@ -291,31 +301,133 @@ class DNode : public GenericNode<DNode<Allocator>> {
     return *this;
   }
 
+  /**
+   * @brief Get the elements of a packed array of doubles.
+   * @return pointer to the Size() doubles
+   */
+  const double* GetPackedDoubles() const {
+    sonic_assert(this->GetType() == kPackedReal);
+    return reinterpret_cast<const double*>(getPackedFirstUnsafe());
+  }
+
+  /**
+   * @brief Get the elements of a packed array of integers.
+   * @return pointer to the Size() integers
+   */
+  const int64_t* GetPackedInt64s() const {
+    sonic_assert(this->GetType() == kPackedInt);
+    return reinterpret_cast<const int64_t*>(getPackedFirstUnsafe());
+  }
+
+  /**
+   * @brief Turn a packed array into an array of number nodes, so that the
+   * elements can be accessed as nodes. It does nothing if the node is not a
+   * packed array.
+   * @param alloc allocator that maintain this node's memory
+   * @return DNode& reference to this node to support streaming APIs
+   */
+  DNode& Unpack(Allocator& alloc) {
+    if (!this->IsPackedArray()) return *this;
+    size_t count = this->Size();
+    void* mem = containerMalloc<DNode>(count, alloc);
+    DNode* ln = (DNode*)((char*)mem + sizeof(MetaNode));
+    for (size_t i = 0; i < count; i++) {
+      new (ln + i) DNode(packedAt(i));
+    }
+    Allocator::Free(children());
+    setChildren(mem);
+    this->setLength(count, kArray);
+    return *this;
+  }
+
   /**
    * @brief move another node to this.
    * @param rhs source node
    */
 
  private:
-  using MSType = StringView;
-  using MAType = MapAllocator<std::pair<const MSType, size_t>, Allocator>;
-  using map_type = std::multimap<MSType, size_t, std::less<MSType>, MAType>;
+  // The member index of CreateMap, which is a hash table in one block.
+  using map_type = internal::MemberIndex<Allocator>;
+  // The key tags of the medium objects, created in parsing with
+  // kParseCreateMap.
+  using tags_type = internal::KeyTags<Allocator>;
 
   struct MetaNode {
     size_t cap;
-    map_type* map;
+    // The member map, or the key tags if the low bit is set. An object has
+    // at most one of them.
+    uintptr_t lookup;
 
     ~MetaNode() {
-      if (map) {
-        map->~map_type();
-        Allocator::Free(map);
+      if (lookup) {
+        Allocator::Free(reinterpret_cast<void*>(lookup & ~uintptr_t(1)));
       }
     }
-    MetaNode() : cap{0}, map{nullptr} {}
-    MetaNode(size_t n) : cap{n}, map{nullptr} {}
+    MetaNode() : cap{0}, lookup{0} {}
+    MetaNode(size_t n) : cap{n}, lookup{0} {}
     void SetMetaCap(size_t n) { cap = n; }
   };
 
+  // The packed array type that can hold the number v, or kArray if none.
+  static sonic_force_inline TypeFlag packedType(const DNode& v) {
+    switch (v.GetType()) {
+      case kReal:
+        return kPackedReal;
+      case kSint:
+        return kPackedInt;
+      case kUint:
+        return v.n.u64 <= uint64_t(INT64_MAX) ? kPackedInt : kArray;
+      default:
+        return kArray;
+    }
+  }
+
+  // Pack the count numbers into this array, their packed type is packed.
+  void setPacked(const DNode* elems, size_t count, TypeFlag packed,
+                 Allocator& alloc) {
+    void* mem = containerMalloc<uint64_t>(count, alloc);
+    uint64_t* dst = (uint64_t*)((char*)mem + sizeof(MetaNode));
+    for (size_t i = 0; i < count; i++) {
+      dst[i] = elems[i].n.u64;
+    }
+    this->setLength(count, packed);
+    setChildren(mem);
+  }
+
+  sonic_force_inline uint64_t* getPackedFirstUnsafe() const {
+    sonic_assert(this->IsPackedArray());
+    return (uint64_t*)((char*)this->a.next.children + sizeof(MetaNode));
+  }
+
+  // The element at idx of a packed array, as a number node.
+  DNode packedAt(size_t idx) const {
+    uint64_t bits = getPackedFirstUnsafe()[idx];
+    if (this->GetType() == kPackedReal) {
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      return DNode(d);
+    }
+    return DNode(static_cast<int64_t>(bits));
+  }
+
+  template <typename SourceAllocator>
+  bool packedEqual(const DNode<SourceAllocator>& rhs) const {
+    size_t count = this->Size();
+    if (count != rhs.Size()) return false;
+    if (this->GetType() == rhs.GetType()) {
+      return std::memcmp(getPackedFirstUnsafe(), rhs.getPackedFirstUnsafe(),
+                         count * sizeof(uint64_t)) == 0;
+    }
+    if (this->IsPackedArray() && rhs.IsPackedArray()) return false;
+    for (size_t i = 0; i < count; i++) {
+      bool equal = this->IsPackedArray()
+                       ? packedAt(i) == rhs.getArrChildrenFirstUnsafe()[i]
+                       : getArrChildrenFirstUnsafe()[i] == rhs.packedAt(i);
+      if (!equal) return false;
+    }
+    return true;
+  }
+
   // Set APIs
   DNode& setNullImpl() {
     this->destroy();
@@ -393,19 +505,26 @@ class DNode : public GenericNode<DNode<Allocator>> {
   }
 
   DNode& popBackImpl() {
-    getArrChildrenFirstUnsafe()[this->Size() - 1].~DNode();
+    if (!this->IsPackedArray()) {
+      getArrChildrenFirstUnsafe()[this->Size() - 1].~DNode();
+    }
     this->subLength(1);
     return *this;
   }
 
   DNode& reserveImpl(size_t new_cap, Allocator& alloc) {
     if (new_cap > this->Capacity()) {
-      setChildren(containerRealloc<DNode>(children(), this->Capacity(), new_cap,
-                                          alloc));
+      setChildren(this->IsPackedArray()
+                      ? containerRealloc<uint64_t>(
+                            children(), this->Capacity(), new_cap, alloc)
+                      : containerRealloc<DNode>(children(), this->Capacity(),
+                                                new_cap, alloc));
     }
     return *this;
   }
 
+  // The elements of a packed array are not nodes, so it is an empty range
+  // of nodes until unpacked.
   ValueIterator beginImpl() noexcept {
     return ValueIterator(getArrChildrenFirst());
   }
@@ -415,14 +534,15 @@ class DNode : public GenericNode<DNode<Allocator>> {
   }
 
   ValueIterator endImpl() noexcept {
-    return ValueIterator(getArrChildrenFirst()) + this->Size();
+    return ValueIterator(getArrChildrenFirst()) + nodeCount();
   }
 
   ConstValueIterator cendImpl() const noexcept {
-    return ConstValueIterator(getArrChildrenFirst()) + this->Size();
+    return ConstValueIterator(getArrChildrenFirst()) + nodeCount();
   }
 
   DNode& backImpl() const noexcept {
+    if (sonic_unlikely(this->IsPackedArray())) return nullNode();
     return *(getArrChildrenFirst() + this->Size() - 1);
   }
 
@@ -503,9 +623,10 @@ class DNode : public GenericNode<DNode<Allocator>> {
     return (MetaNode*)(this->a.next.children);
   }
 
+  // It is nullptr for a packed array, whose elements are not nodes.
   sonic_force_inline DNode* getArrChildrenFirst() const {
     sonic_assert(this->IsArray());
-    if (nullptr == children()) {
+    if (nullptr == children() || this->IsPackedArray()) {
       return nullptr;
     }
     return (DNode*)((char*)this->a.next.children +
@@ -549,31 +670,68 @@ class DNode : public GenericNode<DNode<Allocator>> {
   sonic_force_inline void setMap(map_type* new_map) {
     sonic_assert(this->IsObject());
     sonic_assert(this->o.next.children != nullptr);
-    ((MetaNode*)(this->o.next.children))->map = new_map;
+    meta()->lookup = reinterpret_cast<uintptr_t>(new_map);
   }
 
   sonic_force_inline map_type* getMap() const {
     sonic_assert(this->IsObject());
     if (nullptr == children()) return nullptr;
-    return ((MetaNode*)(this->o.next.children))->map;
+    return getMapUnsfe();
   }
 
   sonic_force_inline map_type* getMapUnsfe() const {
     sonic_assert(this->IsObject());
-    return ((MetaNode*)(this->o.next.children))->map;
+    uintptr_t lookup = meta()->lookup;
+    return (lookup & 1) ? nullptr : reinterpret_cast<map_type*>(lookup);
+  }
+
+  sonic_force_inline tags_type* getTags() const {
+    sonic_assert(this->IsObject());
+    if (nullptr == children()) return nullptr;
+    uintptr_t lookup = meta()->lookup;
+    return (lookup & 1) ? reinterpret_cast<tags_type*>(lookup - 1) : nullptr;
+  }
+
+  // Create the key tags of a parsed object, which has no map.
+  bool createTags(Allocator& alloc) {
+    sonic_assert(nullptr != children() && 0 == meta()->lookup);
+    tags_type* tags =
+        tags_type::Create(memberBeginUnsafe(), this->Size(), alloc);
+    if (nullptr == tags) return false;
+    meta()->lookup = reinterpret_cast<uintptr_t>(tags) | 1;
+    return true;
+  }
+
+  void dropTags() {
+    tags_type* tags = getTags();
+    if (tags) {
+      Allocator::Free(tags);
+      meta()->lookup = 0;
+    }
   }
 
   sonic_force_inline MemberIterator findMemberImpl(StringView key) const {
-    if (nullptr != getMap()) {
-      auto it = getMap()->find(MSType(key.data(), key.size()));
-      if (it != getMap()->end()) {
-        return memberBeginUnsafe() + it->second;
+    uintptr_t lookup = nullptr != children() ? meta()->lookup : 0;
+    if (lookup & 1) {
+      tags_type* tags = reinterpret_cast<tags_type*>(lookup - 1);
+      return memberBeginUnsafe() +
+             tags->Find(key, memberBeginUnsafe(), this->Size());
+    }
+    if (lookup) {
+      map_type* map = reinterpret_cast<map_type*>(lookup);
+      uint32_t pos = map->Find(key, map_type::Hash(key), memberBeginUnsafe());
+      if (pos != map_type::kNotFound) {
+        return memberBeginUnsafe() + pos;
       }
       return memberEndUnsafe();
     }
     auto it = this->MemberBegin();
     for (auto e = this->MemberEnd(); it != e; ++it) {
-      if (it->name.GetStringView() == key) {
+      // the interned keys are matched by pointer without memcmp
+      StringView name = it->name.GetStringView();
+      if (name.size() == key.size() &&
+          (name.data() == key.data() ||
+           std::memcmp(name.data(), key.data(), key.size()) == 0)) {
         break;
       }
     }
@@ -585,13 +743,24 @@ class DNode : public GenericNode<DNode<Allocator>> {
     if (m != this->MemberEnd()) {
       return m->value;
     }
+    return nullNode();
+  }
+
+  DNode& findValueImpl(size_t idx) const noexcept {
+    if (sonic_unlikely(this->IsPackedArray())) return nullNode();
+    return *(getArrChildrenFirst() + idx);
+  }
+
+  // The null node for the missing values.
+  static DNode& nullNode() noexcept {
     static DNode tmp{};
     tmp.SetNull();
     return tmp;
   }
 
-  DNode& findValueImpl(size_t idx) const noexcept {
-    return *(getArrChildrenFirst() + idx);
+  // The count of the element nodes, which is 0 for a packed array.
+  sonic_force_inline size_t nodeCount() const noexcept {
+    return this->IsPackedArray() ? 0 : this->Size();
   }
 
   MemberIterator addMemberImpl(StringView key, DNode& value, Allocator& alloc,
@@ -623,9 +792,22 @@ class DNode : public GenericNode<DNode<Allocator>> {
     this->addLength(1);
 
     // maintain map
-    if (nullptr != getMap()) {
-      // If key exists, it will be still keeped in vector but replaced in map.
-      getMap()->emplace(std::make_pair(last->GetStringView(), count));
+    map_type* map = getMap();
+    if (nullptr != map) {
+      if (map->Full()) {
+        // drop the map if no memory, and the lookups fall back to scanning.
+        map_type* grown = map->Grow(alloc);
+        Allocator::Free(map);
+        setMap(grown);
+        map = grown;
+      }
+      // If key exists, the first one is still found by the map.
+      if (map) map->Insert(map_type::Hash(last->GetStringView()), count);
+    }
+    tags_type* tags = getTags();
+    if (nullptr != tags && !tags->Add(count, last->GetStringView())) {
+      // the tags are not grown, the larger object is scanned.
+      dropTags();
     }
     return (MemberIterator)last;
   }
@@ -636,10 +818,10 @@ class DNode : public GenericNode<DNode<Allocator>> {
       goto not_find;
     }
     if (getMapUnsfe()) {
-      auto it = getMapUnsfe()->find(MSType(key.data(), key.size()));
-      if (it != getMapUnsfe()->end()) {
-        m = memberBeginUnsafe() + it->second;
-        getMapUnsfe()->erase(it);
+      uint32_t pos =
+          getMapUnsfe()->Erase(key, map_type::Hash(key), memberBeginUnsafe());
+      if (pos != map_type::kNotFound) {
+        m = memberBeginUnsafe() + pos;
         goto find;
       }
 
@@ -660,20 +842,15 @@ class DNode : public GenericNode<DNode<Allocator>> {
       *m_name = std::move(*tail_name);
       m->value = std::move(m_tail->value);
       // maintain map
+      size_t pos = m - memberBeginUnsafe();
+      // the tail is moved to pos
       map_type* map = getMap();
       if (map) {
-        size_t pos = m - memberBeginUnsafe();
-        // erase tail
-        auto range =
-            map->equal_range(m->name.GetStringView());  // already moved.
-        for (auto i = range.first; i != range.second; ++i) {
-          if (i->second == this->Size() - 1) {
-            map->erase(i);
-            break;  // only one erase.
-          }
-        }
-        map->emplace(std::make_pair(m->name.GetStringView(), pos));
+        map->Move(map_type::Hash(m->name.GetStringView()), this->Size() - 1,
+                  pos);
       }
+      tags_type* tags = getTags();
+      if (tags) tags->Move(this->Size() - 1, pos);
     } else {
       m->name.~DNode();
       m->value.~DNode();
@@ -689,6 +866,7 @@ class DNode : public GenericNode<DNode<Allocator>> {
   MemberIterator eraseMemberImpl(MemberIterator first, MemberIterator last) {
     // Destroy map before removing members.
     DestroyMap();
+    dropTags();
     size_t size = this->Size();
     MemberIterator end = this->MemberEnd();
     if (size_t(last - first) >= size) {
@@ -712,6 +890,14 @@ class DNode : public GenericNode<DNode<Allocator>> {
   DNode& pushBackImpl(DNode& value, Allocator& alloc) {
     constexpr size_t k_default_array_cap = 16;
     sonic_assert(this->IsArray());
+    if (sonic_unlikely(this->IsPackedArray())) {
+      if (packedType(value) == this->GetType()) {
+        pushBackPacked(value, alloc);
+        return *this;
+      }
+      // the other values fall back to a normal array
+      Unpack(alloc);
+    }
     // reseve capacity
     size_t cap = this->Capacity();
     if (this->Size() >= cap) {
@@ -728,8 +914,22 @@ class DNode : public GenericNode<DNode<Allocator>> {
     return *this;
   }
 
+  void pushBackPacked(DNode& value, Allocator& alloc) {
+    size_t cap = this->Capacity();
+    if (this->Size() >= cap) {
+      size_t new_cap = cap ? cap + (cap + 1) / 2 : 16;
+      setChildren(containerRealloc<uint64_t>(children(), cap, new_cap, alloc));
+    }
+    getPackedFirstUnsafe()[this->Size()] = value.n.u64;
+    value.setType(kNull);
+    this->addLength(1);
+  }
+
   ValueIterator eraseImpl(ValueIterator start, ValueIterator end) {
     sonic_assert(this->IsArray());
+    // there are no element nodes in a packed array, and Erase by the indexes
+    // erases its elements
+    if (sonic_unlikely(this->IsPackedArray())) return this->End();
     sonic_assert(start <= end);
     sonic_assert(start >= this->Begin());
     sonic_assert(end <= this->End());
@@ -742,6 +942,22 @@ class DNode : public GenericNode<DNode<Allocator>> {
     return start;
   }
 
+  ValueIterator eraseImpl(size_t first, size_t last) {
+    sonic_assert(this->IsArray());
+    if (sonic_unlikely(this->IsPackedArray())) {
+      sonic_assert(first <= last && last <= this->Size());
+      // the packed elements are plain numbers, and moved without destructors
+      if (first < last) {
+        uint64_t* elems = getPackedFirstUnsafe();
+        std::memmove(elems + first, elems + last,
+                     (this->Size() - last) * sizeof(uint64_t));
+        this->subLength(last - first);
+      }
+      return this->End();
+    }
+    return eraseImpl(this->Begin() + first, this->Begin() + last);
+  }
+
   template <unsigned serializeFlags = kSerializeDefault>
   SonicError serializeImpl(WriteBuffer& wb) const {
     return internal::SerializeImpl<serializeFlags>(this, wb);
@@ -777,6 +993,10 @@ class DNode : public GenericNode<DNode<Allocator>> {
         Allocator::Free(children());
         break;
       }
+      case kPackedReal:
+      case kPackedInt:
+        Allocator::Free(children());
+        break;
       case kStringFree:
         Allocator::Free((void*)(this->sv.p));
         break;
@@ -792,7 +1012,8 @@ class DNode : public GenericNode<DNode<Allocator>> {
 
   DNode& clearImpl() {
     this->destroy();
-    this->setLength(0);
+    // a cleared packed array is a normal array
+    this->setLength(0, this->getBasicType());
     setChildren(nullptr);
     return *this;
   }
@@ -812,4 +1033,9 @@ struct NodeTraits<DNode<Allocator>> {
   using ConstValueIterator = const NodeType*;
 };
 
+namespace internal {
+template <typename Allocator>
+struct HasPackedArrays<DNode<Allocator>> : std::true_type {};
+}  // namespace internal
+
 }  // namespace sonic_json
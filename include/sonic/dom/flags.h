@@ -20,6 +20,33 @@
 // User can define customed flags through combinations.
 enum ParseFlag {
   kParseDefault = 0,
+  // Parse in two stages: index all structural characters with SIMD at first,
+  // and then build the document from the index.
+  kParseTwoStage = 1 << 0,
+  // Parse in the caller's writable buffer instead of a copy. The strings are
+  // unescaped in place, and the string nodes point into the buffer. It is set
+  // by GenericDocument::ParseInsitu.
+  kParseInsitu = 1 << 1,
+  // Validate the utf-8 encoding of strings, and fail with
+  // kParseErrorInvalidUTF8. The check is fused into the string copy loop.
+  kParseValidateUtf8 = 1 << 2,
+  // Intern the object keys: the same keys in a document share one string, so
+  // that FindMember can match them by pointer. The keys are deduped by a small
+  // table in the SAX handler, and the strings are still owned by the document.
+  kParseInternKeys = 1 << 3,
+  // Create the member map (see DNode::CreateMap) of the objects whose members
+  // are more than the threshold of GenericDocument::SetMapThreshold, while
+  // building the document. The objects of 8 members up to the threshold get a
+  // side array of key tags, which FindMember scans with SIMD, and the smaller
+  // objects are still scanned member by member.
+  kParseCreateMap = 1 << 4,
+  // Pack the arrays whose elements are all doubles, or all integers in int64,
+  // into a plain double[] or int64_t[] (see DNode::GetPackedDoubles). The
+  // elements of a packed array are not nodes: Begin()/End() of it is an empty
+  // range, operator[] and Back() return a shared null node that must not be
+  // modified, AtPointer returns nullptr, and only Erase by the indexes erases
+  // the elements. DNode::Unpack turns it into a normal array.
+  kParsePackNumbers = 1 << 5,
 };
 
 // SerializeFlags is one-hot encoded for different serializing option.
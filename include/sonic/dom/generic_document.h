@@ -18,9 +18,20 @@
 
 #include "sonic/dom/dynamicnode.h"
 #include "sonic/dom/json_pointer.h"
+#include "sonic/dom/parallel_array.h"
 #include "sonic/dom/parser.h"
+#include "sonic/dom/parser_context.h"
+#include "sonic/dom/streaming_parser.h"
+#include "sonic/internal/mapped_file.h"
 
 namespace sonic_json {
+
+template <typename NodeType>
+class GenericDocumentStream;
+
+template <typename NodeType>
+class GenericParallelDocumentStream;
+
 template <typename NodeType>
 class GenericDocument : public NodeType {
  public:
@@ -51,7 +62,10 @@ class GenericDocument : public NodeType {
         parse_result_(rhs.parse_result_),
         str_(rhs.str_),
         str_cap_(rhs.str_cap_),
-        strp_(rhs.strp_) {
+        strp_(rhs.strp_),
+        stream_(std::move(rhs.stream_)),
+        mapped_(std::move(rhs.mapped_)),
+        map_threshold_(rhs.map_threshold_) {
     rhs.clear();
   }
 
@@ -74,6 +88,9 @@ class GenericDocument : public NodeType {
     str_ = rhs.str_;
     str_cap_ = rhs.str_cap_;
     strp_ = rhs.strp_;
+    stream_ = std::move(rhs.stream_);
+    mapped_ = std::move(rhs.mapped_);
+    map_threshold_ = rhs.map_threshold_;
 
     // Step3: clear rhs memory
     rhs.clear();
@@ -91,6 +108,18 @@ class GenericDocument : public NodeType {
     std::swap(str_, rhs.str_);
     std::swap(str_cap_, rhs.str_cap_);
     std::swap(strp_, rhs.strp_);
+    stream_.swap(rhs.stream_);
+    mapped_.swap(rhs.mapped_);
+    std::swap(map_threshold_, rhs.map_threshold_);
+    return *this;
+  }
+
+  /**
+   * @brief Set the threshold of kParseCreateMap, the objects with more members
+   * than it get a member map in parsing. The default is 32.
+   */
+  GenericDocument& SetMapThreshold(size_t threshold) {
+    map_threshold_ = threshold;
     return *this;
   }
 
@@ -120,10 +149,88 @@ class GenericDocument : public NodeType {
 
   template <unsigned parseFlags = kParseDefault>
   GenericDocument& Parse(const char* data, size_t len) {
+    stream_.reset();
     destroyDom();
     return parseImpl<parseFlags>(data, len);
   }
 
+  /**
+   * @brief Parse with the parser and node stack kept in ctx, which are reused
+   * by the next parsing with the same ctx.
+   * @param parseFlags combination of different ParseFlag.
+   * @param json json string
+   * @param ctx the parser context
+   * @note The strings are copied into the document as Parse, so ctx can be
+   * reused or destroyed while the document is used.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& Parse(StringView json, GenericParserContext<NodeType>& ctx) {
+    static_assert(!(parseFlags & kParseInsitu),
+                  "use ParseInsitu to parse in a writable buffer");
+    stream_.reset();
+    destroyDom();
+    ctx.sax_.alloc_ = alloc_;
+    return parseImpl<parseFlags>(json.data(), json.size(), ctx.parser_,
+                                 ctx.sax_);
+  }
+
+  /**
+   * @brief Parse in the caller's buffer without copying it. The strings are
+   * unescaped in place, and the string nodes point into the buffer.
+   * @param parseFlags combination of different ParseFlag.
+   * @param buf writable buffer, which begins with the json
+   * @param len json length
+   * @param capacity buffer size, must be at least len + SONICJSON_PADDING
+   * @note The buffer must be alive while the document is used, and both the
+   * json and the padding bytes are overwritten.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseInsitu(char* buf, size_t len, size_t capacity) {
+    stream_.reset();
+    destroyDom();
+    if (capacity < len || capacity - len < SONICJSON_PADDING) {
+      parse_result_ = ParseResult(kParseErrorInsituPadding, len);
+      return *this;
+    }
+    Parser p;
+    SAXHandler<NodeType> sax(*alloc_);
+    return parseImpl<parseFlags | kParseInsitu>(buf, len, p, sax);
+  }
+
+  /**
+   * @brief Parse the json file without reading it into memory. The file is
+   * mapped copy-on-write with padding pages after it, and parsed in place as
+   * ParseInsitu.
+   * @param parseFlags combination of different ParseFlag.
+   * @param path the file path
+   * @note The mapping is kept by the document until the next parsing, because
+   * the string nodes point into it. The error is kErrorOpenFile if the file
+   * can't be opened or mapped.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseFile(const char* path) {
+    stream_.reset();
+    destroyDom();
+    std::unique_ptr<internal::MappedFile> file(new internal::MappedFile());
+    SonicError err = file->Open(path);
+    if (err != kErrorNone) {
+      parse_result_ = ParseResult(err, 0);
+      return *this;
+    }
+    Parser p;
+    SAXHandler<NodeType> sax(*alloc_);
+    parseImpl<parseFlags | kParseInsitu>(file->Data(), file->Size(), p, sax);
+    if (!HasParseError()) {
+      mapped_ = std::move(file);
+    }
+    return *this;
+  }
+
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseFile(const std::string& path) {
+    return ParseFile<parseFlags>(path.c_str());
+  }
+
   /**
    * @brief Parse by std::string
    * @param parseFlags combination of different ParseFlag.
@@ -144,9 +251,72 @@ class GenericDocument : public NodeType {
             typename JPStringType = SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>
   GenericDocument& ParseOnDemand(const char* data, size_t len,
                                  const GenericJsonPointer<JPStringType>& path) {
+    stream_.reset();
     destroyDom();
     return parseOnDemandImpl<parseFlags, JPStringType>(data, len, path);
   }
+  /**
+   * @brief Parse the json whose root is a huge array on multiple threads. The
+   * elements are split at depth 1 and parsed in parallel, then moved into the
+   * root array without deep copy.
+   * @param parseFlags combination of different ParseFlag.
+   * @param json json string
+   * @param threads the number of threads, 0 means the hardware concurrency.
+   * @note It is the same as Parse if the root is not an array, the json is
+   * small or invalid, or the allocator is not a memory pool.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseArrayParallel(StringView json, size_t threads = 0) {
+    stream_.reset();
+    destroyDom();
+    if (internal::ParallelArrayParser<NodeType>::template Parse<parseFlags>(
+            json, threads, *this, *alloc_, mapThreshold<parseFlags>())) {
+      parse_result_ = ParseResult(kErrorNone, json.size());
+      return *this;
+    }
+    destroyDom();
+    return parseImpl<parseFlags>(json.data(), json.size());
+  }
+
+  /**
+   * @brief Parse the json that arrives in successive chunks. The chunk is not
+   * referenced after the call, so the whole json text is never kept.
+   * @param parseFlags combination of different ParseFlag.
+   * @param chunk the next part of json
+   * @note call ParseChunkEnd after the last chunk to build the document. The
+   * first ParseChunk after ParseChunkEnd starts a new json.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseChunk(StringView chunk) {
+    if (!stream_) {
+      destroyDom();
+      stream_ = std::unique_ptr<StreamState>(new StreamState(*alloc_));
+    }
+    stream_->sax.map_threshold_ = mapThreshold<parseFlags>();
+    stream_->sax.pack_numbers_ = (parseFlags & kParsePackNumbers) != 0;
+    parse_result_ =
+        stream_->parser.template Feed<parseFlags>(chunk, stream_->sax);
+    return *this;
+  }
+
+  /**
+   * @brief Finish the chunked parsing, and build the document if no errors.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  GenericDocument& ParseChunkEnd() {
+    if (!stream_) {
+      destroyDom();
+      parse_result_ = ParseResult(kParseErrorEof, 0);
+      return *this;
+    }
+    parse_result_ = stream_->parser.template Finish<parseFlags>(stream_->sax);
+    if (!HasParseError()) {
+      NodeType::operator=(std::move(stream_->sax.st_[0]));
+    }
+    stream_.reset();
+    return *this;
+  }
+
   /**
    * @brief Check parse has error
    */
@@ -177,6 +347,7 @@ class GenericDocument : public NodeType {
   void destroyDom() {
     if (!Allocator::kNeedFree) {
       this->setType(kNull);
+      mapped_.reset();
       return;
     }
     // NOTE: must free dynamic nodes at first
@@ -185,28 +356,62 @@ class GenericDocument : public NodeType {
     // Avoid Double Free
     str_ = nullptr;
     this->setType(kNull);
+    // the string nodes may point into the mapped file
+    mapped_.reset();
   }
 
   template <unsigned parseFlags>
   GenericDocument& parseImpl(const char* json, size_t len) {
+    static_assert(!(parseFlags & kParseInsitu),
+                  "use ParseInsitu to parse in a writable buffer");
     Parser p;
     SAXHandler<NodeType> sax(*alloc_);
-    parse_result_ = allocateStringBuffer(json, len);
-    if (sonic_unlikely(HasParseError())) {
-      return *this;
+    return parseImpl<parseFlags>(json, len, p, sax);
+  }
+
+  // Parse with the given parser and handler, which may be reused by the
+  // caller to parse many jsons.
+  template <unsigned parseFlags>
+  GenericDocument& parseImpl(const char* json, size_t len, Parser& p,
+                             SAXHandler<NodeType>& sax) {
+    char* buf;
+    if (parseFlags & kParseInsitu) {
+      // the buffer is owned by the caller, and padded as allocateStringBuffer
+      buf = const_cast<char*>(json);
+      buf[len] = 'x';
+      buf[len + 1] = '"';
+      buf[len + 2] = 'x';
+    } else {
+      parse_result_ = allocateStringBuffer(json, len);
+      if (sonic_unlikely(HasParseError())) {
+        return *this;
+      }
+      buf = str_;
     }
     if (!sax.SetUp(StringView(json, len))) {
       parse_result_ = kErrorNoMem;
       return *this;
     }
-    parse_result_ = p.template Parse<parseFlags>(str_, len, sax);
+    sax.map_threshold_ = mapThreshold<parseFlags>();
+    sax.pack_numbers_ = (parseFlags & kParsePackNumbers) != 0;
+    parse_result_ = p.template Parse<parseFlags>(buf, len, sax);
     if (sonic_unlikely(HasParseError())) {
       return *this;
     }
     NodeType::operator=(std::move(sax.st_[0]));
+    if (!(parseFlags & kParseInsitu) && sax.buf_strings_ == 0) {
+      // all strings are inline, and the string buffer is not used any more
+      Allocator::Free(str_);
+      str_ = nullptr;
+    }
     return *this;
   }
 
+  template <unsigned parseFlags>
+  sonic_force_inline size_t mapThreshold() const {
+    return (parseFlags & kParseCreateMap) ? map_threshold_ : SIZE_MAX;
+  }
+
   template <unsigned parseFlags, typename JPStringType>
   GenericDocument& parseOnDemandImpl(
       const char* json, size_t len,
@@ -222,20 +427,19 @@ class GenericDocument : public NodeType {
   }
 
   SonicError allocateStringBuffer(const char* json, size_t len) {
-    size_t pad_len = len + 64;
-    str_ = (char*)(alloc_->Malloc(pad_len));
+    str_ = (char*)(alloc_->Malloc(len + SONICJSON_PADDING));
     if (str_ == nullptr) {
       return kErrorNoMem;
     }
-    std::memcpy(str_, json, len);
-    // Add ending mask to support parsing invalid json
-    str_[len] = 'x';
-    str_[len + 1] = '"';
-    str_[len + 2] = 'x';
+    internal::CopyPaddedJson(str_, json, len);
     return kErrorNone;
   }
 
   friend class Parser;
+  template <typename>
+  friend class GenericDocumentStream;
+  template <typename>
+  friend class GenericParallelDocumentStream;
 
   // Note: it is a callback function in parse.parse_impl
   void copyToRoot(DNode<Allocator>& node) {
@@ -243,6 +447,13 @@ class GenericDocument : public NodeType {
     NodeType::operator=(std::move(node));
   }
 
+  // States kept between ParseChunk calls
+  struct StreamState {
+    StreamState(Allocator& alloc) : sax(alloc) {}
+    StreamingParser parser;
+    StreamSAXHandler<NodeType> sax;
+  };
+
   std::unique_ptr<Allocator> own_alloc_{nullptr};
   Allocator* alloc_{nullptr};  // maybe external allocator
   ParseResult parse_result_{};
@@ -256,8 +467,15 @@ class GenericDocument : public NodeType {
   char* str_{nullptr};
   size_t str_cap_{0};
   long strp_{0};
+
+  std::unique_ptr<StreamState> stream_{nullptr};
+  // The mapped file of ParseFile
+  std::unique_ptr<internal::MappedFile> mapped_{nullptr};
+  // The objects with more members get a map with kParseCreateMap
+  size_t map_threshold_{32};
 };
 
 using Document = GenericDocument<DNode<SONIC_DEFAULT_ALLOCATOR>>;
+using ParserContext = GenericParserContext<DNode<SONIC_DEFAULT_ALLOCATOR>>;
 
 }  // namespace sonic_json
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <memory>
 
@@ -194,6 +195,10 @@ class GenericNode {
    * string.
    */
   void StringCopy(const char* s, size_t len, alloc_type& alloc) {
+    if (len <= kInlineStringMax) {
+      setInlineString(s, len);
+      return;
+    }
     sv.p = (char*)(alloc.Malloc(len + 1));
     if (sv.p) {
       std::memcpy(const_cast<char*>(sv.p), s, len);
@@ -247,6 +252,14 @@ class GenericNode {
   sonic_force_inline bool IsArray() const noexcept {
     return getBasicType() == kArray;
   }
+  /**
+   * @brief  Check this node is an array of packed numbers, which is parsed
+   * with kParsePackNumbers.
+   * @return true if it is a packed array.
+   */
+  sonic_force_inline bool IsPackedArray() const noexcept {
+    return IsArray() && GetType() != kArray;
+  }
   /**
    * @brief  Check this node is an object.
    * @return true if it is an object.
@@ -321,7 +334,7 @@ class GenericNode {
    */
   sonic_force_inline std::string GetString() const {
     sonic_assert(IsString());
-    return std::string(sv.p, Size());
+    return std::string(stringData(), Size());
   }
 
   /**
@@ -330,7 +343,7 @@ class GenericNode {
    */
   sonic_force_inline StringView GetStringView() const noexcept {
     sonic_assert(IsString());
-    return StringView(sv.p, Size());
+    return StringView(stringData(), Size());
   }
 
   /**
@@ -712,7 +725,8 @@ class GenericNode {
 
   template <typename... Args>
   sonic_force_inline NodeType* AtPointer(size_t idx, Args... args) {
-    if (!IsArray()) {
+    // the elements of a packed array are not nodes
+    if (!IsArray() || IsPackedArray()) {
       return nullptr;
     }
     if (idx >= Size()) {
@@ -723,7 +737,8 @@ class GenericNode {
 
   template <typename... Args>
   sonic_force_inline const NodeType* AtPointer(size_t idx, Args... args) const {
-    if (!IsArray()) {
+    // the elements of a packed array are not nodes
+    if (!IsArray() || IsPackedArray()) {
       return nullptr;
     }
     if (idx >= Size()) {
@@ -885,6 +900,8 @@ class GenericNode {
   /**
    * @brief Return array last element.
    * @return NodeType&
+   * @note A packed array returns a shared null node, which must not be
+   * modified. Unpack it before modifying its elements.
    */
   NodeType& Back() noexcept {
     sonic_assert(this->IsArray());
@@ -906,6 +923,8 @@ class GenericNode {
    * @brief Get specific child node in an array by index
    * @param idx index
    * @return NodeType&
+   * @note A packed array returns a shared null node, which must not be
+   * modified. Unpack it before modifying its elements.
    */
   NodeType& operator[](size_t idx) noexcept {
     sonic_assert(this->IsArray());
@@ -986,7 +1005,7 @@ class GenericNode {
    * @note erase in the range [first, last)
    */
   ValueIterator Erase(size_t first, size_t last) noexcept {
-    return Erase(Begin() + first, Begin() + last);
+    return downCast()->eraseImpl(first, last);
   }
 
   // Serialize API
@@ -1052,6 +1071,16 @@ class GenericNode {
     sv.p = "";
     setLength(0, kStringConst);
   }
+  // Store a short string in the node, len must be at most kInlineStringMax.
+  sonic_force_inline void setInlineString(const char* s, size_t len) noexcept {
+    sonic_assert(len <= kInlineStringMax);
+    sv.p = nullptr;
+    std::memcpy(sv.s, s, len);
+    setLength(len, kStringInline);
+  }
+  sonic_force_inline const char* stringData() const noexcept {
+    return GetType() == kStringInline ? sv.s : sv.p;
+  }
 
   sonic_force_inline int64_t getIntMax() const {
     return std::numeric_limits<int>::max();
@@ -1088,7 +1117,10 @@ class GenericNode {
 
   struct String {
     uint64_t len;
-    const char* p;
+    union {
+      const char* p;
+      char s[8];  // the string of kStringInline
+    };
   };  // 16 bytes
 
   struct Type {
@@ -1144,7 +1176,8 @@ class GenericNode {
         }
         return nullptr;
       } else {  // Json Pointer node is number
-        if (re->IsArray()) {
+        // the elements of a packed array are not nodes
+        if (re->IsArray() && !re->IsPackedArray()) {
           int idx = node.GetNum();
           if (idx >= 0 && idx < static_cast<int>(re->Size())) {
             re = &(re->operator[]((size_t)idx));
@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "sonic/dom/type.h"
 #include "sonic/internal/arch/simd_base.h"
+#include "sonic/internal/utils.h"
 #include "sonic/string_view.h"
 #include "sonic/writebuffer.h"
 
@@ -28,6 +32,83 @@ namespace sonic_json {
 template <typename NodeType>
 class GenericDocument;
 
+namespace internal {
+
+// KeyTable dedupes the object keys of a document. It is an open addressing
+// table of the first occurrences, and stops adding keys when half full, so
+// that the documents with too many distinct keys only pay for the lookups.
+// The table is sized by the keys that the json can hold, so parsing a small
+// json doesn't allocate and zero the whole table.
+class KeyTable {
+ public:
+  KeyTable() = default;
+  KeyTable(const KeyTable &) = delete;
+  KeyTable &operator=(const KeyTable &) = delete;
+  KeyTable(KeyTable &&rhs) noexcept
+      : slots_(std::move(rhs.slots_)), mask_(rhs.mask_), size_(rhs.size_) {
+    rhs.size_ = 0;
+  }
+  KeyTable &operator=(KeyTable &&rhs) noexcept {
+    slots_ = std::move(rhs.slots_);
+    mask_ = rhs.mask_;
+    size_ = rhs.size_;
+    rhs.slots_.clear();
+    rhs.size_ = 0;
+    return *this;
+  }
+
+  // Return the first key equal to s, and add s if it is a new key.
+  sonic_force_inline StringView Intern(StringView s) {
+    if (sonic_unlikely(slots_.size() <= mask_)) slots_.resize(mask_ + 1);
+    uint64_t h = HashBytes(s.data(), s.size());
+    uint32_t tag = static_cast<uint32_t>(h >> 32) | 1;
+    for (size_t i = h & mask_;; i = (i + 1) & mask_) {
+      Slot &slot = slots_[i];
+      if (slot.tag == 0) {
+        if (size_ <= mask_ / 2) {
+          slot = {s.data(), static_cast<uint32_t>(s.size()), tag};
+          size_++;
+        }
+        return s;
+      }
+      if (slot.tag == tag && slot.len == s.size() &&
+          std::memcmp(slot.p, s.data(), s.size()) == 0) {
+        return StringView(slot.p, slot.len);
+      }
+    }
+  }
+
+  // Forget the keys, which point into the last parsed json, and size the
+  // table for the next json that holds at most max_keys distinct keys.
+  sonic_force_inline void Clear(size_t max_keys) {
+    mask_ = kMinSlots - 1;
+    while (mask_ < kMaxSlots - 1 && mask_ / 2 < max_keys) {
+      mask_ = mask_ * 2 + 1;
+    }
+    if (size_ == 0) return;
+    std::memset(static_cast<void *>(slots_.data()), 0,
+                slots_.size() * sizeof(Slot));
+    size_ = 0;
+  }
+
+ private:
+  struct Slot {
+    const char *p;
+    uint32_t len;
+    uint32_t tag;  // the high bits of hash, and 0 is an empty slot
+  };
+  static constexpr size_t kMinSlots = 16;
+  static constexpr size_t kMaxSlots = 1024;
+
+  std::vector<Slot> slots_{};
+  // the slots in use are slots_[0, mask_], the others are left by a larger
+  // json and kept empty
+  size_t mask_{kMaxSlots - 1};
+  size_t size_{0};
+};
+
+}  // namespace internal
+
 template <typename NodeType>
 class SAXHandler {
  public:
@@ -44,7 +125,11 @@ class SAXHandler {
         np_(rhs.np_),
         cap_(rhs.cap_),
         parent_(rhs.parent_),
-        alloc_(rhs.alloc_) {
+        alloc_(rhs.alloc_),
+        map_threshold_(rhs.map_threshold_),
+        buf_strings_(rhs.buf_strings_),
+        pack_numbers_(rhs.pack_numbers_),
+        keys_(std::move(rhs.keys_)) {
     rhs.st_ = nullptr;
     rhs.cap_ = 0;
     rhs.np_ = 0;
@@ -58,6 +143,10 @@ class SAXHandler {
     cap_ = rhs.cap_;
     parent_ = rhs.parent_;
     alloc_ = rhs.alloc_;
+    map_threshold_ = rhs.map_threshold_;
+    buf_strings_ = rhs.buf_strings_;
+    pack_numbers_ = rhs.pack_numbers_;
+    keys_ = std::move(rhs.keys_);
 
     rhs.st_ = nullptr;
     rhs.np_ = 0;
@@ -70,7 +159,17 @@ class SAXHandler {
   ~SAXHandler() { TearDown(); }
 
   sonic_force_inline bool SetUp(StringView json) {
+    // drop the nodes left by the last parsing, if the handler is reused
+    for (size_t i = 0; i < np_; i++) {
+      st_[i].~NodeType();
+    }
+    np_ = 0;
+    parent_ = 0;
+    buf_strings_ = 0;
     size_t len = json.size();
+    // an interned key is longer than the inline strings, and is followed by
+    // ':' and a value at least
+    keys_.Clear(len / (kInlineStringMax + 4));
     size_t cap = len / 2 + 2;
     if (cap < 16) cap = 16;
     if (!st_ || cap_ < cap) {
@@ -89,6 +188,9 @@ class SAXHandler {
     }
     std::free(st_);
     st_ = nullptr;
+    np_ = 0;
+    cap_ = 0;
+    parent_ = 0;
   };
 
 #define SONIC_ADD_NODE()       \
@@ -126,13 +228,20 @@ class SAXHandler {
     return true;
   }
 
-  sonic_force_inline bool Key(StringView s) { return stringImpl(s); }
+  // Key is only called for the keys with kParseInternKeys, and the others are
+  // added by String. The short keys are inline and need no interning.
+  sonic_force_inline bool Key(StringView s) {
+    if (s.size() <= kInlineStringMax) return stringImpl(s);
+    return stringImpl(keys_.Intern(s));
+  }
 
   sonic_force_inline bool String(StringView s) { return stringImpl(s); }
 
   sonic_force_inline bool StartObject() noexcept {
     SONIC_ADD_NODE();
-    NodeType *cur = &st_[np_ - 1];
+    // The open container is null until its end, so that it is safe to tear
+    // down the stack if parsing failed.
+    NodeType *cur = new (&st_[np_ - 1]) NodeType(kNull);
     cur->o.next.ofs = parent_;
     parent_ = np_ - 1;
     return true;
@@ -140,7 +249,9 @@ class SAXHandler {
 
   sonic_force_inline bool StartArray() noexcept {
     SONIC_ADD_NODE();
-    NodeType *cur = &st_[np_ - 1];
+    // The open container is null until its end, so that it is safe to tear
+    // down the stack if parsing failed.
+    NodeType *cur = new (&st_[np_ - 1]) NodeType(kNull);
     cur->o.next.ofs = parent_;
     parent_ = np_ - 1;
     return true;
@@ -160,6 +271,13 @@ class SAXHandler {
     }
     np_ = parent_ + 1;
     parent_ = old;
+    // lookups still work by scanning if there is no memory for them
+    if (sonic_unlikely(pairs > map_threshold_)) {
+      obj.CreateMap(*alloc_);
+    } else if (sonic_unlikely(pairs >= kTagsMinMembers &&
+                              map_threshold_ != SIZE_MAX)) {
+      obj.createTags(*alloc_);
+    }
     return true;
   }
 
@@ -167,7 +285,9 @@ class SAXHandler {
     NodeType &arr = st_[parent_];
     size_t old = arr.o.next.ofs;
     arr.setLength(count, kArray);
-    if (count) {
+    if (sonic_unlikely(pack_numbers_ && count) && packArray(arr, count)) {
+      // the numbers are copied into the packed array
+    } else if (count) {
       arr.setChildren(arr.template containerMalloc<NodeType>(count, *alloc_));
       internal::Xmemcpy<sizeof(NodeType)>(
           (void *)arr.getArrChildrenFirstUnsafe(), (void *)(&arr + 1), count);
@@ -179,25 +299,69 @@ class SAXHandler {
     return true;
   }
 
- private:
+ protected:
   friend class GenericDocument<NodeType>;
 
   sonic_force_inline bool stringImpl(StringView s) {
     SONIC_ADD_NODE();
+    if (s.size() <= kInlineStringMax) {
+      st_[np_ - 1].setInlineString(s.data(), s.size());
+      return true;
+    }
     st_[np_ - 1].setLength(s.size(), kStringCopy);
     st_[np_ - 1].sv.p = s.data();
+    buf_strings_++;
+    return true;
+  }
+
+  // Copy the string into allocator, used when the parsed json is not kept.
+  sonic_force_inline bool copyStringImpl(StringView s) {
+    if (s.size() <= kInlineStringMax) return stringImpl(s);
+    char *p = static_cast<char *>(alloc_->Malloc(s.size() + 1));
+    if (!p) return false;
+    std::memcpy(p, s.data(), s.size());
+    p[s.size()] = '\0';
+    SONIC_ADD_NODE();
+    st_[np_ - 1].setLength(s.size(), kStringFree);
+    st_[np_ - 1].sv.p = p;
     return true;
   }
 
 #undef SONIC_ADD_NODE
 
+  // Pack the children of arr if they are numbers of one packed type, see
+  // kParsePackNumbers.
+  sonic_force_inline bool packArray(NodeType &arr, uint32_t count) {
+    const NodeType *elems = &arr + 1;
+    TypeFlag packed = NodeType::packedType(elems[0]);
+    if (packed == kArray) return false;
+    for (uint32_t i = 1; i < count; i++) {
+      if (NodeType::packedType(elems[i]) != packed) return false;
+    }
+    arr.setPacked(elems, count, packed, *alloc_);
+    return true;
+  }
+
   sonic_force_inline bool node() noexcept {
     if (sonic_likely(np_ < cap_)) {
       np_++;
       return true;
-    } else {
-      return false;
     }
+    return grow();
+  }
+
+  // The stack is sized by the json length in SetUp, and only grows when the
+  // length is unknown, as in streaming parsing. The parents are indexes, so
+  // it is safe to move the nodes.
+  sonic_never_inline bool grow() noexcept {
+    size_t cap = cap_ < 16 ? 16 : cap_ * 2;
+    NodeType *st = static_cast<NodeType *>(
+        std::realloc((void *)(st_), sizeof(NodeType) * cap));
+    if (!st) return false;
+    st_ = st;
+    cap_ = cap;
+    np_++;
+    return true;
   }
 
   NodeType *st_{nullptr};
@@ -205,6 +369,15 @@ class SAXHandler {
   size_t cap_{0};
   size_t parent_{0};
   Allocator *alloc_{nullptr};
+  // the objects with more members get a map, set by kParseCreateMap
+  size_t map_threshold_{SIZE_MAX};
+  // the smaller objects with at least these members get the key tags
+  static constexpr size_t kTagsMinMembers = 8;
+  // the string nodes pointing into the parsed json, the others are inline
+  size_t buf_strings_{0};
+  // pack the arrays of numbers, set by kParsePackNumbers
+  bool pack_numbers_{false};
+  internal::KeyTable keys_{};
 };
 
 template <typename NodeType>
@@ -266,6 +439,10 @@ class LazySAXHandler {
   sonic_force_inline bool Key(const char *data, size_t len, size_t allocated) {
     new (stack_.PushSize<NodeType>(1)) NodeType();
     NodeType *key = stack_.Top<NodeType>();
+    if (!allocated && len <= kInlineStringMax) {
+      key->setInlineString(data, len);
+      return true;
+    }
     key->setLength(len, allocated ? kStringFree : kStringCopy);
     key->sv.p = data;
     return true;
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sonic/dom/parser.h"
+#include "sonic/dom/type.h"
+#include "sonic/error.h"
+#include "sonic/internal/arch/simd_quote.h"
+#include "sonic/internal/arch/simd_skip.h"
+
+namespace sonic_json {
+
+namespace internal {
+
+// ScalarHandler keeps the number or literal parsed by Parser.
+struct ScalarHandler {
+  bool Null() {
+    type = kNull;
+    return true;
+  }
+  bool Bool(bool v) {
+    type = v ? kTrue : kFalse;
+    return true;
+  }
+  bool Uint(uint64_t v) {
+    type = kUint;
+    u = v;
+    return true;
+  }
+  bool Int(int64_t v) {
+    type = kSint;
+    i = v;
+    return true;
+  }
+  bool Double(double v) {
+    type = kReal;
+    d = v;
+    return true;
+  }
+  bool String(StringView) { return false; }
+  bool Key(StringView) { return false; }
+  bool StartObject() { return false; }
+  bool StartArray() { return false; }
+  bool EndObject(uint32_t) { return false; }
+  bool EndArray(uint32_t) { return false; }
+
+  TypeFlag type{kNull};
+  union {
+    uint64_t u;
+    int64_t i;
+    double d;
+  };
+};
+
+// Skip the spaces and return the next char, or 0 if it is the end.
+sonic_force_inline uint8_t SkipSpaceOrEnd(SkipScanner &scan,
+                                          const uint8_t *data, size_t &pos,
+                                          size_t len) {
+  if (pos >= len) return 0;
+  uint8_t c = scan.SkipSpaceSafe(data, pos, len);
+  return IsSpace(c) ? 0 : c;
+}
+
+// Skip the string from pos, which is after the opening quote, and get the
+// unescaped string. buf keeps the string if it has escaped chars.
+sonic_force_inline SonicError ReadString(const uint8_t *data, size_t &pos,
+                                         size_t len, StringView &str,
+                                         std::string &buf) {
+  const uint8_t *sp = data + pos;
+  int skips = SkipString(data, pos, len);
+  if (!skips) return kParseErrorInvalidChar;
+  size_t sn = data + pos - 1 - sp;
+  if (skips == 1) {
+    str = StringView(reinterpret_cast<const char *>(sp), sn);
+    return kErrorNone;
+  }
+  // unescape in a padded copy with the ending quote
+  buf.assign(reinterpret_cast<const char *>(sp), sn + 1);
+  buf.resize(sn + 1 + SONICJSON_PADDING);
+  uint8_t *src = reinterpret_cast<uint8_t *>(&buf[0]);
+  SonicError err = kErrorNone;
+  sn = parseStringInplace(src, err);
+  if (err) return err;
+  str = StringView(buf.data(), sn);
+  return kErrorNone;
+}
+
+}  // namespace internal
+
+class ArrayIterator;
+
+/**
+ * @brief JsonCursor points to a json value in the raw json text, and reads it
+ * on demand without building a DOM. The values which are not visited are
+ * skipped by the SIMD skipping kernels.
+ *
+ * JsonCursor is a lightweight copyable view, and the json text must be alive
+ * while it is used. The json text does not need padding.
+ */
+class JsonCursor {
+ public:
+  JsonCursor() = default;
+
+  /**
+   * @brief Point to the root value of the json.
+   */
+  explicit JsonCursor(StringView json)
+      : data_(reinterpret_cast<const uint8_t *>(json.data())),
+        len_(json.size()) {
+    while (pos_ < len_ && internal::IsSpace(data_[pos_])) pos_++;
+  }
+
+  bool IsNull() const { return peek() == 'n'; }
+  bool IsBool() const { return peek() == 't' || peek() == 'f'; }
+  bool IsNumber() const {
+    uint8_t c = peek();
+    return c == '-' || (c >= '0' && c <= '9');
+  }
+  bool IsString() const { return peek() == '"'; }
+  bool IsObject() const { return peek() == '{'; }
+  bool IsArray() const { return peek() == '['; }
+
+  /**
+   * @brief The offset of the value in the json text.
+   */
+  size_t Offset() const { return pos_; }
+
+  /**
+   * @brief Find the value of the key in the object. The search continues from
+   * the field after the last found one, and wraps around to the first field,
+   * so reading the fields in order scans the object only once.
+   * @return kParseErrorUnknownObjKey if not found, kParseErrorMismatchType if
+   * it is not an object.
+   */
+  SonicError FindField(StringView key, JsonCursor &value) {
+    if (!IsObject()) return mismatch();
+    internal::SkipScanner scan;
+    size_t begin = pos_ + 1;
+    size_t from = begin;
+    size_t stop = std::string::npos;
+    if (field_ != 0) {
+      // skip the last found value
+      size_t pos = field_;
+      if (scan.SkipOne(data_, pos, len_) < 0) return kParseErrorInvalidChar;
+      uint8_t c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+      if (c == ',') {
+        from = pos;
+        stop = pos;
+      } else if (c != '}') {
+        return kParseErrorInvalidChar;
+      }
+    }
+    SonicError err = findField(key, from, std::string::npos, value);
+    if (err == kParseErrorUnknownObjKey && from != begin) {
+      err = findField(key, begin, stop, value);
+    }
+    return err;
+  }
+
+  /**
+   * @brief Iterate the elements of the array.
+   */
+  inline ArrayIterator IterateArray() const;
+
+  SonicError GetBool(bool &val) const {
+    if (!IsBool()) return mismatch();
+    size_t pos = pos_ + 1;
+    if (!internal::SkipLiteral(data_, pos, len_, peek())) {
+      return kParseErrorInvalidChar;
+    }
+    val = peek() == 't';
+    return kErrorNone;
+  }
+
+  SonicError GetInt64(int64_t &val) const {
+    internal::ScalarHandler num;
+    SonicError err = parseNumber(num);
+    if (err) return err;
+    if (num.type == kSint) {
+      val = num.i;
+    } else if (num.type == kUint && num.u <= INT64_MAX) {
+      val = static_cast<int64_t>(num.u);
+    } else {
+      return kParseErrorMismatchType;
+    }
+    return kErrorNone;
+  }
+
+  SonicError GetUint64(uint64_t &val) const {
+    internal::ScalarHandler num;
+    SonicError err = parseNumber(num);
+    if (err) return err;
+    if (num.type == kUint) {
+      val = num.u;
+    } else if (num.type == kSint && num.i >= 0) {
+      val = static_cast<uint64_t>(num.i);
+    } else {
+      return kParseErrorMismatchType;
+    }
+    return kErrorNone;
+  }
+
+  SonicError GetDouble(double &val) const {
+    internal::ScalarHandler num;
+    SonicError err = parseNumber(num);
+    if (err) return err;
+    switch (num.type) {
+      case kUint:
+        val = static_cast<double>(num.u);
+        break;
+      case kSint:
+        val = static_cast<double>(num.i);
+        break;
+      default:
+        val = num.d;
+    }
+    return kErrorNone;
+  }
+
+  /**
+   * @brief Get the unescaped string.
+   */
+  SonicError GetString(std::string &val) const {
+    if (!IsString()) return mismatch();
+    size_t pos = pos_ + 1;
+    StringView str;
+    std::string buf;
+    SonicError err = internal::ReadString(data_, pos, len_, str, buf);
+    if (err) return err;
+    val.assign(str.data(), str.size());
+    return kErrorNone;
+  }
+
+  /**
+   * @brief Get the raw json text of the value.
+   */
+  SonicError GetRaw(StringView &val) const {
+    if (pos_ >= len_) return kParseErrorEof;
+    internal::SkipScanner scan;
+    size_t pos = pos_;
+    long start = scan.SkipOne(data_, pos, len_);
+    if (start < 0) return SonicError(-start);
+    val = StringView(reinterpret_cast<const char *>(data_ + start),
+                     pos - start);
+    return kErrorNone;
+  }
+
+ private:
+  friend class ArrayIterator;
+
+  JsonCursor(const uint8_t *data, size_t len, size_t pos)
+      : data_(data), len_(len), pos_(pos) {}
+
+  uint8_t peek() const { return pos_ < len_ ? data_[pos_] : 0; }
+
+  SonicError mismatch() const {
+    return pos_ < len_ ? kParseErrorMismatchType : kParseErrorEof;
+  }
+
+  // Find the key in the fields from pos, which is after '{' or ','. The search
+  // stops at '}' or stop.
+  SonicError findField(StringView key, size_t pos, size_t stop,
+                       JsonCursor &value) {
+    internal::SkipScanner scan;
+    std::string kbuf;
+    bool first = pos == pos_ + 1;
+    while (pos != stop) {
+      uint8_t c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+      if (c == '}' && first) return kParseErrorUnknownObjKey;
+      if (c != '"') return kParseErrorInvalidChar;
+      first = false;
+      StringView k;
+      SonicError err = internal::ReadString(data_, pos, len_, k, kbuf);
+      if (err) return err;
+      if (internal::SkipSpaceOrEnd(scan, data_, pos, len_) != ':') {
+        return kParseErrorInvalidChar;
+      }
+      if (k == key) {
+        internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+        value = JsonCursor(data_, len_, pos - 1);
+        field_ = pos - 1;
+        return kErrorNone;
+      }
+      if (scan.SkipOne(data_, pos, len_) < 0) return kParseErrorInvalidChar;
+      c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+      if (c == '}') return kParseErrorUnknownObjKey;
+      if (c != ',') return kParseErrorInvalidChar;
+    }
+    return kParseErrorUnknownObjKey;
+  }
+
+  SonicError parseNumber(internal::ScalarHandler &num) const {
+    if (!IsNumber()) return mismatch();
+    size_t pos = pos_;
+    internal::SkipNumber(data_, pos, len_);
+    size_t n = pos - pos_;
+    // parse a padded copy, because the json text is not padded
+    char small[64 + SONICJSON_PADDING];
+    std::vector<char> large;
+    char *buf = small;
+    if (n > 64) {
+      large.resize(n + SONICJSON_PADDING);
+      buf = large.data();
+    }
+    std::memcpy(buf, data_ + pos_, n);
+    std::memset(buf + n, 0, SONICJSON_PADDING);
+    Parser p;
+    return p.Parse(buf, n, num).Error();
+  }
+
+  const uint8_t *data_{nullptr};
+  size_t len_{0};
+  size_t pos_{0};
+  // the last found value of FindField, 0 if none
+  size_t field_{0};
+};
+
+/**
+ * @brief ArrayIterator iterates the elements of an array. The element which
+ * is not visited is skipped when moving to the next one.
+ */
+class ArrayIterator {
+ public:
+  /**
+   * @brief Move to the next element.
+   * @return false if no more elements, or has errors.
+   */
+  bool Next() {
+    if (err_ || done_) return false;
+    internal::SkipScanner scan;
+    size_t pos = pos_;
+    uint8_t c;
+    if (started_) {
+      if (scan.SkipOne(data_, pos, len_) < 0) {
+        return fail(kParseErrorInvalidChar);
+      }
+      c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+      if (c == ']') {
+        done_ = true;
+        return false;
+      }
+      if (c != ',') return fail(kParseErrorInvalidChar);
+      c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+    } else {
+      started_ = true;
+      c = internal::SkipSpaceOrEnd(scan, data_, pos, len_);
+      if (c == ']') {
+        done_ = true;
+        return false;
+      }
+    }
+    if (c == 0) return fail(kParseErrorEof);
+    pos_ = pos - 1;
+    value_ = JsonCursor(data_, len_, pos_);
+    return true;
+  }
+
+  /**
+   * @brief The current element.
+   */
+  JsonCursor &Value() { return value_; }
+
+  /**
+   * @brief The error of iterating, kParseErrorMismatchType if it is not an
+   * array.
+   */
+  SonicError Error() const { return err_; }
+
+ private:
+  friend class JsonCursor;
+
+  ArrayIterator(const uint8_t *data, size_t len, size_t pos, SonicError err)
+      : data_(data), len_(len), pos_(pos), err_(err) {}
+
+  bool fail(SonicError err) {
+    err_ = err;
+    return false;
+  }
+
+  const uint8_t *data_;
+  size_t len_;
+  // after '[' at first, and then the start of the current element
+  size_t pos_;
+  SonicError err_;
+  bool started_{false};
+  bool done_{false};
+  JsonCursor value_{};
+};
+
+inline ArrayIterator JsonCursor::IterateArray() const {
+  if (!IsArray()) return ArrayIterator(data_, len_, pos_, mismatch());
+  return ArrayIterator(data_, len_, pos_ + 1, kErrorNone);
+}
+
+}  // namespace sonic_json
@@ -0,0 +1,618 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "sonic/dom/json_cursor.h"
+#include "sonic/dom/json_pointer.h"
+#include "sonic/error.h"
+#include "sonic/internal/arch/simd_skip.h"
+#include "sonic/string_view.h"
+
+namespace sonic_json {
+
+namespace internal {
+class JsonPathWalker;
+}  // namespace internal
+
+/**
+ * @brief JsonPath is a compiled JSONPath expression. The supported subset is:
+ *  - `$`: the root value, which must be the first.
+ *  - `.name`, `['name']`, `["name"]`: the field of an object.
+ *  - `[n]`: the element of an array, n must not be negative.
+ *  - `[start:end:step]`: the elements in the slice, all parts are optional and
+ *    must not be negative.
+ *  - `.*`, `[*]`: all fields or elements.
+ *  - `..name`, `..*`, `..[...]`: the step is also applied to all descendants.
+ *  - `[?(@.a.b op literal)]`, `[?(@.a)]`: the fields or elements which match
+ *    the condition, op is one of `== != < <= > >=`, and the literal is a
+ *    number, a quoted string without escapes, true, false or null.
+ *
+ * Negative indexes are not supported, because the json is evaluated in one
+ * pass and the size of an array is unknown before it is scanned.
+ */
+class JsonPath {
+ public:
+  JsonPath() = default;
+  explicit JsonPath(StringView expr) { Parse(expr); }
+
+  /**
+   * @brief Compile the expression.
+   * @return kErrorInvalidJsonPath if the expression is invalid or has more
+   * than 63 steps.
+   */
+  SonicError Parse(StringView expr) {
+    steps_.clear();
+    expr_ = expr;
+    pos_ = 0;
+    err_ = parse();
+    if (err_) steps_.clear();
+    return err_;
+  }
+
+  /**
+   * @brief The error of the last Parse.
+   */
+  SonicError Error() const { return err_; }
+
+  /**
+   * @brief The number of steps after `$`.
+   */
+  size_t Size() const { return steps_.size(); }
+
+ private:
+  friend class internal::JsonPathWalker;
+
+  enum StepKind : uint8_t {
+    kStepKey,
+    kStepIndex,
+    kStepSlice,
+    kStepWildcard,
+    kStepFilter,
+  };
+
+  enum FilterOp : uint8_t {
+    kOpExist,
+    kOpEq,
+    kOpNe,
+    kOpLt,
+    kOpLe,
+    kOpGt,
+    kOpGe,
+  };
+
+  struct Filter {
+    JsonPointer path{};
+    FilterOp op{kOpExist};
+    TypeFlag type{kNull};  // kNull, kTrue, kFalse, kReal or kStringCopy
+    double num{0};
+    std::string str{};
+  };
+
+  struct Step {
+    StepKind kind{kStepWildcard};
+    bool descendant{false};
+    std::string key{};
+    size_t start{0};
+    size_t end{SIZE_MAX};
+    size_t step{1};
+    Filter filter{};
+
+    // Whether the field or element is selected, the filter is not checked.
+    bool Match(StringView k) const {
+      return kind != kStepIndex && kind != kStepSlice &&
+             (kind != kStepKey || k == StringView(key.data(), key.size()));
+    }
+    bool Match(size_t i) const {
+      switch (kind) {
+        case kStepKey:
+          return false;
+        case kStepIndex:
+          return i == start;
+        case kStepSlice:
+          return i >= start && i < end && (i - start) % step == 0;
+        default:
+          return true;
+      }
+    }
+  };
+
+  static constexpr size_t kMaxSteps = 63;
+
+  uint8_t peek() const { return pos_ < expr_.size() ? expr_[pos_] : 0; }
+
+  void skipSpace() {
+    while (pos_ < expr_.size() && internal::IsSpace(expr_[pos_])) pos_++;
+  }
+
+  bool consume(char c) {
+    if (peek() != c) return false;
+    pos_++;
+    return true;
+  }
+
+  static bool isNameChar(uint8_t c) {
+    return c && c != '.' && c != '[' && c != ']' && c != '(' && c != ')' &&
+           !internal::IsSpace(c) && c != '=' && c != '!' && c != '<' &&
+           c != '>';
+  }
+
+  bool parseName(std::string& name) {
+    size_t start = pos_;
+    while (isNameChar(peek())) pos_++;
+    name.assign(expr_.data() + start, pos_ - start);
+    return pos_ != start;
+  }
+
+  bool parseQuoted(std::string& str) {
+    uint8_t q = peek();
+    if (q != '\'' && q != '"') return false;
+    size_t start = ++pos_;
+    while (pos_ < expr_.size() && expr_[pos_] != q) pos_++;
+    if (pos_ == expr_.size()) return false;
+    str.assign(expr_.data() + start, pos_ - start);
+    pos_++;
+    return true;
+  }
+
+  bool parseSize(size_t& n) {
+    if (peek() < '0' || peek() > '9') return false;
+    n = 0;
+    while (peek() >= '0' && peek() <= '9') {
+      size_t d = peek() - '0';
+      if (n > (SIZE_MAX - d) / 10) return false;
+      n = n * 10 + d;
+      pos_++;
+    }
+    return true;
+  }
+
+  // Parse `[...]` after `[`.
+  bool parseBracket(Step& step) {
+    skipSpace();
+    uint8_t c = peek();
+    if (c == '\'' || c == '"') {
+      step.kind = kStepKey;
+      if (!parseQuoted(step.key)) return false;
+    } else if (c == '*') {
+      pos_++;
+      step.kind = kStepWildcard;
+    } else if (c == '?') {
+      pos_++;
+      step.kind = kStepFilter;
+      if (!parseFilter(step.filter)) return false;
+    } else {
+      bool has_start = parseSize(step.start);
+      skipSpace();
+      if (!consume(':')) {
+        step.kind = kStepIndex;
+        if (!has_start) return false;
+      } else {
+        step.kind = kStepSlice;
+        skipSpace();
+        parseSize(step.end);
+        skipSpace();
+        if (consume(':')) {
+          skipSpace();
+          if (parseSize(step.step) && step.step == 0) return false;
+        }
+      }
+    }
+    skipSpace();
+    return consume(']');
+  }
+
+  // Parse `(@... op literal)` after `?`.
+  bool parseFilter(Filter& filter) {
+    skipSpace();
+    if (!consume('(')) return false;
+    skipSpace();
+    if (!consume('@')) return false;
+    while (true) {
+      if (consume('.')) {
+        std::string name;
+        if (!parseName(name)) return false;
+        filter.path /= JsonPointerNode(name);
+      } else if (consume('[')) {
+        skipSpace();
+        std::string name;
+        size_t i;
+        if (parseQuoted(name)) {
+          filter.path /= JsonPointerNode(name);
+        } else if (parseSize(i) && i <= INT32_MAX) {
+          filter.path /= JsonPointerNode(static_cast<int>(i));
+        } else {
+          return false;
+        }
+        skipSpace();
+        if (!consume(']')) return false;
+      } else {
+        break;
+      }
+    }
+    skipSpace();
+    if (!parseOp(filter.op)) return false;
+    if (filter.op != kOpExist) {
+      skipSpace();
+      if (!parseLiteral(filter)) return false;
+      skipSpace();
+    }
+    return consume(')');
+  }
+
+  bool parseOp(FilterOp& op) {
+    uint8_t c = peek();
+    if (c == ')') {
+      op = kOpExist;
+      return true;
+    }
+    if (pos_ + 1 >= expr_.size()) return false;
+    bool eq = expr_[pos_ + 1] == '=';
+    switch (c) {
+      case '=':
+        op = kOpEq;
+        break;
+      case '!':
+        op = kOpNe;
+        break;
+      case '<':
+        op = eq ? kOpLe : kOpLt;
+        break;
+      case '>':
+        op = eq ? kOpGe : kOpGt;
+        break;
+      default:
+        return false;
+    }
+    if ((c == '=' || c == '!') && !eq) return false;
+    pos_ += eq ? 2 : 1;
+    return true;
+  }
+
+  bool parseLiteral(Filter& filter) {
+    uint8_t c = peek();
+    if (c == '\'' || c == '"') {
+      filter.type = kStringCopy;
+      return parseQuoted(filter.str);
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+      size_t start = pos_;
+      while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E' ||
+             (c >= '0' && c <= '9')) {
+        pos_++;
+        c = peek();
+      }
+      std::string num(expr_.data() + start, pos_ - start);
+      char* end = nullptr;
+      filter.type = kReal;
+      filter.num = std::strtod(num.c_str(), &end);
+      return end == num.c_str() + num.size();
+    }
+    std::string word;
+    if (!parseName(word)) return false;
+    if (word == "true") {
+      filter.type = kTrue;
+    } else if (word == "false") {
+      filter.type = kFalse;
+    } else if (word == "null") {
+      filter.type = kNull;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  SonicError parse() {
+    skipSpace();
+    if (!consume('$')) return kErrorInvalidJsonPath;
+    while (true) {
+      skipSpace();
+      if (pos_ == expr_.size()) break;
+      Step step;
+      if (consume('.')) {
+        step.descendant = consume('.');
+        if (consume('*')) {
+          step.kind = kStepWildcard;
+        } else if (step.descendant && consume('[')) {
+          if (!parseBracket(step)) return kErrorInvalidJsonPath;
+        } else if (parseName(step.key)) {
+          step.kind = kStepKey;
+        } else {
+          return kErrorInvalidJsonPath;
+        }
+      } else if (consume('[')) {
+        if (!parseBracket(step)) return kErrorInvalidJsonPath;
+      } else {
+        return kErrorInvalidJsonPath;
+      }
+      if (steps_.size() == kMaxSteps) return kErrorInvalidJsonPath;
+      steps_.emplace_back(std::move(step));
+    }
+    return kErrorNone;
+  }
+
+  std::vector<Step> steps_{};
+  SonicError err_{kErrorNone};
+  // the expression while parsing
+  StringView expr_{};
+  size_t pos_{0};
+};
+
+namespace internal {
+
+// JsonPathWalker evaluates a JsonPath in one pass of the json. Each value
+// is visited with a bitmask of the steps to match, bit k means the value is
+// reached by the first k steps, and bit n means the value is a result. The
+// values whose mask is zero are skipped. The containers being walked are kept
+// in an explicit stack, so the deeply nested json does not overflow the call
+// stack.
+class JsonPathWalker {
+ public:
+  JsonPathWalker(StringView json, const JsonPath& path,
+                 std::vector<StringView>& results)
+      : data_(reinterpret_cast<const uint8_t*>(json.data())),
+        len_(json.size()),
+        steps_(path.steps_),
+        results_(results) {}
+
+  SonicError Walk(size_t& pos) {
+    const uint64_t done = 1ull << steps_.size();
+    uint64_t mask = 1;
+    stack_.clear();
+    while (true) {
+      // walk the value at pos
+      bool open = false;
+      if (!(mask & ~done)) {
+        // no more steps to match
+        long start = scan_.SkipOne(data_, pos, len_);
+        if (start < 0) return SonicError(-start);
+        if (mask) results_.emplace_back(raw(start, pos));
+      } else {
+        uint8_t c = next(pos);
+        if (c == 0) return kParseErrorEof;
+        size_t start = pos - 1;
+        if (c == '{' || c == '[') {
+          // reserve the result to keep the document order
+          stack_.push_back(Frame{mask, start, results_.size(), 0, c == '{'});
+          if (mask & done) results_.emplace_back();
+          open = true;
+        } else {
+          pos = start;
+          long s = scan_.SkipOne(data_, pos, len_);
+          if (s < 0) return SonicError(-s);
+          if (mask & done) results_.emplace_back(raw(start, pos));
+        }
+      }
+      SonicError err = nextChild(pos, open, mask);
+      if (err) return err;
+      if (stack_.empty()) return kErrorNone;
+    }
+  }
+
+ private:
+  using Step = JsonPath::Step;
+  using Filter = JsonPath::Filter;
+
+  // An object or array being walked.
+  struct Frame {
+    uint64_t mask;
+    size_t start;
+    // the reserved result if the container is matched
+    size_t slot;
+    // the index of the next element
+    size_t index;
+    bool is_obj;
+  };
+
+  sonic_force_inline uint8_t next(size_t& pos) {
+    return SkipSpaceOrEnd(scan_, data_, pos, len_);
+  }
+
+  // The raw value, the spaces after a number are trimmed.
+  StringView raw(size_t start, size_t end) const {
+    while (end > start && IsSpace(data_[end - 1])) end--;
+    return StringView(reinterpret_cast<const char*>(data_ + start),
+                      end - start);
+  }
+
+  // Move pos to the next child of the innermost container, and get the mask
+  // of the child. The ended containers are popped, so the stack is empty if
+  // the root is ended. open is true if the container was just opened.
+  SonicError nextChild(size_t& pos, bool open, uint64_t& child) {
+    const uint64_t done = 1ull << steps_.size();
+    while (!stack_.empty()) {
+      Frame& f = stack_.back();
+      uint8_t c = next(pos);
+      if (c == (f.is_obj ? '}' : ']')) {
+        if (f.mask & done) results_[f.slot] = raw(f.start, pos);
+        stack_.pop_back();
+        open = false;
+        continue;
+      }
+      if (!open) {
+        if (c != ',') return kParseErrorInvalidChar;
+        c = next(pos);
+      }
+      if (c == 0) return kParseErrorEof;
+      child = 0;
+      bool filter = false;
+      if (f.is_obj) {
+        if (c != '"') return kParseErrorInvalidChar;
+        SonicError err = ReadString(data_, pos, len_, key_, kbuf_);
+        if (err) return err;
+        if (next(pos) != ':') return kParseErrorInvalidChar;
+        matchChild(f.mask, key_, child, filter);
+      } else {
+        pos--;
+        matchChild(f.mask, f.index++, child, filter);
+      }
+      if (filter) return checkFilters(pos, f.mask, child);
+      return kErrorNone;
+    }
+    return kErrorNone;
+  }
+
+  // Match the steps of the parent mask on the field key or element index of
+  // a child. The filters are checked on the child value later.
+  template <typename KeyOrIndex>
+  void matchChild(uint64_t mask, KeyOrIndex k, uint64_t& child,
+                  bool& filter) const {
+    for (size_t i = 0; i < steps_.size(); i++) {
+      if (!(mask & (1ull << i))) continue;
+      const Step& step = steps_[i];
+      if (step.descendant) child |= 1ull << i;
+      if (step.kind == JsonPath::kStepFilter) {
+        filter = true;
+      } else if (step.Match(k)) {
+        child |= 1ull << (i + 1);
+      }
+    }
+  }
+
+  // Check the filters of the parent mask on the child value at pos.
+  SonicError checkFilters(size_t& pos, uint64_t mask, uint64_t& child) {
+    uint8_t c = next(pos);
+    if (c == 0) return kParseErrorEof;
+    pos--;
+    JsonCursor value(
+        StringView(reinterpret_cast<const char*>(data_ + pos), len_ - pos));
+    for (size_t k = 0; k < steps_.size(); k++) {
+      const Step& step = steps_[k];
+      if ((mask & (1ull << k)) && step.kind == JsonPath::kStepFilter &&
+          check(step.filter, value)) {
+        child |= 1ull << (k + 1);
+      }
+    }
+    return kErrorNone;
+  }
+
+  static bool check(const Filter& filter, JsonCursor value) {
+    for (const auto& node : filter.path) {
+      if (node.IsStr()) {
+        JsonCursor field;
+        if (value.FindField(StringView(node.GetStr()), field)) return false;
+        value = field;
+      } else {
+        auto it = value.IterateArray();
+        int i = 0;
+        bool found = false;
+        while (it.Next()) {
+          if (i++ == node.GetNum()) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) return false;
+        value = it.Value();
+      }
+    }
+    if (filter.op == JsonPath::kOpExist) return true;
+    int cmp;
+    if (!compare(filter, value, cmp)) return filter.op == JsonPath::kOpNe;
+    switch (filter.op) {
+      case JsonPath::kOpEq:
+        return cmp == 0;
+      case JsonPath::kOpNe:
+        return cmp != 0;
+      case JsonPath::kOpLt:
+        return cmp < 0;
+      case JsonPath::kOpLe:
+        return cmp <= 0;
+      case JsonPath::kOpGt:
+        return cmp > 0;
+      default:
+        return cmp >= 0;
+    }
+  }
+
+  // Compare the value with the literal, return false if the types are not
+  // comparable. Only numbers and strings are ordered.
+  static bool compare(const Filter& filter, const JsonCursor& value, int& cmp) {
+    bool ordered = filter.op != JsonPath::kOpEq && filter.op != JsonPath::kOpNe;
+    switch (filter.type) {
+      case kReal: {
+        double d;
+        if (!value.IsNumber() || value.GetDouble(d)) return false;
+        cmp = d < filter.num ? -1 : (d > filter.num ? 1 : 0);
+        return d == d;  // NaN is never equal
+      }
+      case kStringCopy: {
+        std::string s;
+        if (!value.IsString() || value.GetString(s)) return false;
+        cmp = s.compare(filter.str);
+        return true;
+      }
+      case kNull:
+        cmp = 0;
+        return !ordered && value.IsNull();
+      default: {
+        bool b;
+        if (ordered || !value.IsBool() || value.GetBool(b)) return false;
+        cmp = b == (filter.type == kTrue) ? 0 : 1;
+        return true;
+      }
+    }
+  }
+
+  const uint8_t* data_;
+  size_t len_;
+  const std::vector<Step>& steps_;
+  std::vector<StringView>& results_;
+  SkipScanner scan_{};
+  std::vector<Frame> stack_{};
+  // the key being matched, kbuf_ keeps it if it has escaped chars
+  StringView key_{};
+  std::string kbuf_{};
+};
+
+}  // namespace internal
+
+/**
+ * @brief Get the raw json text of all values matched by the JsonPath, in the
+ * document order, with one pass of the json. The values not on the path are
+ * skipped by the SIMD skipping kernels, and no DOM is built.
+ * @param json the json text, which does not need padding.
+ * @param path the compiled JsonPath.
+ * @param results the matched values, cleared on errors. A matched value can
+ * be parsed into a document with GenericDocument::Parse if needed.
+ */
+inline ParseResult GetByJsonPath(StringView json, const JsonPath& path,
+                                 std::vector<StringView>& results) {
+  results.clear();
+  if (path.Error()) return ParseResult(path.Error());
+  internal::JsonPathWalker walker(json, path, results);
+  size_t pos = 0;
+  SonicError err = walker.Walk(pos);
+  if (err) results.clear();
+  return ParseResult(err, pos);
+}
+
+/**
+ * @brief Compile the JsonPath expression and get the matched values.
+ */
+inline ParseResult GetByJsonPath(StringView json, StringView expr,
+                                 std::vector<StringView>& results) {
+  JsonPath path;
+  path.Parse(expr);
+  return GetByJsonPath(json, path, results);
+}
+
+}  // namespace sonic_json
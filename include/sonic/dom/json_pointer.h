@@ -17,6 +17,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "sonic/string_view.h"
@@ -155,11 +156,89 @@ class GenericJsonPointer
   }
 };
 
+/**
+ * @brief GenericJsonPointerTrie merges the common prefixes of json pointers,
+ * so that all of them can be resolved in one pass of the json. The paths are
+ * numbered in the order they are added.
+ */
+template <typename StringType = SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>
+class GenericJsonPointerTrie {
+ public:
+  struct Node {
+    // children by object key
+    std::vector<std::pair<StringType, size_t>> keys;
+    // children by array index, sorted by index
+    std::vector<std::pair<int, size_t>> indexes;
+    // the numbers of the paths ending here
+    std::vector<size_t> paths;
+    bool IsLeaf() const { return keys.empty() && indexes.empty(); }
+  };
+
+  GenericJsonPointerTrie() : nodes_(1) {}
+  GenericJsonPointerTrie(
+      const std::vector<GenericJsonPointer<StringType>>& paths)
+      : nodes_(1) {
+    for (const auto& path : paths) {
+      Add(path);
+    }
+  }
+
+  /**
+   * @brief Add a path into the trie.
+   * @return the number of the path.
+   */
+  size_t Add(const GenericJsonPointer<StringType>& path) {
+    size_t cur = 0;
+    for (const auto& node : path) {
+      cur = node.IsStr() ? keyChild(cur, node.GetStr())
+                         : indexChild(cur, node.GetNum());
+    }
+    nodes_[cur].paths.push_back(size_);
+    return size_++;
+  }
+
+  /**
+   * @brief The number of paths.
+   */
+  size_t Size() const { return size_; }
+
+  /**
+   * @brief Get the node, and the root node is 0.
+   */
+  const Node& GetNode(size_t i) const { return nodes_[i]; }
+
+ private:
+  size_t keyChild(size_t cur, const StringType& key) {
+    for (const auto& child : nodes_[cur].keys) {
+      if (child.first == key) return child.second;
+    }
+    nodes_[cur].keys.emplace_back(key, nodes_.size());
+    nodes_.emplace_back();
+    return nodes_.size() - 1;
+  }
+
+  size_t indexChild(size_t cur, int index) {
+    auto& indexes = nodes_[cur].indexes;
+    auto it = indexes.begin();
+    while (it != indexes.end() && it->first < index) it++;
+    if (it != indexes.end() && it->first == index) return it->second;
+    indexes.emplace(it, index, nodes_.size());
+    nodes_.emplace_back();
+    return nodes_.size() - 1;
+  }
+
+  std::vector<Node> nodes_;
+  size_t size_{0};
+};
+
 using JsonPointer =
     GenericJsonPointer<SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>;
 using JsonPointerNode =
     GenericJsonPointerNode<SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>;
 
+using JsonPointerTrie =
+    GenericJsonPointerTrie<SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>;
+
 using JsonPointerView = GenericJsonPointer<StringView>;
 using JsonPointerNodeView = GenericJsonPointerNode<StringView>;
 
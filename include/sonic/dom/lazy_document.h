@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "sonic/dom/lazynode.h"
+#include "sonic/dom/readonly_document.h"
+#include "sonic/error.h"
+#include "sonic/internal/utils.h"
+
+namespace sonic_json {
+
+/**
+ * @brief A read-only document of LazyNodes. Parse only splits the root into
+ * raw children, and the other values are parsed on the first access.
+ *
+ * The syntax errors are found in parsing only for the structure of the json.
+ * The invalid scalars and keys in a raw child are found when it is expanded,
+ * and the child stays kRaw then.
+ */
+class LazyDocument : public ReadOnlyDocument<LazyDocument, LazyNode> {
+ public:
+  LazyDocument() noexcept = default;
+  LazyDocument(const LazyDocument&) = delete;
+  LazyDocument& operator=(const LazyDocument&) = delete;
+  LazyDocument(LazyDocument&& rhs) noexcept = default;
+  LazyDocument& operator=(LazyDocument&& rhs) noexcept = default;
+
+  LazyDocument& Parse(StringView json) {
+    return Parse(json.data(), json.size());
+  }
+
+  LazyDocument& Parse(const char* data, size_t len) {
+    ctx_.reset(new internal::LazyContext());
+    parse_result_ = ParseResult();
+    // the scalars are parsed in place, and the parser needs the padding
+    char* buf = internal::MallocPaddedJson(data, len);
+    if (!buf) {
+      parse_result_ = kErrorNoMem;
+      ctx_.reset();
+      return *this;
+    }
+    ctx_->json = buf;
+    internal::LazyContext& ctx = *ctx_;
+    parse_result_ = ctx.parseLazy(ctx.root, StringView(buf, len));
+    if (!HasParseError() && ctx.root.IsRaw()) {
+      parse_result_ = ctx.parseScalar(ctx.root, ctx.root.GetRaw());
+    }
+    if (HasParseError()) ctx_.reset();
+    return *this;
+  }
+
+ private:
+  friend class ReadOnlyDocument<LazyDocument, LazyNode>;
+
+  const LazyNode* rootImpl() const noexcept {
+    return ctx_ ? &ctx_->root : nullptr;
+  }
+
+  std::unique_ptr<internal::LazyContext> ctx_{nullptr};
+};
+
+}  // namespace sonic_json
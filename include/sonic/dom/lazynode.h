@@ -0,0 +1,394 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+#include "sonic/allocator.h"
+#include "sonic/dom/genericnode.h"
+#include "sonic/dom/handler.h"
+#include "sonic/dom/parser.h"
+#include "sonic/dom/serialize.h"
+#include "sonic/dom/type.h"
+#include "sonic/error.h"
+#include "sonic/string_view.h"
+#include "sonic/writebuffer.h"
+
+namespace sonic_json {
+
+class LazyNode;
+class LazyDocument;
+
+namespace internal {
+struct LazyContext;
+}  // namespace internal
+
+/**
+ * @brief The iterator of the array elements of a LazyNode, which expands the
+ * element when it is dereferenced.
+ */
+class LazyValueIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = LazyNode;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const LazyNode*;
+  using reference = const LazyNode&;
+
+  LazyValueIterator() noexcept = default;
+  LazyValueIterator(LazyNode* p, internal::LazyContext* ctx) noexcept
+      : p_(p), ctx_(ctx) {}
+
+  sonic_force_inline reference operator*() const noexcept;
+  sonic_force_inline pointer operator->() const noexcept;
+  sonic_force_inline LazyValueIterator& operator++() noexcept;
+  sonic_force_inline LazyValueIterator operator++(int) noexcept {
+    LazyValueIterator it = *this;
+    ++(*this);
+    return it;
+  }
+  sonic_force_inline bool operator==(const LazyValueIterator& rhs) const {
+    return p_ == rhs.p_;
+  }
+  sonic_force_inline bool operator!=(const LazyValueIterator& rhs) const {
+    return p_ != rhs.p_;
+  }
+
+ private:
+  LazyNode* p_{nullptr};
+  internal::LazyContext* ctx_{nullptr};
+};
+
+/**
+ * @brief The iterator of the object members of a LazyNode, which expands the
+ * member value when it is dereferenced. The keys are always parsed.
+ */
+class LazyMemberIterator {
+ public:
+  using MemberNode = MemberNodeT<LazyNode>;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = MemberNode;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const MemberNode*;
+  using reference = const MemberNode&;
+
+  LazyMemberIterator() noexcept = default;
+  LazyMemberIterator(MemberNode* p, internal::LazyContext* ctx) noexcept
+      : p_(p), ctx_(ctx) {}
+
+  sonic_force_inline reference operator*() const noexcept;
+  sonic_force_inline pointer operator->() const noexcept;
+  sonic_force_inline LazyMemberIterator& operator++() noexcept;
+  sonic_force_inline LazyMemberIterator operator++(int) noexcept {
+    LazyMemberIterator it = *this;
+    ++(*this);
+    return it;
+  }
+  sonic_force_inline bool operator==(const LazyMemberIterator& rhs) const {
+    return p_ == rhs.p_;
+  }
+  sonic_force_inline bool operator!=(const LazyMemberIterator& rhs) const {
+    return p_ != rhs.p_;
+  }
+
+ private:
+  MemberNode* p_{nullptr};
+  internal::LazyContext* ctx_{nullptr};
+};
+
+template <>
+struct NodeTraits<LazyNode> {
+  using alloc_type = SONIC_DEFAULT_ALLOCATOR;
+  using NodeType = LazyNode;
+  using MemberNode = MemberNodeT<LazyNode>;
+  using MemberIterator = LazyMemberIterator;
+  using ConstMemberIterator = LazyMemberIterator;
+  using ValueIterator = LazyValueIterator;
+  using ConstValueIterator = LazyValueIterator;
+};
+
+/**
+ * @brief A read-only node of LazyDocument, which is expanded on the first
+ * access.
+ *
+ * The children of an expanded container are kRaw slices of the json at first.
+ * A child is parsed when it is reached by FindMember, operator[] or the
+ * iterators: a scalar is parsed fully, and a container is parsed to one level
+ * of raw children again, as ParseLazy. The raw children are serialized by
+ * copying their json. The expanding changes the children of a const node, so
+ * the first access of a node is not thread-safe.
+ */
+class LazyNode : public GenericNode<LazyNode> {
+ public:
+  using NodeType = LazyNode;
+  using BaseNode = GenericNode<LazyNode>;
+  using AllocatorType = typename NodeTraits<LazyNode>::alloc_type;
+  using MemberNode = typename NodeTraits<LazyNode>::MemberNode;
+  using ConstMemberIterator = typename NodeTraits<LazyNode>::ConstMemberIterator;
+  using ConstValueIterator = typename NodeTraits<LazyNode>::ConstValueIterator;
+
+  friend BaseNode;
+  friend class LazySAXHandler<LazyNode>;
+  friend class LazyDocument;
+  friend struct internal::LazyContext;
+  template <unsigned serializeFlags, typename NodeType>
+  friend SonicError internal::SerializeImpl(const NodeType*, WriteBuffer&);
+
+  using BaseNode::BaseNode;
+  LazyNode() noexcept : BaseNode() {}
+  LazyNode(const LazyNode&) = delete;
+  LazyNode& operator=(const LazyNode&) = delete;
+
+ private:
+  // The header before the children, as the MetaNode of DNode.
+  struct Header {
+    internal::LazyContext* ctx;
+    size_t cap;
+  };
+
+  // Parse a raw scalar into the node.
+  class ScalarHandler;
+
+  sonic_force_inline void* children() const noexcept {
+    return this->o.next.children;
+  }
+  sonic_force_inline Header* header() const noexcept {
+    return static_cast<Header*>(children());
+  }
+  sonic_force_inline internal::LazyContext* ctx() const noexcept {
+    return header()->ctx;
+  }
+  sonic_force_inline LazyNode* getArrChildrenFirstUnsafe() const noexcept {
+    return reinterpret_cast<LazyNode*>(static_cast<char*>(children()) +
+                                       sizeof(Header));
+  }
+  // the members are pairs of nodes, as in DNode
+  sonic_force_inline LazyNode* getObjChildrenFirstUnsafe() const noexcept {
+    return getArrChildrenFirstUnsafe();
+  }
+  sonic_force_inline MemberNode* members() const noexcept {
+    return reinterpret_cast<MemberNode*>(getObjChildrenFirstUnsafe());
+  }
+
+  // The hooks of LazySAXHandler, and the context is set after parsing.
+  template <typename T>
+  sonic_force_inline void* containerMalloc(size_t cap, AllocatorType& alloc) {
+    Header* h =
+        static_cast<Header*>(alloc.Malloc(sizeof(Header) + sizeof(T) * cap));
+    if (h) {
+      h->ctx = nullptr;
+      h->cap = cap;
+    }
+    return h;
+  }
+  sonic_force_inline void setChildren(void* p) noexcept {
+    this->o.next.children = p;
+  }
+  LazyNode& setRawImpl(const char* s, size_t len) noexcept {
+    this->raw.p = s;
+    this->setLength(len, kRaw);
+    return *this;
+  }
+
+  ConstValueIterator cbeginImpl() const noexcept {
+    if (this->Empty()) return ConstValueIterator();
+    return ConstValueIterator(getArrChildrenFirstUnsafe(), ctx());
+  }
+  ConstValueIterator cendImpl() const noexcept {
+    if (this->Empty()) return ConstValueIterator();
+    return ConstValueIterator(getArrChildrenFirstUnsafe() + this->Size(),
+                              ctx());
+  }
+  ConstMemberIterator cmemberBeginImpl() const noexcept {
+    if (this->Empty()) return ConstMemberIterator();
+    return ConstMemberIterator(members(), ctx());
+  }
+  ConstMemberIterator cmemberEndImpl() const noexcept {
+    if (this->Empty()) return ConstMemberIterator();
+    return ConstMemberIterator(members() + this->Size(),
+                               ctx());
+  }
+
+  // The keys are compared without expanding the values.
+  ConstMemberIterator findMemberImpl(StringView key) const noexcept {
+    if (this->Empty()) return ConstMemberIterator();
+    MemberNode* m = members();
+    for (MemberNode* e = m + this->Size(); m != e; ++m) {
+      if (m->name.GetStringView() == key) break;
+    }
+    return ConstMemberIterator(m, ctx());
+  }
+
+  const LazyNode& findValueImpl(StringView key) const noexcept {
+    auto m = findMemberImpl(key);
+    if (m != this->MemberEnd()) return m->value;
+    static const LazyNode kNullNode;
+    return kNullNode;
+  }
+
+  const LazyNode& findValueImpl(size_t idx) const noexcept {
+    return *ConstValueIterator(getArrChildrenFirstUnsafe() + idx, ctx());
+  }
+
+  template <unsigned serializeFlags = kSerializeDefault>
+  SonicError serializeImpl(WriteBuffer& wb) const {
+    return internal::SerializeImpl<serializeFlags>(this, wb);
+  }
+
+  sonic_force_inline const LazyNode* cnextImpl() const noexcept {
+    return this + 1;
+  }
+};
+
+class LazyNode::ScalarHandler {
+ public:
+  explicit ScalarHandler(LazyNode& node) noexcept : node_(node) {}
+
+  sonic_force_inline bool Null() noexcept {
+    new (&node_) LazyNode(kNull);
+    return true;
+  }
+  sonic_force_inline bool Bool(bool val) noexcept {
+    new (&node_) LazyNode(val);
+    return true;
+  }
+  sonic_force_inline bool Uint(uint64_t val) noexcept {
+    new (&node_) LazyNode(val);
+    return true;
+  }
+  sonic_force_inline bool Int(int64_t val) noexcept {
+    new (&node_) LazyNode(val);
+    return true;
+  }
+  sonic_force_inline bool Double(double val) noexcept {
+    new (&node_) LazyNode(val);
+    return true;
+  }
+  // the string is unescaped in the json buffer of the document
+  sonic_force_inline bool String(StringView s) noexcept {
+    if (s.size() <= kInlineStringMax) {
+      node_.setInlineString(s.data(), s.size());
+    } else {
+      node_.setLength(s.size(), kStringCopy);
+      node_.sv.p = s.data();
+    }
+    return true;
+  }
+  sonic_force_inline bool Key(StringView s) noexcept { return String(s); }
+
+  // The raw containers are parsed by ParseLazy.
+  sonic_force_inline bool StartObject() noexcept { return false; }
+  sonic_force_inline bool StartArray() noexcept { return false; }
+  sonic_force_inline bool EndObject(uint32_t) noexcept { return false; }
+  sonic_force_inline bool EndArray(uint32_t) noexcept { return false; }
+
+ private:
+  LazyNode& node_;
+};
+
+namespace internal {
+
+// The states shared by the nodes of a LazyDocument to expand the raw values.
+// It is not moved, as the containers keep a pointer to it.
+struct LazyContext {
+  LazyContext() : sax(alloc) {}
+  LazyContext(const LazyContext&) = delete;
+  ~LazyContext() { std::free(json); }
+
+  // Parse the json of a container into node, with the children in raw.
+  ParseResult parseLazy(LazyNode& node, StringView raw) {
+    ParseResult ret = parser.ParseLazy(
+        reinterpret_cast<const uint8_t*>(raw.data()), raw.size(), sax);
+    if (!ret.Error()) {
+      std::memcpy(static_cast<void*>(&node),
+                  static_cast<void*>(sax.stack_.template Begin<LazyNode>()),
+                  sizeof(LazyNode));
+      if (node.IsContainer() && !node.Empty()) node.header()->ctx = this;
+    }
+    sax.stack_.Clear();
+    return ret;
+  }
+
+  // Parse a raw scalar into node, which is unchanged if failed.
+  ParseResult parseScalar(LazyNode& node, StringView raw) {
+    LazyNode val;
+    LazyNode::ScalarHandler handler(val);
+    ParseResult ret = parser.template Parse<kParseDefault>(
+        const_cast<char*>(raw.data()), raw.size(), handler);
+    if (!ret.Error()) {
+      std::memcpy(static_cast<void*>(&node), static_cast<void*>(&val),
+                  sizeof(LazyNode));
+    }
+    return ret;
+  }
+
+  // Expand the raw node, and keep it raw if the json is invalid.
+  sonic_force_inline void Expand(LazyNode& node) {
+    if (sonic_likely(!node.IsRaw())) return;
+    StringView raw = node.GetRaw();
+    if (raw[0] == '{' || raw[0] == '[') {
+      parseLazy(node, raw);
+    } else {
+      parseScalar(node, raw);
+    }
+  }
+
+  SONIC_DEFAULT_ALLOCATOR alloc{};
+  LazySAXHandler<LazyNode> sax;
+  Parser parser{};
+  // the copy of json with padding, which the raw nodes point into
+  char* json{nullptr};
+  LazyNode root{};
+};
+
+}  // namespace internal
+
+inline const LazyNode& LazyValueIterator::operator*() const noexcept {
+  ctx_->Expand(*p_);
+  return *p_;
+}
+
+inline const LazyMemberIterator::MemberNode& LazyMemberIterator::operator*()
+    const noexcept {
+  ctx_->Expand(p_->value);
+  return *p_;
+}
+
+inline const LazyNode* LazyValueIterator::operator->() const noexcept {
+  return &**this;
+}
+
+inline const LazyMemberIterator::MemberNode* LazyMemberIterator::operator->()
+    const noexcept {
+  return &**this;
+}
+
+inline LazyValueIterator& LazyValueIterator::operator++() noexcept {
+  p_++;
+  return *this;
+}
+
+inline LazyMemberIterator& LazyMemberIterator::operator++() noexcept {
+  p_++;
+  return *this;
+}
+
+}  // namespace sonic_json
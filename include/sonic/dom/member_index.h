@@ -0,0 +1,271 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "sonic/internal/arch/simd_member.h"
+#include "sonic/internal/utils.h"
+#include "sonic/macro.h"
+#include "sonic/string_view.h"
+
+namespace sonic_json {
+namespace internal {
+
+// MemberIndex maps the keys of an object to the positions of its members. It
+// is an open addressing table with linear probing, in one block of a header
+// and two parallel arrays: the key hashes and the member positions. The keys
+// are hashed once, and a probe compares the hash before the member's key.
+// The same keys are kept in the order they are added, so Find returns the
+// first added one.
+template <typename Allocator>
+class MemberIndex {
+ public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  // The hash of key, and 0 is reserved for the empty slots. It is seeded by
+  // the process, as the keys of the parsed json are not trusted.
+  static sonic_force_inline uint32_t Hash(StringView key) {
+    uint64_t h = HashBytes(key.data(), key.size(), HashSeed()) >> 32;
+    return h ? static_cast<uint32_t>(h) : 1;
+  }
+
+  // Create an index with room for n members, and return nullptr if there is
+  // no memory.
+  static MemberIndex* Create(size_t n, Allocator& alloc) {
+    size_t slots = kMinSlots;
+    while (n >= capacityOf(slots)) slots *= 2;
+    void* mem =
+        alloc.Malloc(sizeof(MemberIndex) + slots * 2 * sizeof(uint32_t));
+    if (!mem) return nullptr;
+    MemberIndex* index = new (mem) MemberIndex(slots);
+    std::memset(static_cast<void*>(index->hashes()), 0,
+                slots * sizeof(uint32_t));
+    return index;
+  }
+
+  // Create a larger index with the same members, and return nullptr if there
+  // is no memory. This index is kept.
+  MemberIndex* Grow(Allocator& alloc) const {
+    MemberIndex* index = Create(capacityOf(slots()), alloc);
+    if (!index) return nullptr;
+    // Start from an empty slot, so that the runs of slots are moved in their
+    // probe order, and the same keys keep their order.
+    size_t start = 0;
+    while (hashes()[start]) start++;
+    for (size_t i = 0; i < slots(); i++) {
+      size_t s = (start + i) & mask_;
+      if (hashes()[s]) index->Insert(hashes()[s], positions()[s]);
+    }
+    return index;
+  }
+
+  sonic_force_inline size_t Size() const { return size_; }
+
+  // The bytes of the whole block.
+  sonic_force_inline size_t ByteSize() const {
+    return sizeof(MemberIndex) + slots() * 2 * sizeof(uint32_t);
+  }
+
+  // Whether the load factor is too high to insert one more member.
+  sonic_force_inline bool Full() const {
+    return size_ >= capacityOf(slots());
+  }
+
+  sonic_force_inline void Insert(uint32_t hash, uint32_t pos) {
+    sonic_assert(!Full());
+    size_t s = hash & mask_;
+    while (hashes()[s]) s = (s + 1) & mask_;
+    hashes()[s] = hash;
+    positions()[s] = pos;
+    size_++;
+  }
+
+  // Return the position of the member whose name equals key, or kNotFound.
+  template <typename Member>
+  sonic_force_inline uint32_t Find(StringView key, uint32_t hash,
+                                   const Member* members) const {
+    size_t s = findSlot(key, hash, members);
+    return s == kNoSlot ? kNotFound : positions()[s];
+  }
+
+  // Remove the member whose name equals key, and return its position or
+  // kNotFound.
+  template <typename Member>
+  uint32_t Erase(StringView key, uint32_t hash, const Member* members) {
+    size_t s = findSlot(key, hash, members);
+    if (s == kNoSlot) return kNotFound;
+    uint32_t pos = positions()[s];
+    eraseSlot(s);
+    return pos;
+  }
+
+  // The member of hash is moved from one position to another.
+  void Move(uint32_t hash, uint32_t from, uint32_t to) {
+    for (size_t s = hash & mask_; hashes()[s]; s = (s + 1) & mask_) {
+      if (hashes()[s] == hash && positions()[s] == from) {
+        positions()[s] = to;
+        return;
+      }
+    }
+    sonic_assert(false);
+  }
+
+ private:
+  static constexpr size_t kMinSlots = 16;
+  static constexpr size_t kNoSlot = SIZE_MAX;
+
+  explicit MemberIndex(size_t slots)
+      : mask_(static_cast<uint32_t>(slots - 1)), size_(0) {}
+
+  // The max load factor is 3/4.
+  static sonic_force_inline size_t capacityOf(size_t slots) {
+    return slots / 4 * 3;
+  }
+
+  sonic_force_inline size_t slots() const { return size_t(mask_) + 1; }
+
+  sonic_force_inline uint32_t* hashes() const {
+    return reinterpret_cast<uint32_t*>(const_cast<MemberIndex*>(this) + 1);
+  }
+
+  sonic_force_inline uint32_t* positions() const { return hashes() + slots(); }
+
+  template <typename Member>
+  sonic_force_inline size_t findSlot(StringView key, uint32_t hash,
+                                     const Member* members) const {
+    for (size_t s = hash & mask_; hashes()[s]; s = (s + 1) & mask_) {
+      if (hashes()[s] != hash) continue;
+      StringView name = members[positions()[s]].name.GetStringView();
+      if (name.size() == key.size() &&
+          (name.data() == key.data() ||
+           std::memcmp(name.data(), key.data(), key.size()) == 0)) {
+        return s;
+      }
+    }
+    return kNoSlot;
+  }
+
+  // Remove the slot and shift the following slots of the run backward, so
+  // that no tombstones are left.
+  void eraseSlot(size_t hole) {
+    for (size_t s = (hole + 1) & mask_; hashes()[s]; s = (s + 1) & mask_) {
+      size_t home = hashes()[s] & mask_;
+      // the slot can move to the hole if its home is not after the hole
+      if (((s - home) & mask_) >= ((s - hole) & mask_)) {
+        hashes()[hole] = hashes()[s];
+        positions()[hole] = positions()[s];
+        hole = s;
+      }
+    }
+    hashes()[hole] = 0;
+    size_--;
+  }
+
+  uint32_t mask_;
+  uint32_t size_;
+};
+
+// KeyTags is a side array of the member key tags, which pack the length and
+// the first bytes of each key into 64 bits. FindTag compares 8 tags at a time
+// with SIMD, and only the members with the same tag compare the key bytes. It
+// is for the objects that are too small for a MemberIndex.
+template <typename Allocator>
+class KeyTags {
+ public:
+  // The tag is the first 8 bytes of key xor its length, the shorter keys are
+  // packed without reading past the end.
+  static sonic_force_inline uint64_t Tag(StringView key) {
+    const char* s = key.data();
+    size_t n = key.size();
+    uint64_t v;
+    if (n >= 8) {
+      std::memcpy(&v, s, 8);
+    } else if (n >= 4) {
+      uint32_t lo, hi;
+      std::memcpy(&lo, s, 4);
+      std::memcpy(&hi, s + n - 4, 4);
+      v = lo | (uint64_t(hi) << 32);
+    } else if (n > 0) {
+      v = uint8_t(s[0]) | (uint64_t(uint8_t(s[n >> 1])) << 8) |
+          (uint64_t(uint8_t(s[n - 1])) << 16);
+    } else {
+      v = 0;
+    }
+    return v ^ (uint64_t(n) << 56);
+  }
+
+  // Create the tags of the n members, and return nullptr if there is no
+  // memory. The tags are padded to a multiple of 8 for FindTag.
+  template <typename Member>
+  static KeyTags* Create(const Member* members, size_t n, Allocator& alloc) {
+    size_t cap = (n + 7) & ~size_t(7);
+    void* mem = alloc.Malloc(sizeof(KeyTags) + cap * sizeof(uint64_t));
+    if (!mem) return nullptr;
+    KeyTags* tags = new (mem) KeyTags(cap);
+    for (size_t i = 0; i < n; i++) {
+      tags->tags()[i] = Tag(members[i].name.GetStringView());
+    }
+    for (size_t i = n; i < cap; i++) tags->tags()[i] = 0;
+    return tags;
+  }
+
+  // Return the position of the first of n members whose name equals key, or
+  // n if not found.
+  template <typename Member>
+  sonic_force_inline size_t Find(StringView key, const Member* members,
+                                 size_t n) const {
+    uint64_t tag = Tag(key);
+    for (size_t i = FindTag(tags(), 0, n, tag); i < n;
+         i = FindTag(tags(), i + 1, n, tag)) {
+      StringView name = members[i].name.GetStringView();
+      if (name.size() == key.size() &&
+          (name.data() == key.data() ||
+           std::memcmp(name.data(), key.data(), key.size()) == 0)) {
+        return i;
+      }
+    }
+    return n;
+  }
+
+  // Set the tag of a member added at pos, and return false if it is full.
+  sonic_force_inline bool Add(size_t pos, StringView key) {
+    if (pos >= cap_) return false;
+    tags()[pos] = Tag(key);
+    return true;
+  }
+
+  // The member is moved from one position to another.
+  sonic_force_inline void Move(size_t from, size_t to) {
+    tags()[to] = tags()[from];
+  }
+
+ private:
+  explicit KeyTags(size_t cap) : cap_(cap) {}
+
+  sonic_force_inline uint64_t* tags() const {
+    return reinterpret_cast<uint64_t*>(const_cast<KeyTags*>(this) + 1);
+  }
+
+  size_t cap_;
+};
+
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sonic/allocator.h"
+#include "sonic/dom/handler.h"
+#include "sonic/dom/parser.h"
+#include "sonic/internal/arch/simd_skip.h"
+
+namespace sonic_json {
+namespace internal {
+
+// Split the elements of the top-level array into groups of at least `target`
+// bytes. The group is the range between '[' or ',' and the next ',' or ']'.
+// Returns false if the json doesn't look like an array, and the caller should
+// parse it as usual to get the exact error.
+inline bool SplitArray(const uint8_t* data, size_t len, size_t target,
+                       std::vector<std::pair<size_t, size_t>>& groups) {
+  SkipScanner scan;
+  size_t pos = 0;
+  if (scan.SkipSpaceSafe(data, pos, len) != '[') return false;
+  size_t start = pos;
+  while (true) {
+    if (scan.SkipOne(data, pos, len) < 0) return false;
+    uint8_t c = scan.SkipSpaceSafe(data, pos, len);
+    if (c == ',') {
+      if (pos - start >= target) {
+        groups.emplace_back(start, pos - 1);
+        start = pos;
+      }
+      continue;
+    }
+    if (c != ']') return false;
+    groups.emplace_back(start, pos - 1);
+    break;
+  }
+  for (; pos < len; pos++) {
+    if (!IsSpace(data[pos])) return false;
+  }
+  return true;
+}
+
+// Merge the memory of worker allocators, only pool allocators are supported.
+template <typename Allocator>
+sonic_force_inline void AbsorbAllocator(Allocator&, Allocator&) {}
+
+template <typename BaseAllocator, typename ChunkPolicy>
+sonic_force_inline void AbsorbAllocator(
+    MemoryPoolAllocator<BaseAllocator, ChunkPolicy>& dst,
+    MemoryPoolAllocator<BaseAllocator, ChunkPolicy>& src) {
+  dst.Absorb(src);
+}
+
+/**
+ * @brief ParallelArrayParser parses a huge top-level array on multiple
+ * threads. The elements are split into groups at depth 1, and each group is
+ * parsed as a small array by a worker with its own allocator. Then the
+ * elements are moved into the root array without deep copy, and the worker
+ * allocators are absorbed into the document allocator.
+ */
+template <typename NodeType>
+class ParallelArrayParser {
+ public:
+  using Allocator = typename NodeType::AllocatorType;
+
+  // The groups are small enough to balance the workers, and large enough to
+  // make the setup cost of each group negligible.
+  constexpr static size_t kMinGroupSize = 64 * 1024;
+  constexpr static size_t kGroupsPerThread = 4;
+
+  /**
+   * @brief Parse json into root. Returns false if it is not parsed, because
+   * the json is small or invalid, or the allocator can't merge memory.
+   * @param map_threshold the objects with more members get a map, SIZE_MAX
+   * if kParseCreateMap is not set.
+   */
+  template <unsigned parseFlags>
+  static bool Parse(StringView json, size_t threads, NodeType& root,
+                    Allocator& alloc, size_t map_threshold = SIZE_MAX) {
+    if (Allocator::kNeedFree) return false;
+    if (!threads) threads = std::thread::hardware_concurrency();
+    if (threads < 2) return false;
+
+    size_t target = json.size() / (threads * kGroupsPerThread);
+    if (target < kMinGroupSize) target = kMinGroupSize;
+    std::vector<std::pair<size_t, size_t>> groups;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+    if (!SplitArray(data, json.size(), target, groups) || groups.size() < 2) {
+      return false;
+    }
+    if (threads > groups.size()) threads = groups.size();
+
+    std::vector<std::unique_ptr<Allocator>> allocs;
+    for (size_t i = 0; i < threads; i++) {
+      allocs.emplace_back(new Allocator());
+    }
+    std::vector<NodeType> parts(groups.size());
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto work = [&](size_t w) {
+      Parser p;
+      RootHandler sax(*allocs[w]);
+      size_t g;
+      while (!failed && (g = next.fetch_add(1)) < groups.size()) {
+        if (!parseGroup<parseFlags>(json, groups[g], map_threshold, p, sax,
+                                    parts[g])) {
+          failed = true;
+        }
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < threads; w++) workers.emplace_back(work, w);
+    work(0);
+    for (auto& t : workers) t.join();
+    if (failed) return false;
+
+    size_t total = 0;
+    for (auto& part : parts) total += part.Size();
+    // A group of numbers is packed with kParsePackNumbers. The root starts
+    // from the first group as it is, and the elements of the others are
+    // pushed back, so the root is unpacked at the first element that can't be
+    // packed with the others, the same as Parse.
+    size_t first = 0;
+    if (parts[0].IsPackedArray()) {
+      root = std::move(parts[0]);
+      first = 1;
+    } else {
+      root.SetArray();
+    }
+    root.Reserve(total, alloc);
+    for (size_t i = first; i < parts.size(); i++) {
+      NodeType& part = parts[i].Unpack(alloc);
+      for (auto it = part.Begin(), e = part.End(); it != e; ++it) {
+        root.PushBack(std::move(*it), alloc);
+      }
+    }
+    for (auto& a : allocs) AbsorbAllocator(alloc, *a);
+    return true;
+  }
+
+ private:
+  // Expose the parsed root node.
+  class RootHandler : public SAXHandler<NodeType> {
+   public:
+    RootHandler(Allocator& alloc) : SAXHandler<NodeType>(alloc) {}
+    NodeType& Root() { return this->st_[0]; }
+    void SetOptions(size_t map_threshold, bool pack_numbers) {
+      this->map_threshold_ = map_threshold;
+      this->pack_numbers_ = pack_numbers;
+    }
+    Allocator& Alloc() { return *this->alloc_; }
+  };
+
+  // Parse the group as an array, the strings are kept in the buffer from the
+  // worker allocator.
+  template <unsigned parseFlags>
+  static bool parseGroup(StringView json, std::pair<size_t, size_t> group,
+                         size_t map_threshold, Parser& p, RootHandler& sax,
+                         NodeType& part) {
+    size_t len = group.second - group.first + 2;
+    char* buf =
+        static_cast<char*>(sax.Alloc().Malloc(len + SONICJSON_PADDING));
+    if (!buf) return false;
+    buf[0] = '[';
+    std::memcpy(buf + 1, json.data() + group.first, len - 2);
+    buf[len - 1] = ']';
+    buf[len] = 'x';
+    buf[len + 1] = '"';
+    buf[len + 2] = 'x';
+    sax.SetOptions(map_threshold, (parseFlags & kParsePackNumbers) != 0);
+    if (!sax.SetUp(StringView(buf, len))) return false;
+    if (p.template Parse<parseFlags>(buf, len, sax).Error()) return false;
+    part = std::move(sax.Root());
+    return true;
+  }
+};
+
+}  // namespace internal
+}  // namespace sonic_json
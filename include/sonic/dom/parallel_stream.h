@@ -0,0 +1,271 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sonic/dom/document_stream.h"
+
+namespace sonic_json {
+
+namespace internal {
+
+// The shard allocator holds all records of a shard, so it uses a large chunk,
+// which is reused for the later shards.
+template <typename Allocator>
+struct ShardAllocator {
+  static Allocator* New(size_t) { return new Allocator(); }
+};
+
+template <typename BaseAllocator, typename ChunkPolicy>
+struct ShardAllocator<MemoryPoolAllocator<BaseAllocator, ChunkPolicy>> {
+  using Allocator = MemoryPoolAllocator<BaseAllocator, ChunkPolicy>;
+  static Allocator* New(size_t chunk) { return new Allocator(chunk); }
+};
+
+}  // namespace internal
+
+struct ParallelOptions {
+  size_t threads = 0;           ///< worker threads, 0 means all cores.
+  size_t shard_size = 1 << 20;  ///< the bytes of each shard.
+  bool ordered = false;         ///< call back in the record order or not.
+  size_t window = 0;  ///< max shards kept for ordering, 0 means 4 * threads.
+};
+
+/**
+ * @brief GenericParallelDocumentStream parses the newline-delimited jsons on
+ * multiple threads. The buffer is split into newline-aligned shards, and the
+ * shards are parsed by the workers, which steal shards from each other when
+ * their own are done. Every worker has its own parser and allocators, so they
+ * share nothing when parsing.
+ *
+ * The callback is called as cb(offset, doc) for each record, where offset is
+ * the record offset in the buffer and doc is the parsed document. Check the
+ * parse error of doc before using it. The doc is only valid in the callback.
+ *
+ * If not ordered, the callback is called in any order and concurrently from
+ * the workers. If ordered, the callback is called one by one in the record
+ * order, and the parsed shards wait in a bounded window until the previous
+ * ones are handed out.
+ */
+template <typename NodeType>
+class GenericParallelDocumentStream {
+ public:
+  using DocType = GenericDocument<NodeType>;
+  using Allocator = typename NodeType::AllocatorType;
+
+  explicit GenericParallelDocumentStream(
+      const ParallelOptions& opts = ParallelOptions())
+      : opts_(opts) {
+    if (!opts_.threads) opts_.threads = std::thread::hardware_concurrency();
+    if (!opts_.threads) opts_.threads = 1;
+    if (!opts_.shard_size) opts_.shard_size = 1;
+    if (!opts_.window) opts_.window = 4 * opts_.threads;
+  }
+
+  GenericParallelDocumentStream(const GenericParallelDocumentStream&) = delete;
+  GenericParallelDocumentStream& operator=(
+      const GenericParallelDocumentStream&) = delete;
+
+  /**
+   * @brief Parse all records in json, and return after all callbacks are
+   * done.
+   */
+  template <unsigned parseFlags = kParseDefault, typename Callback>
+  void Parse(StringView json, Callback&& cb) {
+    json_ = json;
+    splitShards();
+    size_t nthreads = opts_.threads;
+    if (nthreads > shards_.size()) nthreads = shards_.size();
+    if (!nthreads) return;
+
+    // Shards are dealt round-robin, so that the workers go forward together
+    // and the ordering window is seldom full.
+    queues_ = std::vector<WorkQueue>(nthreads);
+    for (size_t i = 0; i < shards_.size(); i++) {
+      queues_[i % nthreads].shards.push_back(i);
+    }
+    ready_.clear();
+    ready_.resize(shards_.size());
+    next_ = 0;
+    delivering_ = false;
+
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < nthreads; w++) {
+      workers.emplace_back([this, w, &cb] { work<parseFlags>(w, cb); });
+    }
+    work<parseFlags>(0, cb);
+    for (auto& t : workers) t.join();
+  }
+
+ private:
+  struct Shard {
+    size_t start;
+    size_t end;
+  };
+
+  struct WorkQueue {
+    std::mutex mu;
+    std::deque<size_t> shards;
+  };
+
+  // The parsed records of a shard in ordered mode. The documents share the
+  // shard allocator, and are released together after handed out. The results
+  // are recycled, because touching new memory for every shard is slow.
+  struct ShardResult {
+    explicit ShardResult(size_t chunk)
+        : alloc(internal::ShardAllocator<Allocator>::New(chunk)) {}
+    std::unique_ptr<Allocator> alloc;
+    std::deque<DocType> docs;
+    std::vector<size_t> offsets;
+  };
+
+  void splitShards() {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(json_.data());
+    size_t len = json_.size();
+    shards_.clear();
+    size_t start = 0;
+    while (start < len) {
+      size_t end = start + opts_.shard_size;
+      if (end >= len) {
+        end = len;
+      } else {
+        internal::GetNextToken(data, end, len, "\n");
+        if (end < len) end++;
+      }
+      shards_.push_back(Shard{start, end});
+      start = end;
+    }
+  }
+
+  // Take the front shard of its own queue, or steal the back shard of others.
+  // In ordered mode the front shard is stolen too, because a back shard is
+  // far beyond the ordering window, and the thief would only wait for it.
+  bool popShard(size_t w, size_t& shard) {
+    size_t n = queues_.size();
+    for (size_t i = 0; i < n; i++) {
+      WorkQueue& q = queues_[(w + i) % n];
+      std::lock_guard<std::mutex> lk(q.mu);
+      if (q.shards.empty()) continue;
+      if (i == 0 || opts_.ordered) {
+        shard = q.shards.front();
+        q.shards.pop_front();
+      } else {
+        shard = q.shards.back();
+        q.shards.pop_back();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  template <unsigned parseFlags, typename Callback>
+  void work(size_t w, Callback& cb) {
+    Parser parser;
+    // the per-worker document for unordered mode, reused between records
+    DocType doc;
+    SAXHandler<NodeType> sax(doc.GetAllocator());
+    size_t shard;
+    while (popShard(w, shard)) {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(json_.data());
+      size_t pos = shards_[shard].start, end = shards_[shard].end;
+      size_t rs, re;
+      if (!opts_.ordered) {
+        while (internal::NextRecord(data, pos, end, rs, re)) {
+          doc.destroyDom();
+          internal::RewindAllocator(doc.GetAllocator());
+          doc.template parseImpl<parseFlags>(json_.data() + rs, re - rs,
+                                             parser, sax);
+          cb(rs, doc);
+        }
+        continue;
+      }
+
+      std::unique_ptr<ShardResult> res = waitWindow(shard);
+      SAXHandler<NodeType> shard_sax(*res->alloc);
+      while (internal::NextRecord(data, pos, end, rs, re)) {
+        res->docs.emplace_back(res->alloc.get());
+        res->offsets.push_back(rs);
+        res->docs.back().template parseImpl<parseFlags>(
+            json_.data() + rs, re - rs, parser, shard_sax);
+      }
+      deliver(shard, std::move(res), cb);
+    }
+  }
+
+  // Wait until the shard is in the ordering window, and get a free result.
+  std::unique_ptr<ShardResult> waitWindow(size_t shard) {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [&] { return shard < next_ + opts_.window; });
+    if (free_.empty()) {
+      lk.unlock();
+      return std::unique_ptr<ShardResult>(
+          new ShardResult(2 * opts_.shard_size));
+    }
+    std::unique_ptr<ShardResult> res = std::move(free_.back());
+    free_.pop_back();
+    return res;
+  }
+
+  // Hand out the parsed shards in order. Only one thread calls the callback
+  // at a time, and the others just leave their shards in ready_.
+  template <typename Callback>
+  void deliver(size_t shard, std::unique_ptr<ShardResult> res, Callback& cb) {
+    std::unique_lock<std::mutex> lk(mu_);
+    ready_[shard] = std::move(res);
+    if (delivering_) return;
+    delivering_ = true;
+    while (next_ < ready_.size() && ready_[next_]) {
+      std::unique_ptr<ShardResult> cur = std::move(ready_[next_]);
+      lk.unlock();
+      for (size_t i = 0; i < cur->docs.size(); i++) {
+        cb(cur->offsets[i], cur->docs[i]);
+      }
+      cur->docs.clear();
+      cur->offsets.clear();
+      internal::RewindAllocator(*cur->alloc);
+      lk.lock();
+      free_.push_back(std::move(cur));
+      next_++;
+      cv_.notify_all();
+    }
+    delivering_ = false;
+  }
+
+  ParallelOptions opts_;
+  StringView json_;
+  std::vector<Shard> shards_;
+  std::vector<WorkQueue> queues_;
+
+  // states for the ordered mode
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::vector<std::unique_ptr<ShardResult>> ready_;
+  std::vector<std::unique_ptr<ShardResult>> free_;
+  size_t next_{0};
+  bool delivering_{false};
+};
+
+using ParallelDocumentStream =
+    GenericParallelDocumentStream<DNode<SONIC_DEFAULT_ALLOCATOR>>;
+
+}  // namespace sonic_json
@@ -18,6 +18,7 @@
 
 #include <climits>
 #include <cstring>
+#include <type_traits>
 #include <vector>
 
 #include "sonic/dom/flags.h"
@@ -26,6 +27,7 @@
 #include "sonic/error.h"
 #include "sonic/internal/arch/simd_quote.h"
 #include "sonic/internal/arch/simd_skip.h"
+#include "sonic/internal/arch/simd_structural.h"
 #include "sonic/internal/arch/simd_str2int.h"
 #include "sonic/internal/atof_native.h"
 #include "sonic/internal/parse_number_normal_fast.h"
@@ -52,6 +54,31 @@ ParseResult GetOnDemand(StringView json,
   return ParseResult(kErrorNone, pos);
 }
 
+// GetOnDemandMulti get the raw json fields of all paths in the trie with one
+// pass of the json. targets[i] is the field of the i-th path, or empty if not
+// found. The error is only returned for the invalid json that is scanned.
+template <typename JPStringType>
+ParseResult GetOnDemandMulti(StringView json,
+                             const GenericJsonPointerTrie<JPStringType> &trie,
+                             std::vector<StringView> &targets) {
+  internal::SkipScanner scan;
+  size_t pos = 0;
+  targets.assign(trie.Size(), StringView());
+  SonicError err = scan.GetOnDemandMulti(json, pos, trie, targets.data());
+  if (err) {
+    targets.assign(trie.Size(), StringView());
+  }
+  return ParseResult(err, pos);
+}
+
+template <typename JPStringType = SONIC_JSON_POINTER_NODE_STRING_DEFAULT_TYPE>
+ParseResult GetOnDemandMulti(
+    StringView json, const std::vector<GenericJsonPointer<JPStringType>> &paths,
+    std::vector<StringView> &targets) {
+  return GetOnDemandMulti(json, GenericJsonPointerTrie<JPStringType>(paths),
+                          targets);
+}
+
 class Parser {
  public:
   explicit Parser() noexcept = default;
@@ -67,7 +94,11 @@ class Parser {
     reset();
     json_buf_ = reinterpret_cast<uint8_t *>(data);
     len_ = len;
-    parseImpl<parseFlags>(sax);
+    if ((parseFlags & kParseTwoStage) && structural_.Index(json_buf_, len_)) {
+      parseImpl<parseFlags>(sax, structural_);
+    } else {
+      parseImpl<parseFlags>(sax, scan);
+    }
     if (!err_ && hasTrailingChars()) {
       err_ = kParseErrorInvalidChar;
     }
@@ -79,6 +110,7 @@ class Parser {
   template <typename LazySAX>
   sonic_force_inline ParseResult ParseLazy(const uint8_t *data, size_t len,
                                            LazySAX &sax) {
+    reset();
     return parseLazyImpl(data, len, sax);
   }
 
@@ -124,19 +156,38 @@ class Parser {
     setParseError(kParseErrorInvalidChar);
   }
 
-  template <typename SAX>
+  template <unsigned parseFlags, bool isKey = false, typename SAX>
   sonic_force_inline void parseStrInPlace(SAX &sax) {
     uint8_t *src = json_buf_ + pos_;
     uint8_t *sdst = src;
-    size_t n = internal::parseStringInplace(src, err_);
+    size_t n = (parseFlags & kParseValidateUtf8)
+                   ? internal::parseStringInplaceUtf8(src, err_)
+                   : internal::parseStringInplace(src, err_);
     pos_ = src - json_buf_;
-    if (!sax.String(StringView(reinterpret_cast<char *>(sdst), n))) {
+    StringView s(reinterpret_cast<char *>(sdst), n);
+    // the keys are passed to sax.Key only when interning them, so the SAX
+    // handlers without Key still work.
+    using InternKey =
+        std::integral_constant<bool, isKey && (parseFlags & kParseInternKeys)>;
+    if (!addString(sax, s, InternKey())) {
       setParseError(kParseErrorInvalidChar);
       return;
     }
     return;
   }
 
+  template <typename SAX>
+  sonic_force_inline static bool addString(SAX &sax, StringView s,
+                                           std::true_type) {
+    return sax.Key(s);
+  }
+
+  template <typename SAX>
+  sonic_force_inline static bool addString(SAX &sax, StringView s,
+                                           std::false_type) {
+    return sax.String(s);
+  }
+
   sonic_force_inline bool carry_one(char c, uint64_t &sum) const {
     uint8_t d = static_cast<uint8_t>(c - '0');
     if (d > 9) {
@@ -464,7 +515,7 @@ class Parser {
 #undef CHECK_DIGIT
   }
 
-  template <typename SAX>
+  template <unsigned parseFlags, typename SAX>
   void parsePrimitives(SAX &sax) {
     switch (json_buf_[pos_ - 1]) {
       case '0':
@@ -481,7 +532,7 @@ class Parser {
         parseNumber(sax);
         break;
       case '"':
-        parseStrInPlace(sax);
+        parseStrInPlace<parseFlags>(sax);
         break;
       case 'f':
         parseFalse(sax);
@@ -497,16 +548,20 @@ class Parser {
     }
   }
 
-  template <unsigned parseFlags, typename SAX>
-  sonic_force_inline void parseImpl(SAX &sax) {
+  // parseImpl is driven by Scanner, which returns the next token through
+  // SkipSpace. Scanner is either SkipScanner that skips the spaces on the fly,
+  // or StructuralScanner that indexes the whole json in advance.
+  template <unsigned parseFlags, typename SAX, typename Scanner>
+  sonic_force_inline void parseImpl(SAX &sax, Scanner &scan) {
 #define sonic_check_err()   \
   if (err_ != kErrorNone) { \
     goto err_invalid_char;  \
   }
 
     using namespace sonic_json::internal;
-    // TODO (liuq19): vector is a temporary choice, will optimize in future.
-    std::vector<uint32_t> depth;
+    // the depth stack is a member, so it is reused if the parser is reused
+    std::vector<uint32_t> &depth = depth_;
+    depth.clear();
     const uint32_t kArrMask = 1ull << 31;
     const uint32_t kObjMask = 0;
 
@@ -533,13 +588,13 @@ class Parser {
         goto obj_key;
       }
       default:
-        parsePrimitives(sax);
+        parsePrimitives<parseFlags>(sax);
         goto doc_end;
     };
 
   obj_key:
     if (sonic_unlikely(c != '"')) goto err_invalid_char;
-    parseStrInPlace(sax);
+    parseStrInPlace<parseFlags, true>(sax);
     sonic_check_err();
     c = scan.SkipSpace(json_buf_, pos_);
     if (sonic_unlikely(c != ':')) goto err_invalid_char;
@@ -593,7 +648,7 @@ class Parser {
         sonic_check_err();
         break;
       case '"':
-        parseStrInPlace(sax);
+        parseStrInPlace<parseFlags>(sax);
         sonic_check_err();
         break;
       default:
@@ -673,7 +728,7 @@ class Parser {
         sonic_check_err();
         break;
       case '"':
-        parseStrInPlace(sax);
+        parseStrInPlace<parseFlags>(sax);
         sonic_check_err();
         break;
       default:
@@ -696,7 +751,8 @@ class Parser {
   doc_end:
     return;
   err_invalid_char:
-    err_ = kParseErrorInvalidChar;
+    // keep the error from parsing the value, such as the invalid utf-8.
+    if (err_ == kErrorNone) err_ = kParseErrorInvalidChar;
     return;
   }
 
@@ -763,9 +819,9 @@ class Parser {
     }
     if (skips == 2) {
       // parse escaped strings
-      uint8_t *dst = (uint8_t *)alloc.Malloc(sn + 32);
+      uint8_t *dst = (uint8_t *)alloc.Malloc(sn + SONICJSON_PADDING);
       sdst = dst;
-      std::memcpy(dst, src, sn);
+      std::memcpy(dst, src, sn + 1);  // with the ending quote
       sn = internal::parseStringInplace(dst, err);
       if (err) {
         // update the error positions
@@ -826,6 +882,8 @@ class Parser {
     pos_ = 0;
     err_ = kErrorNone;
     len_ = 0;
+    // the cached bitmap is stale if the parser is reused
+    scan = internal::SkipScanner();
   };
   constexpr static size_t kJsonPaddingSize = SONICJSON_PADDING;
 
@@ -834,6 +892,8 @@ class Parser {
   size_t pos_{0};
   SonicError err_{kErrorNone};
   internal::SkipScanner scan{};
+  internal::StructuralScanner structural_{};
+  std::vector<uint32_t> depth_{};
 };
 
 }  // namespace sonic_json
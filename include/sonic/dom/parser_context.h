@@ -0,0 +1,50 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "sonic/dom/handler.h"
+#include "sonic/dom/parser.h"
+
+namespace sonic_json {
+
+template <typename NodeType>
+class GenericDocument;
+
+/**
+ * @brief GenericParserContext keeps the parser, with its depth stack, and the
+ * node stack between GenericDocument::Parse calls, so that parsing many small
+ * jsons does not allocate them every time.
+ *
+ * The strings are still copied into the document, so the document does not
+ * depend on the context after parsing. A context must not be used by multiple
+ * threads at the same time.
+ */
+template <typename NodeType>
+class GenericParserContext {
+ public:
+  GenericParserContext() = default;
+  GenericParserContext(const GenericParserContext&) = delete;
+  GenericParserContext& operator=(const GenericParserContext&) = delete;
+
+ private:
+  friend class GenericDocument<NodeType>;
+
+  Parser parser_{};
+  SAXHandler<NodeType> sax_{};
+};
+
+}  // namespace sonic_json
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "sonic/dom/flags.h"
+#include "sonic/error.h"
+#include "sonic/macro.h"
+#include "sonic/writebuffer.h"
+
+namespace sonic_json {
+
+/**
+ * @brief The common interface of the read-only documents, such as
+ * CompactDocument, TapeDocument and LazyDocument.
+ * @tparam Derived the document, which implements `rootImpl()` to return the
+ * root node, or nullptr if there is no parsed json.
+ * @tparam NodeType the node type of the document.
+ */
+template <typename Derived, typename NodeType>
+class ReadOnlyDocument {
+ public:
+  /**
+   * @brief Get the root node, which is null if the parsing failed.
+   */
+  sonic_force_inline const NodeType& GetRoot() const noexcept {
+    const NodeType* root = downCast()->rootImpl();
+    return root ? *root : nullNode();
+  }
+
+  template <unsigned serializeFlags = kSerializeDefault>
+  SonicError Serialize(WriteBuffer& wb) const {
+    return GetRoot().template Serialize<serializeFlags>(wb);
+  }
+
+  template <unsigned serializeFlags = kSerializeDefault>
+  std::string Dump() const {
+    return GetRoot().template Dump<serializeFlags>();
+  }
+
+  bool HasParseError() const { return parse_result_.Error() != kErrorNone; }
+
+  sonic_force_inline SonicError GetParseError() const {
+    return parse_result_.Error();
+  }
+
+  sonic_force_inline size_t GetErrorOffset() const {
+    return parse_result_.Offset();
+  }
+
+ protected:
+  ReadOnlyDocument() noexcept = default;
+  ReadOnlyDocument(const ReadOnlyDocument&) noexcept = default;
+  ReadOnlyDocument& operator=(const ReadOnlyDocument&) noexcept = default;
+  ~ReadOnlyDocument() = default;
+
+  ParseResult parse_result_{};
+
+ private:
+  static const NodeType& nullNode() noexcept {
+    static const NodeType kNullNode;
+    return kNullNode;
+  }
+
+  const Derived* downCast() const noexcept {
+    return static_cast<const Derived*>(this);
+  }
+};
+
+}  // namespace sonic_json
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "sonic/dom/flags.h"
 #include "sonic/dom/type.h"
 #include "sonic/error.h"
@@ -29,6 +31,48 @@ namespace sonic_json {
 
 namespace internal {
 
+// Whether the nodes may be packed arrays of kParsePackNumbers. The node types
+// that specialize it as true provide GetPackedDoubles and GetPackedInt64s.
+template <typename NodeType>
+struct HasPackedArrays : std::false_type {};
+
+// Write a packed array and the ending ',', and return false if there is an
+// infinity or nan.
+template <typename NodeType>
+sonic_force_inline bool serializePacked(const NodeType* node, WriteBuffer& wb,
+                                        std::true_type) {
+  constexpr size_t kNumberSize = 33;
+  size_t count = node->Size();
+  wb.Grow(count * kNumberSize + 3);
+  wb.PushUnsafe<char>('[');
+  if (node->GetType() == kPackedReal) {
+    const double* vals = node->GetPackedDoubles();
+    for (size_t i = 0; i < count; i++) {
+      int rn = F64toa(wb.End<char>(), vals[i]);
+      if (rn <= 0) return false;
+      wb.PushSizeUnsafe<char>(rn);
+      wb.PushUnsafe<char>(',');
+    }
+  } else {
+    const int64_t* vals = node->GetPackedInt64s();
+    for (size_t i = 0; i < count; i++) {
+      char* end = I64toa(wb.End<char>(), vals[i]);
+      wb.PushSizeUnsafe<char>(end - wb.End<char>());
+      wb.PushUnsafe<char>(',');
+    }
+  }
+  if (count) wb.Pop<char>(1);
+  wb.PushUnsafe<char>(']');
+  wb.PushUnsafe<char>(',');
+  return true;
+}
+
+template <typename NodeType>
+sonic_force_inline bool serializePacked(const NodeType*, WriteBuffer&,
+                                        std::false_type) {
+  return true;
+}
+
 template <unsigned serializeFlags, typename NodeType>
 sonic_force_inline SonicError SerializeImpl(const NodeType* node,
                                             WriteBuffer& wb) {
@@ -57,7 +101,10 @@ sonic_force_inline SonicError SerializeImpl(const NodeType* node,
   wb.Clear();
   wb.Reserve(estimate);
 
-  bool is_single = (!node->IsContainer()) || node->Empty();
+  // a packed array is written at once, as the numbers are not nodes
+  using has_packed = HasPackedArrays<NodeType>;
+  bool is_single = (!node->IsContainer()) || node->Empty() ||
+                   (has_packed::value && node->IsPackedArray());
   if (sonic_unlikely(is_single)) {
     val_cnt = 1;
     goto val_begin;
@@ -117,6 +164,10 @@ val_begin:
     }
     case kObject:
     case kArray: {
+      if (sonic_unlikely(has_packed::value && node->IsPackedArray())) {
+        if (!serializePacked(node, wb, has_packed())) goto inf_err;
+        break;
+      }
       wb.Grow(3);
       is_obj_nxt = node->IsObject();
       val_cnt_nxt = node->Size();
@@ -0,0 +1,355 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include "sonic/dom/handler.h"
+#include "sonic/dom/parser.h"
+#include "sonic/internal/stack.h"
+
+namespace sonic_json {
+
+/**
+ * @brief StreamingParser is a push-style parser. The json text is fed in
+ * successive chunks, and the parser keeps its states (the depth stack and the
+ * partial string or number) across the chunk boundaries. The SAX events are
+ * the same as Parser::Parse, so SAXHandler can be used to build the DOM.
+ *
+ * The string views passed to sax.Key and sax.String are only valid in the
+ * callback, because the chunk is not kept after Feed returns. The handler
+ * must copy them, as StreamSAXHandler does.
+ */
+class StreamingParser {
+ public:
+  StreamingParser() = default;
+  StreamingParser(const StreamingParser&) = delete;
+  StreamingParser& operator=(const StreamingParser&) = delete;
+  StreamingParser(StreamingParser&&) = default;
+  StreamingParser& operator=(StreamingParser&&) = default;
+
+  /**
+   * @brief Parse the next chunk of the json.
+   * @return the error and its offset in the whole json. If no error, the
+   * offset is the number of bytes fed so far.
+   */
+  template <unsigned parseFlags = kParseDefault, typename SAX>
+  ParseResult Feed(StringView chunk, SAX& sax) {
+    if (err_) return ParseResult(err_, err_pos_);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(chunk.data());
+    size_t len = chunk.size();
+    size_t pos = 0;
+    if (partial_ != kNoPartial) {
+      if (!resumeToken<parseFlags>(data, pos, len, sax)) goto done;
+    }
+    {
+      // The scanner caches the bitmap of the last block, which is stale for a
+      // new chunk.
+      internal::SkipScanner scan;
+      while (pos < len) {
+        uint8_t c = scan.SkipSpaceSafe(data, pos, len);
+        if (internal::IsSpace(c)) break;
+        if (!parseToken<parseFlags>(c, data, pos, len, sax)) goto done;
+      }
+    }
+  done:
+    offset_ += len;
+    if (err_) return ParseResult(err_, err_pos_);
+    return ParseResult(kErrorNone, offset_);
+  }
+
+  /**
+   * @brief Mark the end of the json, and complete the pending number or
+   * literal. Returns kParseErrorEof if the json is truncated.
+   */
+  template <unsigned parseFlags = kParseDefault, typename SAX>
+  ParseResult Finish(SAX& sax) {
+    if (err_) return ParseResult(err_, err_pos_);
+    if (partial_ == kPartialScalar) {
+      if (!emitToken<parseFlags>(sax)) return ParseResult(err_, err_pos_);
+    }
+    if (partial_ != kNoPartial || state_ != kExpectEnd) {
+      setError(kParseErrorEof, offset_);
+      return ParseResult(err_, err_pos_);
+    }
+    return ParseResult(kErrorNone, offset_);
+  }
+
+  /**
+   * @brief Reset the parser to parse a new json. The buffers are kept.
+   */
+  void Reset() {
+    state_ = kExpectValue;
+    partial_ = kNoPartial;
+    err_ = kErrorNone;
+    err_pos_ = 0;
+    offset_ = 0;
+    tok_start_ = 0;
+    tok_.Clear();
+    depth_.Clear();
+  }
+
+ private:
+  enum State {
+    kExpectValue,        // at the beginning, or after ':', or ',' in array
+    kExpectValueOrEnd,   // after '['
+    kExpectKeyOrEnd,     // after '{'
+    kExpectKey,          // after ',' in object
+    kExpectColon,        // after key
+    kExpectCommaOrEnd,   // after value in container
+    kExpectEnd,          // after the root value
+  };
+
+  enum Partial {
+    kNoPartial,
+    kPartialString,
+    kPartialKey,
+    kPartialScalar,
+  };
+
+  constexpr static uint32_t kArrMask = 1u << 31;
+
+  // Tokens are tiny, indexing them ahead is useless.
+  constexpr static unsigned tokenFlags(unsigned flags) {
+    return flags & ~static_cast<unsigned>(kParseTwoStage);
+  }
+
+  static sonic_force_inline bool isScalarChar(uint8_t c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ||
+           c == '-' || c == '+' || c == '.';
+  }
+
+  sonic_force_inline void setError(SonicError err, size_t pos) {
+    err_ = err;
+    err_pos_ = pos;
+  }
+
+  // pos is after the first char c of the token.
+  template <unsigned parseFlags, typename SAX>
+  bool parseToken(uint8_t c, const uint8_t* data, size_t& pos, size_t len,
+                  SAX& sax) {
+    switch (state_) {
+      case kExpectValueOrEnd:
+        if (c == ']') return endContainer(pos, sax);
+        // fallthrough
+      case kExpectValue:
+        return parseValue<parseFlags>(c, data, pos, len, sax);
+      case kExpectKeyOrEnd:
+        if (c == '}') return endContainer(pos, sax);
+        // fallthrough
+      case kExpectKey:
+        if (c != '"') break;
+        return parseString<parseFlags>(data, pos, len, sax, kPartialKey);
+      case kExpectColon:
+        if (c != ':') break;
+        state_ = kExpectValue;
+        return true;
+      case kExpectCommaOrEnd: {
+        bool is_arr = *depth_.Top<uint32_t>() & kArrMask;
+        if (c == ',') {
+          state_ = is_arr ? kExpectValue : kExpectKey;
+          return true;
+        }
+        if (c == (is_arr ? ']' : '}')) return endContainer(pos, sax);
+        break;
+      }
+      case kExpectEnd:
+        break;
+    }
+    setError(kParseErrorInvalidChar, offset_ + pos - 1);
+    return false;
+  }
+
+  template <unsigned parseFlags, typename SAX>
+  bool parseValue(uint8_t c, const uint8_t* data, size_t& pos, size_t len,
+                  SAX& sax) {
+    switch (c) {
+      case '{':
+        if (!sax.StartObject()) goto nomem;
+        depth_.Push<uint32_t>(0);
+        state_ = kExpectKeyOrEnd;
+        return true;
+      case '[':
+        if (!sax.StartArray()) goto nomem;
+        depth_.Push<uint32_t>(kArrMask);
+        state_ = kExpectValueOrEnd;
+        return true;
+      case '"':
+        return parseString<parseFlags>(data, pos, len, sax, kPartialString);
+      default: {
+        if (!isScalarChar(c)) break;
+        size_t start = pos - 1;
+        while (pos < len && isScalarChar(data[pos])) pos++;
+        tok_.Clear();
+        tok_start_ = offset_ + start;
+        tok_.Push(reinterpret_cast<const char*>(data + start), pos - start);
+        partial_ = kPartialScalar;
+        // the number or literal may continue in the next chunk
+        if (pos == len) return true;
+        return emitToken<parseFlags>(sax);
+      }
+    }
+    setError(kParseErrorInvalidChar, offset_ + pos - 1);
+    return false;
+  nomem:
+    setError(kErrorNoMem, offset_ + pos - 1);
+    return false;
+  }
+
+  // pos is after the opening quote.
+  template <unsigned parseFlags, typename SAX>
+  bool parseString(const uint8_t* data, size_t& pos, size_t len, SAX& sax,
+                   Partial kind) {
+    size_t start = pos - 1;
+    tok_.Clear();
+    tok_start_ = offset_ + start;
+    partial_ = kind;
+    if (!internal::SkipString(data, pos, len)) {
+      tok_.Push(reinterpret_cast<const char*>(data + start), len - start);
+      pos = len;
+      return true;
+    }
+    tok_.Push(reinterpret_cast<const char*>(data + start), pos - start);
+    return emitToken<parseFlags>(sax);
+  }
+
+  // Continue the partial token of the last chunk. Returns false if the chunk
+  // is used up or has errors.
+  template <unsigned parseFlags, typename SAX>
+  bool resumeToken(const uint8_t* data, size_t& pos, size_t len, SAX& sax) {
+    if (partial_ == kPartialScalar) {
+      while (pos < len && isScalarChar(data[pos])) pos++;
+      tok_.Push(reinterpret_cast<const char*>(data), pos);
+      if (pos == len) return false;
+      return emitToken<parseFlags>(sax);
+    }
+
+    // The string is ended with an escaping backslash if the count of the
+    // trailing backslashes is odd, and then the first char is escaped.
+    const char* begin = tok_.Begin<char>();
+    const char* end = tok_.End<char>();
+    while (end > begin && *(end - 1) == '\\') end--;
+    if ((tok_.End<char>() - end) & 1) {
+      if (len == 0) return false;
+      pos = 1;
+    }
+    if (!internal::SkipString(data, pos, len)) {
+      tok_.Push(reinterpret_cast<const char*>(data), len);
+      pos = len;
+      return false;
+    }
+    tok_.Push(reinterpret_cast<const char*>(data), pos);
+    return emitToken<parseFlags>(sax);
+  }
+
+  // Parse the complete token in tok_, which is padded as the Parser expects.
+  template <unsigned parseFlags, typename SAX>
+  bool emitToken(SAX& sax) {
+    size_t n = tok_.Size();
+    tok_.Reserve(n + SONICJSON_PADDING);
+    char* buf = tok_.Begin<char>();
+    buf[n] = 'x';
+    buf[n + 1] = '"';
+    buf[n + 2] = 'x';
+    Partial kind = partial_;
+    partial_ = kNoPartial;
+    if (kind == kPartialScalar) {
+      // numbers and literals are parsed as a single json
+      ParseResult ret =
+          parser_.template Parse<tokenFlags(parseFlags)>(buf, n, sax);
+      if (ret.Error()) {
+        setError(ret.Error(), tok_start_ + ret.Offset());
+        return false;
+      }
+      return valueDone();
+    }
+
+    // the string token is quoted and has been closed
+    uint8_t* src = reinterpret_cast<uint8_t*>(buf) + 1;
+    SonicError err = kErrorNone;
+    size_t sn = internal::parseStringInplace(src, err);
+    if (err) {
+      setError(err, tok_start_ + (src - reinterpret_cast<uint8_t*>(buf)));
+      return false;
+    }
+    StringView str(buf + 1, sn);
+    if (kind == kPartialKey) {
+      if (!sax.Key(str)) goto nomem;
+      state_ = kExpectColon;
+      return true;
+    }
+    if (!sax.String(str)) goto nomem;
+    return valueDone();
+  nomem:
+    setError(kErrorNoMem, tok_start_);
+    return false;
+  }
+
+  template <typename SAX>
+  bool endContainer(size_t pos, SAX& sax) {
+    uint32_t top = *depth_.Top<uint32_t>();
+    depth_.Pop<uint32_t>(1);
+    bool ok = (top & kArrMask) ? sax.EndArray(top & ~kArrMask)
+                               : sax.EndObject(top);
+    if (!ok) {
+      setError(kErrorNoMem, offset_ + pos - 1);
+      return false;
+    }
+    return valueDone();
+  }
+
+  sonic_force_inline bool valueDone() {
+    if (depth_.Empty()) {
+      state_ = kExpectEnd;
+    } else {
+      (*depth_.Top<uint32_t>())++;
+      state_ = kExpectCommaOrEnd;
+    }
+    return true;
+  }
+
+  State state_{kExpectValue};
+  Partial partial_{kNoPartial};
+  SonicError err_{kErrorNone};
+  size_t err_pos_{0};
+  size_t offset_{0};     // bytes fed before the current chunk
+  size_t tok_start_{0};  // offset of the current token
+  internal::Stack tok_{};
+  internal::Stack depth_{};
+  Parser parser_{};
+};
+
+/**
+ * @brief SAXHandler for StreamingParser. It copies the keys and strings into
+ * the allocator, because the input chunks are not kept.
+ */
+template <typename NodeType>
+class StreamSAXHandler : public SAXHandler<NodeType> {
+ public:
+  using Allocator = typename NodeType::AllocatorType;
+
+  StreamSAXHandler() = default;
+  StreamSAXHandler(Allocator& alloc) : SAXHandler<NodeType>(alloc) {}
+
+  sonic_force_inline bool Key(StringView s) { return this->copyStringImpl(s); }
+
+  sonic_force_inline bool String(StringView s) {
+    return this->copyStringImpl(s);
+  }
+};
+
+}  // namespace sonic_json
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdlib>
+
+#include "sonic/dom/flags.h"
+#include "sonic/dom/parser.h"
+#include "sonic/dom/readonly_document.h"
+#include "sonic/dom/tapenode.h"
+#include "sonic/error.h"
+#include "sonic/internal/utils.h"
+
+namespace sonic_json {
+
+/**
+ * @brief A read-only document of TapeNodes, which is parsed once into one
+ * contiguous tape. The long strings point into the string buffer of the
+ * document, as in Document.
+ */
+class TapeDocument : public ReadOnlyDocument<TapeDocument, TapeNode> {
+ public:
+  TapeDocument() noexcept = default;
+  TapeDocument(const TapeDocument&) = delete;
+  TapeDocument& operator=(const TapeDocument&) = delete;
+
+  TapeDocument(TapeDocument&& rhs) noexcept
+      : ReadOnlyDocument(rhs),
+        tape_(rhs.tape_),
+        size_(rhs.size_),
+        str_(rhs.str_),
+        str_cap_(rhs.str_cap_) {
+    rhs.clear();
+  }
+
+  TapeDocument& operator=(TapeDocument&& rhs) noexcept {
+    if (this != &rhs) {
+      destroy();
+      tape_ = rhs.tape_;
+      size_ = rhs.size_;
+      str_ = rhs.str_;
+      str_cap_ = rhs.str_cap_;
+      parse_result_ = rhs.parse_result_;
+      rhs.clear();
+    }
+    return *this;
+  }
+
+  ~TapeDocument() { destroy(); }
+
+  /**
+   * @brief Parse a json into the tape.
+   * @param parseFlags combination of kParseTwoStage and kParseValidateUtf8,
+   * and the other flags are ignored, as the nodes are not mutable.
+   */
+  template <unsigned parseFlags = kParseDefault>
+  TapeDocument& Parse(StringView json) {
+    return Parse<parseFlags>(json.data(), json.size());
+  }
+
+  template <unsigned parseFlags = kParseDefault>
+  TapeDocument& Parse(const char* data, size_t len) {
+    destroy();
+    clear();
+    TapeSAXHandler sax;
+    str_ = internal::MallocPaddedJson(data, len);
+    if (!str_ || !sax.SetUp(StringView(data, len))) {
+      parse_result_ = kErrorNoMem;
+      return *this;
+    }
+    str_cap_ = len + SONICJSON_PADDING;
+    Parser p;
+    parse_result_ = p.template Parse<parseFlags>(str_, len, sax);
+    if (sonic_unlikely(sax.err_ != kErrorNone)) {
+      parse_result_ = ParseResult(sax.err_, parse_result_.Offset());
+    }
+    if (HasParseError()) {
+      destroy();
+      str_cap_ = 0;
+      return *this;
+    }
+    if (sax.buf_strings_ == 0) {
+      // all strings are inline, and the string buffer is not used any more
+      std::free(str_);
+      str_ = nullptr;
+      str_cap_ = 0;
+    }
+    TapeNode* tape = static_cast<TapeNode*>(
+        std::realloc((void*)sax.tape_, sizeof(TapeNode) * sax.np_));
+    tape_ = tape ? tape : sax.tape_;
+    size_ = sax.np_;
+    sax.tape_ = nullptr;
+    return *this;
+  }
+
+  /**
+   * @brief Get the bytes of the tape and the string buffer.
+   */
+  sonic_force_inline size_t GetMemoryUsage() const noexcept {
+    return size_ * sizeof(TapeNode) + str_cap_;
+  }
+
+ private:
+  friend class ReadOnlyDocument<TapeDocument, TapeNode>;
+
+  const TapeNode* rootImpl() const noexcept { return tape_; }
+
+  void destroy() noexcept {
+    std::free(tape_);
+    std::free(str_);
+    tape_ = nullptr;
+    str_ = nullptr;
+  }
+
+  void clear() noexcept {
+    tape_ = nullptr;
+    size_ = 0;
+    str_ = nullptr;
+    str_cap_ = 0;
+    parse_result_ = ParseResult();
+  }
+
+  TapeNode* tape_{nullptr};
+  size_t size_{0};
+  // String Buffer for the parsed long strings
+  char* str_{nullptr};
+  size_t str_cap_{0};
+};
+
+}  // namespace sonic_json
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+
+#include "sonic/allocator.h"
+#include "sonic/dom/genericnode.h"
+#include "sonic/dom/serialize.h"
+#include "sonic/dom/type.h"
+#include "sonic/error.h"
+#include "sonic/string_view.h"
+#include "sonic/writebuffer.h"
+
+namespace sonic_json {
+
+class TapeNode;
+class TapeSAXHandler;
+class TapeDocument;
+
+/**
+ * @brief The iterator of the array elements on a tape, which steps over the
+ * subtree of each element.
+ */
+class TapeValueIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = TapeNode;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const TapeNode*;
+  using reference = const TapeNode&;
+
+  TapeValueIterator() noexcept = default;
+  explicit TapeValueIterator(const TapeNode* p) noexcept : p_(p) {}
+
+  sonic_force_inline reference operator*() const noexcept { return *p_; }
+  sonic_force_inline pointer operator->() const noexcept { return p_; }
+  sonic_force_inline TapeValueIterator& operator++() noexcept;
+  sonic_force_inline TapeValueIterator operator++(int) noexcept {
+    TapeValueIterator it = *this;
+    ++(*this);
+    return it;
+  }
+  sonic_force_inline bool operator==(const TapeValueIterator& rhs) const {
+    return p_ == rhs.p_;
+  }
+  sonic_force_inline bool operator!=(const TapeValueIterator& rhs) const {
+    return p_ != rhs.p_;
+  }
+
+ private:
+  const TapeNode* p_{nullptr};
+};
+
+/**
+ * @brief The iterator of the object members on a tape. The value is right
+ * after the key, so a member is still a MemberNode, but the next member is
+ * after the subtree of the value.
+ */
+class TapeMemberIterator {
+ public:
+  using MemberNode = MemberNodeT<TapeNode>;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = MemberNode;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const MemberNode*;
+  using reference = const MemberNode&;
+
+  TapeMemberIterator() noexcept = default;
+  explicit TapeMemberIterator(const TapeNode* key) noexcept
+      : p_(reinterpret_cast<const MemberNode*>(key)) {}
+
+  sonic_force_inline reference operator*() const noexcept { return *p_; }
+  sonic_force_inline pointer operator->() const noexcept { return p_; }
+  sonic_force_inline TapeMemberIterator& operator++() noexcept;
+  sonic_force_inline TapeMemberIterator operator++(int) noexcept {
+    TapeMemberIterator it = *this;
+    ++(*this);
+    return it;
+  }
+  sonic_force_inline bool operator==(const TapeMemberIterator& rhs) const {
+    return p_ == rhs.p_;
+  }
+  sonic_force_inline bool operator!=(const TapeMemberIterator& rhs) const {
+    return p_ != rhs.p_;
+  }
+
+ private:
+  const MemberNode* p_{nullptr};
+};
+
+template <>
+struct NodeTraits<TapeNode> {
+  using alloc_type = SONIC_DEFAULT_ALLOCATOR;
+  using NodeType = TapeNode;
+  using MemberNode = MemberNodeT<TapeNode>;
+  using MemberIterator = TapeMemberIterator;
+  using ConstMemberIterator = TapeMemberIterator;
+  using ValueIterator = TapeValueIterator;
+  using ConstValueIterator = TapeValueIterator;
+};
+
+/**
+ * @brief A read-only node of TapeDocument, where all nodes are in one tape in
+ * the DFS order.
+ *
+ * The children of a container follow it on the tape, and the container keeps
+ * the count of its subtree nodes, so that its next sibling is found in O(1).
+ * The scalars are the same as DNode. Only the const query APIs of GenericNode
+ * are supported.
+ */
+class TapeNode : public GenericNode<TapeNode> {
+ public:
+  using NodeType = TapeNode;
+  using BaseNode = GenericNode<TapeNode>;
+  using MemberNode = typename NodeTraits<TapeNode>::MemberNode;
+  using ConstMemberIterator = typename NodeTraits<TapeNode>::ConstMemberIterator;
+  using ConstValueIterator = typename NodeTraits<TapeNode>::ConstValueIterator;
+
+  friend BaseNode;
+  friend class TapeSAXHandler;
+  friend class TapeDocument;
+  friend class TapeValueIterator;
+  friend class TapeMemberIterator;
+  template <unsigned serializeFlags, typename NodeType>
+  friend SonicError internal::SerializeImpl(const NodeType*, WriteBuffer&);
+
+  using BaseNode::BaseNode;
+  TapeNode() noexcept : BaseNode() {}
+  TapeNode(const TapeNode&) = delete;
+  TapeNode& operator=(const TapeNode&) = delete;
+
+ private:
+  // the count of nodes in the subtree, including the container itself
+  sonic_force_inline size_t span() const noexcept { return this->o.next.ofs; }
+
+  ConstValueIterator cbeginImpl() const noexcept {
+    return ConstValueIterator(this + 1);
+  }
+  ConstValueIterator cendImpl() const noexcept {
+    return ConstValueIterator(this + span());
+  }
+  ConstMemberIterator cmemberBeginImpl() const noexcept {
+    return ConstMemberIterator(this + 1);
+  }
+  ConstMemberIterator cmemberEndImpl() const noexcept {
+    return ConstMemberIterator(this + span());
+  }
+
+  ConstMemberIterator findMemberImpl(StringView key) const noexcept {
+    auto it = this->MemberBegin();
+    for (auto e = this->MemberEnd(); it != e; ++it) {
+      if (it->name.GetStringView() == key) break;
+    }
+    return it;
+  }
+
+  const TapeNode& findValueImpl(StringView key) const noexcept {
+    auto m = findMemberImpl(key);
+    if (m != this->MemberEnd()) return m->value;
+    static const TapeNode kNullNode;
+    return kNullNode;
+  }
+
+  // The elements are not indexed, so it walks over the idx elements before.
+  const TapeNode& findValueImpl(size_t idx) const noexcept {
+    const TapeNode* p = this + 1;
+    for (size_t i = 0; i < idx; i++) p = p->cnextImpl();
+    return *p;
+  }
+
+  template <unsigned serializeFlags = kSerializeDefault>
+  SonicError serializeImpl(WriteBuffer& wb) const {
+    return internal::SerializeImpl<serializeFlags>(this, wb);
+  }
+
+  sonic_force_inline const TapeNode* cnextImpl() const noexcept {
+    return this + (this->IsContainer() ? span() : 1);
+  }
+  sonic_force_inline const TapeNode* getObjChildrenFirstUnsafe()
+      const noexcept {
+    return this + 1;
+  }
+  sonic_force_inline const TapeNode* getArrChildrenFirstUnsafe()
+      const noexcept {
+    return this + 1;
+  }
+
+  // The open container is null and keeps the index of its parent.
+  sonic_force_inline void setOpen(size_t parent) noexcept {
+    this->setType(kNull);
+    this->o.next.ofs = parent;
+  }
+  sonic_force_inline size_t openParent() const noexcept {
+    return this->o.next.ofs;
+  }
+  sonic_force_inline void setClosed(TypeFlag type, size_t count,
+                                    size_t span) noexcept {
+    this->setLength(count, type);
+    this->o.next.ofs = span;
+  }
+  sonic_force_inline void setTapeString(StringView s) noexcept {
+    if (s.size() <= kInlineStringMax) {
+      this->setInlineString(s.data(), s.size());
+      return;
+    }
+    this->setLength(s.size(), kStringCopy);
+    this->sv.p = s.data();
+  }
+};
+
+inline TapeValueIterator& TapeValueIterator::operator++() noexcept {
+  p_ = p_->cnextImpl();
+  return *this;
+}
+
+inline TapeMemberIterator& TapeMemberIterator::operator++() noexcept {
+  p_ = reinterpret_cast<const MemberNode*>(p_->value.cnextImpl());
+  return *this;
+}
+
+/**
+ * @brief The SAX handler that appends the nodes to a tape. The containers are
+ * closed in place, and no nodes are moved as in SAXHandler.
+ */
+class TapeSAXHandler {
+ public:
+  TapeSAXHandler() noexcept = default;
+  TapeSAXHandler(const TapeSAXHandler&) = delete;
+  ~TapeSAXHandler() { std::free(tape_); }
+
+  sonic_force_inline bool SetUp(StringView json) {
+    // the tape is shrunk to fit after parsing
+    size_t cap = json.size() / 8 + 16;
+    tape_ = static_cast<TapeNode*>(std::malloc(sizeof(TapeNode) * cap));
+    if (!tape_) return false;
+    cap_ = cap;
+    return true;
+  }
+
+#define SONIC_ADD_NODE()       \
+  {                            \
+    if (!node()) return false; \
+  }
+
+  sonic_force_inline bool Null() noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode(kNull);
+    return true;
+  }
+  sonic_force_inline bool Bool(bool val) noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode(val);
+    return true;
+  }
+  sonic_force_inline bool Uint(uint64_t val) noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode(val);
+    return true;
+  }
+  sonic_force_inline bool Int(int64_t val) noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode(val);
+    return true;
+  }
+  sonic_force_inline bool Double(double val) noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode(val);
+    return true;
+  }
+
+  sonic_force_inline bool Key(StringView s) { return String(s); }
+
+  sonic_force_inline bool String(StringView s) {
+    SONIC_ADD_NODE();
+    TapeNode* cur = new (&tape_[np_ - 1]) TapeNode();
+    cur->setTapeString(s);
+    buf_strings_ += s.size() > kInlineStringMax;
+    return true;
+  }
+
+  sonic_force_inline bool StartObject() noexcept {
+    SONIC_ADD_NODE();
+    new (&tape_[np_ - 1]) TapeNode();
+    tape_[np_ - 1].setOpen(parent_);
+    parent_ = np_ - 1;
+    return true;
+  }
+  sonic_force_inline bool StartArray() noexcept { return StartObject(); }
+
+  sonic_force_inline bool EndObject(uint32_t pairs) noexcept {
+    return endContainer(kObject, pairs);
+  }
+  sonic_force_inline bool EndArray(uint32_t count) noexcept {
+    return endContainer(kArray, count);
+  }
+
+#undef SONIC_ADD_NODE
+
+ private:
+  friend class TapeDocument;
+
+  sonic_force_inline bool endContainer(TypeFlag type, size_t count) noexcept {
+    TapeNode& cur = tape_[parent_];
+    size_t old = cur.openParent();
+    cur.setClosed(type, count, np_ - parent_);
+    parent_ = old;
+    return true;
+  }
+
+  sonic_force_inline bool node() noexcept {
+    if (sonic_likely(np_ < cap_)) {
+      np_++;
+      return true;
+    }
+    return grow();
+  }
+
+  // The parents are indexes, so it is safe to move the tape.
+  sonic_never_inline bool grow() noexcept {
+    size_t cap = cap_ * 2;
+    TapeNode* tape = static_cast<TapeNode*>(
+        std::realloc((void*)tape_, sizeof(TapeNode) * cap));
+    if (!tape) {
+      err_ = kErrorNoMem;
+      return false;
+    }
+    tape_ = tape;
+    cap_ = cap;
+    np_++;
+    return true;
+  }
+
+  TapeNode* tape_{nullptr};
+  size_t np_{0};
+  size_t cap_{0};
+  size_t parent_{0};
+  // the count of strings that point into the string buffer
+  size_t buf_strings_{0};
+  SonicError err_{kErrorNone};
+};
+
+}  // namespace sonic_json
@@ -45,6 +45,16 @@ enum TypeFlag {
   // kStringConst: sv.p is not copied, so not need free, e.g. SetString without
   // allocator arg
   kStringConst = ((uint8_t)(2 << 3)) | kString,  // xxx10_100, 20
+  // kStringInline: the string is stored in the node itself, in place of sv.p,
+  // and ends with '\0'. It is used for the strings of at most
+  // kInlineStringMax bytes.
+  kStringInline = ((uint8_t)(3 << 3)) | kString,  // xxx11_100, 28
+  // kPackedReal: the array elements are packed as double[] after the
+  // MetaNode, see kParsePackNumbers.
+  kPackedReal = ((uint8_t)(1 << 3)) | kArray,  // xxx01_111, 15
+  // kPackedInt: the array elements are packed as int64_t[], the non-negative
+  // ones are kUint and the others kSint when unpacked.
+  kPackedInt = ((uint8_t)(2 << 3)) | kArray,  // xxx10_111, 23
 
 };  // 8 bits
 
@@ -65,6 +75,7 @@ enum TypeInfo {
   kOthersBits = 56,
   kLengthMask = (0xFFFFFFFFFFFFFFFF << 8),
   kContainerMask = 0x6,  // 00000110
+  kInlineStringMax = 7,  // 8 bytes of sv.p with the ending '\0'
 };
 
 }  // namespace sonic_json
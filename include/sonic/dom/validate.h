@@ -0,0 +1,210 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sonic/error.h"
+#include "sonic/internal/arch/simd_skip.h"
+#include "sonic/macro.h"
+#include "sonic/string_view.h"
+
+namespace sonic_json {
+namespace internal {
+
+// Validator checks the json grammar in one pass of the text. The strings are
+// checked by the SIMD kernels, and the numbers are only checked by the
+// grammar, not converted. The kinds of the open containers are kept in a
+// bit stack, which only allocates when the json is nested very deeply.
+class Validator {
+ public:
+  ParseResult Validate(const uint8_t *data, size_t len) {
+    data_ = data;
+    len_ = len;
+    pos_ = 0;
+    depth_ = 0;
+    SonicError err = validate();
+    return ParseResult(err, pos_);
+  }
+
+ private:
+  static constexpr size_t kInlineDepth = 4096;
+  // The end of the json, which is not a char, so the NUL bytes are invalid.
+  static constexpr int kEnd = -1;
+
+  sonic_force_inline int next() {
+    if (pos_ >= len_) return kEnd;
+    uint8_t c = scan_.SkipSpaceSafe(data_, pos_, len_);
+    return IsSpace(c) ? kEnd : c;
+  }
+
+  sonic_force_inline void push(bool is_arr) {
+    size_t word = depth_ / 64;
+    uint64_t bit = 1ull << (depth_ % 64);
+    uint64_t *stack = inline_;
+    if (word >= kInlineDepth / 64) {
+      word -= kInlineDepth / 64;
+      if (word >= spill_.size()) spill_.push_back(0);
+      stack = spill_.data();
+    }
+    stack[word] = is_arr ? (stack[word] | bit) : (stack[word] & ~bit);
+    depth_++;
+  }
+
+  // Whether the current container is an array.
+  sonic_force_inline bool inArray() const {
+    size_t i = depth_ - 1;
+    const uint64_t *stack = inline_;
+    if (i >= kInlineDepth) {
+      i -= kInlineDepth;
+      stack = spill_.data();
+    }
+    return (stack[i / 64] >> (i % 64)) & 1;
+  }
+
+  static sonic_force_inline bool isDigit(uint8_t c) {
+    return c >= '0' && c <= '9';
+  }
+
+  // Check the number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+  sonic_force_inline SonicError validateNumber() {
+    size_t pos = pos_ - 1;
+    if (data_[pos] == '-') pos++;
+    size_t start = pos;
+    while (pos < len_ && isDigit(data_[pos])) pos++;
+    bool ok = pos != start && (data_[start] != '0' || pos - start == 1);
+    if (ok && pos < len_ && data_[pos] == '.') {
+      start = ++pos;
+      while (pos < len_ && isDigit(data_[pos])) pos++;
+      ok = pos != start;
+    }
+    if (ok && pos < len_ && (data_[pos] | 0x20) == 'e') {
+      pos++;
+      if (pos < len_ && (data_[pos] == '+' || data_[pos] == '-')) pos++;
+      start = pos;
+      while (pos < len_ && isDigit(data_[pos])) pos++;
+      ok = pos != start;
+    }
+    pos_ = pos;
+    return ok ? kErrorNone : kParseErrorInvalidChar;
+  }
+
+  sonic_force_inline SonicError validatePrimitive(int c) {
+    switch (c) {
+      case '"':
+        return ValidateString(data_, pos_, len_);
+      case 't':
+      case 'f':
+      case 'n':
+        return SkipLiteral(data_, pos_, len_, c) ? kErrorNone
+                                                 : kParseErrorInvalidChar;
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9':
+      case '-':
+        return validateNumber();
+      case kEnd:
+        return kParseErrorEof;
+      default:
+        return kParseErrorInvalidChar;
+    }
+  }
+
+  SonicError validate() {
+    SonicError err;
+    int c = next();
+
+  value:
+    if (c == '[') {
+      push(true);
+      c = next();
+      if (c == ']') goto scope_end;
+      goto value;
+    }
+    if (c == '{') {
+      push(false);
+      c = next();
+      if (c == '}') goto scope_end;
+      goto obj_key;
+    }
+    err = validatePrimitive(c);
+    if (err) return err;
+    if (depth_ == 0) goto doc_end;
+    c = next();
+
+  scope_cont:
+    if (c == ',') {
+      c = next();
+      if (inArray()) goto value;
+      goto obj_key;
+    }
+    if (c == kEnd) return kParseErrorEof;
+    if (c != (inArray() ? ']' : '}')) return kParseErrorInvalidChar;
+
+  scope_end:
+    if (--depth_ == 0) goto doc_end;
+    c = next();
+    goto scope_cont;
+
+  obj_key:
+    if (c != '"') return c == kEnd ? kParseErrorEof : kParseErrorInvalidChar;
+    err = ValidateString(data_, pos_, len_);
+    if (err) return err;
+    c = next();
+    if (c != ':') return c == kEnd ? kParseErrorEof : kParseErrorInvalidChar;
+    c = next();
+    goto value;
+
+  doc_end:
+    if (next() != kEnd) return kParseErrorInvalidChar;
+    return kErrorNone;
+  }
+
+  const uint8_t *data_{nullptr};
+  size_t len_{0};
+  size_t pos_{0};
+  size_t depth_{0};
+  SkipScanner scan_{};
+  uint64_t inline_[kInlineDepth / 64];
+  std::vector<uint64_t> spill_{};
+};
+
+}  // namespace internal
+
+/**
+ * @brief Validate the json without building a DOM. It checks the json
+ * grammar, the escaped chars and the utf-8 encoding of strings, and does not
+ * copy the json or convert the numbers. So the numbers out of the double
+ * range, such as 1e400, are valid here, although Parse rejects them.
+ * @param json the json text, which does not need padding.
+ * @return ParseResult, the offset is near the invalid char if has errors.
+ */
+inline ParseResult Validate(StringView json) {
+  internal::Validator validator;
+  return validator.Validate(reinterpret_cast<const uint8_t *>(json.data()),
+                            json.size());
+}
+
+}  // namespace sonic_json
@@ -50,6 +50,12 @@ enum SonicError {
                                 ///< string.
   kErrorNoMem = 14,             ///< Memory is not enough to allocate.
   kParseErrorUnexpect = 15,     ///< Unexpected Errors
+  kParseErrorInsituPadding = 16,  ///< ParseInsitu: the buffer has not enough
+                                  ///< padding after JSON.
+  kErrorOpenFile = 17,  ///< ParseFile: failed to open or map the file.
+  kErrorInvalidJsonPath = 18,  ///< JsonPath: the path expression is invalid.
+  kErrorCompactLimit = 19,  ///< CompactDocument: the JSON is over the limits of
+                            ///< the compact nodes.
 
   kErrorNums,
 };
@@ -84,6 +90,12 @@ inline const char* ErrorMsg(SonicError error) noexcept {
        "Serialize: The type of object's key is not string."},
       {kErrorNoMem, "Memory is not enough to allocate."},
       {kParseErrorUnexpect, "Unexpected Errors"},
+      {kParseErrorInsituPadding,
+       "ParseInsitu: the buffer has not enough padding after JSON."},
+      {kErrorOpenFile, "ParseFile: failed to open or map the file."},
+      {kErrorInvalidJsonPath, "JsonPath: the path expression is invalid."},
+      {kErrorCompactLimit,
+       "CompactDocument: the JSON is over the limits of the compact nodes."},
   };
   return kErrorMsg[error].msg;
 };
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <immintrin.h>
+#include <sonic/macro.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.h"
+
+SONIC_PUSH_HASWELL
+
+namespace sonic_json {
+namespace internal {
+namespace avx2 {
+
+// the bitmask of the 8 tags equal to tag
+sonic_force_inline uint32_t EqTags8(const uint64_t* tags, uint64_t tag) {
+  const __m256i* p = reinterpret_cast<const __m256i*>(tags);
+  __m256i t = _mm256_set1_epi64x(static_cast<long long>(tag));
+  __m256i lo = _mm256_cmpeq_epi64(_mm256_loadu_si256(p), t);
+  __m256i hi = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 1), t);
+  return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(lo))) |
+         static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(hi)))
+             << 4;
+}
+
+// FindTag returns the index of the first tag equal to tag in [start, n), or n
+// if not found. The tags are padded to a multiple of 8.
+sonic_force_inline size_t FindTag(const uint64_t* tags, size_t start, size_t n,
+                                  uint64_t tag) {
+  for (size_t i = start & ~size_t(7); i < n; i += 8) {
+    uint32_t bits = EqTags8(tags + i, tag);
+    if (i < start) bits &= ~0u << (start - i);
+    if (bits) {
+      size_t j = i + TrailingZeroes(bits);
+      return j < n ? j : n;
+    }
+  }
+  return n;
+}
+
+}  // namespace avx2
+}  // namespace internal
+}  // namespace sonic_json
+
+SONIC_POP_TARGET
@@ -41,6 +41,7 @@ namespace sonic_json {
 namespace internal {
 namespace avx2 {
 
+using VecMaskType = uint32_t;
 using VecType = simd::simd256<uint8_t>;
 
 #include "../common/x86_common/quote.inc.h"
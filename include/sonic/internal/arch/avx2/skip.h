@@ -36,6 +36,7 @@ namespace sonic_json {
 namespace internal {
 namespace avx2 {
 
+using VecMaskType = uint32_t;
 using VecUint8Type = simd::simd256<uint8_t>;
 using VecBoolType = simd::simd256<bool>;
 using sonic_json::internal::common::EqBytes4;
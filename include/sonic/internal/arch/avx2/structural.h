@@ -0,0 +1,41 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include <cstring>
+
+#include "../common/unicode_common.h"
+#include "base.h"
+#include "simd.h"
+#include "unicode.h"
+
+SONIC_PUSH_HASWELL
+
+namespace sonic_json {
+namespace internal {
+namespace avx2 {
+
+#include "../common/x86_common/structural.inc.h"
+
+}  // namespace avx2
+}  // namespace internal
+}  // namespace sonic_json
+
+SONIC_POP_TARGET
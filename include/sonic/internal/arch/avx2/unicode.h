@@ -78,6 +78,90 @@ sonic_force_inline uint64_t GetNonSpaceBits(const uint8_t *data) {
   return ~space;
 }
 
+// Utf8Checker validates the utf-8 chars block by block with the lookup tables
+// in unicode_common.h. The errors are accumulated and checked at last by
+// Valid, so the check has no branch in the hot loop except for ascii blocks.
+struct Utf8Checker {
+ public:
+  sonic_force_inline Utf8Checker()
+      : error_(_mm256_setzero_si256()),
+        prev_input_(_mm256_setzero_si256()),
+        prev_incomplete_(_mm256_setzero_si256()) {}
+
+  // Check the 32 bytes from src, which follow the bytes checked last time.
+  sonic_force_inline void Update(const uint8_t *src) {
+    check(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+  }
+
+  // Check the first n (n < 32) bytes from src. The chars must end before the
+  // n-th byte, and the next bytes to check are not following them.
+  sonic_force_inline void UpdatePrefix(const uint8_t *src, size_t n) {
+    const __m256i idx =
+        _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                         16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+                         29, 30, 31);
+    __m256i mask =
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(n)), idx);
+    check(_mm256_and_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)), mask));
+    prev_input_ = _mm256_setzero_si256();
+  }
+
+  // Whether all the checked chars are valid and complete.
+  sonic_force_inline bool Valid() const {
+    __m256i err = _mm256_or_si256(error_, prev_incomplete_);
+    return _mm256_testz_si256(err, err);
+  }
+
+ private:
+  static sonic_force_inline __m256i lookup(const uint8_t *table, __m256i idx) {
+    __m256i t = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(table)));
+    return _mm256_shuffle_epi8(t, idx);
+  }
+
+  template <int N>
+  sonic_force_inline __m256i prev(__m256i input) const {
+    return _mm256_alignr_epi8(
+        input, _mm256_permute2x128_si256(prev_input_, input, 0x21), 16 - N);
+  }
+
+  sonic_force_inline void check(__m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+      // the ascii block, only check the incomplete chars before it.
+      error_ = _mm256_or_si256(error_, prev_incomplete_);
+    } else {
+      const __m256i low4 = _mm256_set1_epi8(0x0f);
+      __m256i prev1 = prev<1>(input);
+      __m256i special = _mm256_and_si256(
+          _mm256_and_si256(
+              lookup(common::kUtf8Byte1High,
+                     _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low4)),
+              lookup(common::kUtf8Byte1Low, _mm256_and_si256(prev1, low4))),
+          lookup(common::kUtf8Byte2High,
+                 _mm256_and_si256(_mm256_srli_epi16(input, 4), low4)));
+      // the 3rd and 4th bytes of the multi-byte chars must be continuations.
+      __m256i must23 = _mm256_or_si256(
+          _mm256_subs_epu8(prev<2>(input), _mm256_set1_epi8(0xe0 - 0x80)),
+          _mm256_subs_epu8(prev<3>(input), _mm256_set1_epi8(0xf0 - 0x80)));
+      must23 =
+          _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80)));
+      error_ = _mm256_or_si256(error_, _mm256_xor_si256(must23, special));
+      // the multi-byte chars at the end of block are incomplete.
+      const __m256i max_value = _mm256_setr_epi8(
+          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0xf0 - 1, 0xe0 - 1,
+          0xc0 - 1);
+      prev_incomplete_ = _mm256_subs_epu8(input, max_value);
+    }
+    prev_input_ = input;
+  }
+
+  __m256i error_;
+  __m256i prev_input_;
+  __m256i prev_incomplete_;
+};
+
 }  // namespace avx2
 }  // namespace internal
 }  // namespace sonic_json
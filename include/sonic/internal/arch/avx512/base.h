@@ -0,0 +1,40 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include "../avx2/base.h"
+#include "simd.h"
+
+namespace sonic_json {
+namespace internal {
+namespace avx512 {
+
+using namespace simd;
+
+// The bit operations and memcpy are the same as AVX2.
+using avx2::ClearLowestBit;
+using avx2::CountOnes;
+using avx2::LeadingZeroes;
+using avx2::PrefixXor;
+using avx2::TrailingZeroes;
+using avx2::Xmemcpy;
+
+}  // namespace avx512
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <immintrin.h>
+#include <sonic/macro.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.h"
+
+SONIC_PUSH_SKYLAKE_AVX512
+
+namespace sonic_json {
+namespace internal {
+namespace avx512 {
+
+// FindTag returns the index of the first tag equal to tag in [start, n), or n
+// if not found. The tags are padded to a multiple of 8, and 8 tags are one
+// register.
+sonic_force_inline size_t FindTag(const uint64_t* tags, size_t start, size_t n,
+                                  uint64_t tag) {
+  __m512i t = _mm512_set1_epi64(static_cast<long long>(tag));
+  for (size_t i = start & ~size_t(7); i < n; i += 8) {
+    uint32_t bits = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(tags + i), t);
+    if (i < start) bits &= ~0u << (start - i);
+    if (bits) {
+      size_t j = i + TrailingZeroes(bits);
+      return j < n ? j : n;
+    }
+  }
+  return n;
+}
+
+}  // namespace avx512
+}  // namespace internal
+}  // namespace sonic_json
+
+SONIC_POP_TARGET
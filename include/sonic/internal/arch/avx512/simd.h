@@ -0,0 +1,140 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <immintrin.h>
+#include <sonic/macro.h>
+
+#include <cstdint>
+
+SONIC_PUSH_SKYLAKE_AVX512
+
+namespace sonic_json {
+namespace internal {
+namespace avx512 {
+namespace simd {
+
+template <typename T>
+struct simd512;
+
+// The AVX-512 comparisons write a 64-bit mask register directly, so the byte
+// masks are the bitmasks, and need no movemask.
+template <>
+struct simd512<bool> {
+  __mmask64 value;
+
+  sonic_force_inline simd512() : value(0) {}
+  sonic_force_inline simd512(const __mmask64 _value) : value(_value) {}
+  sonic_force_inline explicit simd512(bool _value)
+      : value(_value ? ~__mmask64(0) : 0) {}
+
+  sonic_force_inline uint64_t to_bitmask() const { return value; }
+  sonic_force_inline simd512<bool> operator|(const simd512<bool> other) const {
+    return value | other.value;
+  }
+  sonic_force_inline simd512<bool> operator&(const simd512<bool> other) const {
+    return value & other.value;
+  }
+  sonic_force_inline simd512<bool> operator~() const { return ~value; }
+  sonic_force_inline simd512<bool>& operator|=(const simd512<bool> other) {
+    value |= other.value;
+    return *this;
+  }
+};
+
+template <>
+struct simd512<uint8_t> {
+  __m512i value;
+
+  sonic_force_inline simd512() : value{__m512i()} {}
+  sonic_force_inline simd512(const __m512i _value) : value(_value) {}
+  sonic_force_inline simd512(const uint8_t values[64])
+      : value(_mm512_loadu_si512(reinterpret_cast<const void*>(values))) {}
+
+  static sonic_force_inline simd512<uint8_t> splat(uint8_t _value) {
+    return _mm512_set1_epi8(static_cast<char>(_value));
+  }
+
+  // Conversion to SIMD register
+  sonic_force_inline operator const __m512i&() const { return this->value; }
+
+  sonic_force_inline void store(uint8_t dst[64]) const {
+    _mm512_storeu_si512(reinterpret_cast<void*>(dst), value);
+  }
+
+  // only store the bytes whose bits are set in mask.
+  sonic_force_inline void store_mask(uint8_t* dst, uint64_t mask) const {
+    _mm512_mask_storeu_epi8(reinterpret_cast<void*>(dst), mask, value);
+  }
+
+  sonic_force_inline simd512<uint8_t> operator|(
+      const simd512<uint8_t> other) const {
+    return _mm512_or_si512(value, other.value);
+  }
+  sonic_force_inline simd512<bool> operator==(
+      const simd512<uint8_t> other) const {
+    return _mm512_cmpeq_epi8_mask(value, other.value);
+  }
+  sonic_force_inline simd512<bool> operator==(uint8_t other) const {
+    return *this == splat(other);
+  }
+  // the unsigned comparisons
+  sonic_force_inline simd512<bool> operator<=(uint8_t other) const {
+    return _mm512_cmple_epu8_mask(value, splat(other));
+  }
+  sonic_force_inline simd512<bool> operator<(uint8_t other) const {
+    return _mm512_cmplt_epu8_mask(value, splat(other));
+  }
+};
+
+// A 64-byte block is one register, the interfaces are the same as the
+// simd8x64 of AVX2.
+template <typename T>
+struct simd8x64;
+
+template <>
+struct simd8x64<uint8_t> {
+  const simd512<uint8_t> chunk;
+
+  simd8x64(const simd8x64<uint8_t>& o) = delete;  // no copy allowed
+  simd8x64() = delete;  // no default constructor allowed
+
+  sonic_force_inline simd8x64(const uint8_t ptr[64]) : chunk(ptr) {}
+
+  sonic_force_inline void store(uint8_t ptr[64]) const { chunk.store(ptr); }
+
+  sonic_force_inline simd512<uint8_t> reduce_or() const { return chunk; }
+
+  sonic_force_inline uint64_t eq(const uint8_t m) const {
+    return (chunk == m).to_bitmask();
+  }
+
+  sonic_force_inline uint64_t eq(const simd8x64<uint8_t>& other) const {
+    return (chunk == other.chunk).to_bitmask();
+  }
+
+  sonic_force_inline uint64_t lteq(const uint8_t m) const {
+    return (chunk <= m).to_bitmask();
+  }
+};
+
+}  // namespace simd
+}  // namespace avx512
+}  // namespace internal
+}  // namespace sonic_json
+
+SONIC_POP_TARGET
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "../common/unicode_common.h"
+#include "base.h"
+#include "simd.h"
+
+SONIC_PUSH_SKYLAKE_AVX512
+
+namespace sonic_json {
+namespace internal {
+namespace avx512 {
+
+using namespace simd;
+using sonic_json::internal::common::handle_unicode_codepoint;
+
+struct StringBlock {
+ public:
+  sonic_force_inline static StringBlock Find(const uint8_t *src);
+  sonic_force_inline bool HasQuoteFirst() {
+    return (((bs_bits - 1) & quote_bits) != 0) && !HasUnescaped();
+  }
+  sonic_force_inline bool HasBackslash() {
+    return ((quote_bits - 1) & bs_bits) != 0;
+  }
+  sonic_force_inline bool HasUnescaped() {
+    return ((quote_bits - 1) & unescaped_bits) != 0;
+  }
+  sonic_force_inline int QuoteIndex() { return TrailingZeroes(quote_bits); }
+  sonic_force_inline int BsIndex() { return TrailingZeroes(bs_bits); }
+  sonic_force_inline int UnescapedIndex() {
+    return TrailingZeroes(unescaped_bits);
+  }
+
+  uint64_t bs_bits;
+  uint64_t quote_bits;
+  uint64_t unescaped_bits;
+};
+
+sonic_force_inline StringBlock StringBlock::Find(const uint8_t *src) {
+  simd512<uint8_t> v(src);
+  return {
+      (v == '\\').to_bitmask(),
+      (v == '"').to_bitmask(),
+      (v <= '\x1f').to_bitmask(),
+  };
+}
+
+sonic_force_inline uint64_t GetNonSpaceBits(const uint8_t *data) {
+  const simd512<uint8_t> v(data);
+  const __m512i whitespace_table = _mm512_broadcast_i32x4(
+      _mm_setr_epi8(' ', 100, 100, 100, 17, 100, 113, 2, 100, '\t', '\n', 112,
+                    100, '\r', 100, 100));
+  return ~_mm512_cmpeq_epi8_mask(_mm512_shuffle_epi8(whitespace_table, v), v);
+}
+
+// Utf8Checker is the AVX2 one with 64-byte blocks. The shuffles of AVX-512
+// work in each 128-bit lane, so the lookup tables are broadcasted to all
+// lanes, and the previous bytes are shifted in across the lanes by permutes.
+struct Utf8Checker {
+ public:
+  sonic_force_inline Utf8Checker()
+      : error_(_mm512_setzero_si512()),
+        prev_input_(_mm512_setzero_si512()),
+        prev_incomplete_(_mm512_setzero_si512()) {}
+
+  // Check the 64 bytes from src, which follow the bytes checked last time.
+  sonic_force_inline void Update(const uint8_t *src) {
+    check(_mm512_loadu_si512(reinterpret_cast<const void *>(src)));
+  }
+
+  // Check the first n (n < 64) bytes from src. The chars must end before the
+  // n-th byte, and the next bytes to check are not following them.
+  sonic_force_inline void UpdatePrefix(const uint8_t *src, size_t n) {
+    check(_mm512_maskz_loadu_epi8((uint64_t(1) << n) - 1,
+                                  reinterpret_cast<const void *>(src)));
+    prev_input_ = _mm512_setzero_si512();
+  }
+
+  // Whether all the checked chars are valid and complete.
+  sonic_force_inline bool Valid() const {
+    __m512i err = _mm512_or_si512(error_, prev_incomplete_);
+    return _mm512_test_epi8_mask(err, err) == 0;
+  }
+
+ private:
+  static sonic_force_inline __m512i lookup(const uint8_t *table, __m512i idx) {
+    __m512i t = _mm512_broadcast_i32x4(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(table)));
+    return _mm512_shuffle_epi8(t, idx);
+  }
+
+  template <int N>
+  sonic_force_inline __m512i prev(__m512i input) const {
+    // the lanes of input are moved up by one, the last lane of prev_input_
+    // becomes the first.
+    __m512i shifted = _mm512_permutex2var_epi64(
+        prev_input_, _mm512_set_epi64(13, 12, 11, 10, 9, 8, 7, 6), input);
+    return _mm512_alignr_epi8(input, shifted, 16 - N);
+  }
+
+  sonic_force_inline void check(__m512i input) {
+    if (_mm512_movepi8_mask(input) == 0) {
+      // the ascii block, only check the incomplete chars before it.
+      error_ = _mm512_or_si512(error_, prev_incomplete_);
+    } else {
+      const __m512i low4 = _mm512_set1_epi8(0x0f);
+      __m512i prev1 = prev<1>(input);
+      __m512i special = _mm512_and_si512(
+          _mm512_and_si512(
+              lookup(common::kUtf8Byte1High,
+                     _mm512_and_si512(_mm512_srli_epi16(prev1, 4), low4)),
+              lookup(common::kUtf8Byte1Low, _mm512_and_si512(prev1, low4))),
+          lookup(common::kUtf8Byte2High,
+                 _mm512_and_si512(_mm512_srli_epi16(input, 4), low4)));
+      // the 3rd and 4th bytes of the multi-byte chars must be continuations.
+      __m512i must23 = _mm512_or_si512(
+          _mm512_subs_epu8(prev<2>(input), _mm512_set1_epi8(0xe0 - 0x80)),
+          _mm512_subs_epu8(prev<3>(input), _mm512_set1_epi8(0xf0 - 0x80)));
+      must23 =
+          _mm512_and_si512(must23, _mm512_set1_epi8(static_cast<char>(0x80)));
+      error_ = _mm512_or_si512(error_, _mm512_xor_si512(must23, special));
+      // the multi-byte chars at the end of block are incomplete.
+      const __m512i max_value = _mm512_inserti32x4(
+          _mm512_set1_epi8(-1),
+          _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                        0xf0 - 1, 0xe0 - 1, 0xc0 - 1),
+          3);
+      prev_incomplete_ = _mm512_subs_epu8(input, max_value);
+    }
+    prev_input_ = input;
+  }
+
+  __m512i error_;
+  __m512i prev_input_;
+  __m512i prev_incomplete_;
+};
+
+}  // namespace avx512
+}  // namespace internal
+}  // namespace sonic_json
+
+SONIC_POP_TARGET
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <cstring>
+
+#include "quote_tables.h"
+#include "sonic/error.h"
 #include "sonic/macro.h"
 
 namespace sonic_json {
@@ -60,6 +64,120 @@ sonic_force_inline bool SkipLiteral(const uint8_t *data, size_t &pos,
   return false;
 }
 
+static sonic_force_inline bool ReadHex4(const uint8_t *src, uint32_t &cp) {
+  cp = 0;
+  for (int i = 0; i < 4; i++) {
+    uint8_t c = src[i];
+    uint8_t d;
+    if (c >= '0' && c <= '9') {
+      d = c - '0';
+    } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+      d = (c | 0x20) - 'a' + 10;
+    } else {
+      return false;
+    }
+    cp = (cp << 4) | d;
+  }
+  return true;
+}
+
+// ValidateUtf8Char checks the multi-byte utf-8 char at pos, and updates pos to
+// the end of it. The ranges are from the Table 3-7 in the Unicode Standard.
+sonic_force_inline bool ValidateUtf8Char(const uint8_t *data, size_t &pos,
+                                         size_t len) {
+  uint8_t c = data[pos];
+  size_t n;
+  uint8_t lo = 0x80, hi = 0xBF;
+  if (c >= 0xC2 && c <= 0xDF) {
+    n = 2;
+  } else if (c >= 0xE0 && c <= 0xEF) {
+    n = 3;
+    if (c == 0xE0) lo = 0xA0;
+    if (c == 0xED) hi = 0x9F;
+  } else if (c >= 0xF0 && c <= 0xF4) {
+    n = 4;
+    if (c == 0xF0) lo = 0x90;
+    if (c == 0xF4) hi = 0x8F;
+  } else {
+    return false;
+  }
+  if (pos + n > len) return false;
+  if (data[pos + 1] < lo || data[pos + 1] > hi) return false;
+  for (size_t i = 2; i < n; i++) {
+    if ((data[pos + i] & 0xC0) != 0x80) return false;
+  }
+  pos += n;
+  return true;
+}
+
+// ValidateEscaped checks the escaped char at pos, which is a backslash, and
+// updates pos to the end of it.
+sonic_force_inline SonicError ValidateEscaped(const uint8_t *data, size_t &pos,
+                                              size_t len) {
+  if (pos + 1 >= len) return kParseErrorEof;
+  uint8_t c = data[pos + 1];
+  if (c != 'u') {
+    if (kEscapedMap[c] == 0) return kParseErrorEscapedFormat;
+    pos += 2;
+    return kErrorNone;
+  }
+  uint32_t cp, cp2;
+  if (pos + 6 > len || !ReadHex4(data + pos + 2, cp)) {
+    return kParseErrorEscapedUnicode;
+  }
+  pos += 6;
+  // the high surrogate must be followed by a low surrogate
+  if (cp >= 0xD800 && cp < 0xDC00) {
+    if (pos + 6 > len || data[pos] != '\\' || data[pos + 1] != 'u' ||
+        !ReadHex4(data + pos + 2, cp2) || cp2 < 0xDC00 || cp2 > 0xDFFF) {
+      return kParseErrorEscapedUnicode;
+    }
+    pos += 6;
+  }
+  return kErrorNone;
+}
+
+// ValidateStringChar checks the char at pos in a string, which is a backslash,
+// a control char or the first byte of a multi-byte utf-8 char, and updates pos
+// to the end of it. The following chars of the same kind are also checked,
+// because they are often continuous.
+sonic_force_inline SonicError ValidateStringChar(const uint8_t *data,
+                                                 size_t &pos, size_t len) {
+  uint8_t c = data[pos];
+  if (c == '\\') {
+    do {
+      SonicError err = ValidateEscaped(data, pos, len);
+      if (err) return err;
+    } while (pos < len && data[pos] == '\\');
+    return kErrorNone;
+  }
+  if (c < 0x80) return kParseErrorUnEscaped;
+  do {
+    if (!ValidateUtf8Char(data, pos, len)) return kParseErrorInvalidUTF8;
+  } while (pos < len && data[pos] >= 0x80);
+  return kErrorNone;
+}
+
+// ValidateStringScalar validates the string from pos byte by byte, and
+// updates pos to after the ending quote, or to the invalid char.
+sonic_force_inline SonicError ValidateStringScalar(const uint8_t *data,
+                                                   size_t &pos, size_t len) {
+  while (pos < len) {
+    uint8_t c = data[pos];
+    if (c == '"') {
+      pos++;
+      return kErrorNone;
+    }
+    if (c >= 0x20 && c < 0x80 && c != '\\') {
+      pos++;
+      continue;
+    }
+    SonicError err = ValidateStringChar(data, pos, len);
+    if (err) return err;
+  }
+  return kParseErrorEof;
+}
+
 }  // namespace common
 }  // namespace internal
 }  // namespace sonic_json
@@ -268,11 +268,91 @@ sonic_force_inline bool handle_unicode_codepoint(const uint8_t **src_ptr,
   return offset > 0;
 }
 
+// The lookup tables to validate utf-8 by SIMD, see "Validating UTF-8 In Less
+// Than One Instruction Per Byte" (John Keiser and Daniel Lemire).
+// Each table is indexed by a nibble, the high or low nibble of the previous
+// byte, and the high nibble of the current byte. A bit is set in all the
+// three lookups only if the pair of bytes has the error of that bit.
+enum Utf8ErrorBits : uint8_t {
+  kUtf8TooShort = 1 << 0,      // 11______ 0_______, 11______ 11______
+  kUtf8TooLong = 1 << 1,       // 0_______ 10______
+  kUtf8Overlong3 = 1 << 2,     // 11100000 100_____
+  kUtf8TooLarge = 1 << 3,      // 11110100 1001____, 11110100 101_____ ...
+  kUtf8Surrogate = 1 << 4,     // 11101101 101_____
+  kUtf8Overlong2 = 1 << 5,     // 1100000_ 10______
+  kUtf8TooLarge1000 = 1 << 6,  // 11110101 1000____, 1111011_ 1000____ ...
+  kUtf8Overlong4 = 1 << 6,     // 11110000 1000____
+  kUtf8TwoConts = 1 << 7,      // 10______ 10______
+  kUtf8Carry = kUtf8TooShort | kUtf8TooLong | kUtf8TwoConts,
+};
+
+static const uint8_t kUtf8Byte1High[16] = {
+    // 0_______ ________, ascii in byte 1
+    kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+    kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+    // 10______ ________, continuation in byte 1
+    kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts,
+    // 1100____ ________, two byte lead in byte 1
+    kUtf8TooShort | kUtf8Overlong2,
+    // 1101____ ________, two byte lead in byte 1
+    kUtf8TooShort,
+    // 1110____ ________, three byte lead in byte 1
+    kUtf8TooShort | kUtf8Overlong3 | kUtf8Surrogate,
+    // 1111____ ________, four+ byte lead in byte 1
+    kUtf8TooShort | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Overlong4,
+};
+
+static const uint8_t kUtf8Byte1Low[16] = {
+    // ____0000 ________
+    kUtf8Carry | kUtf8Overlong3 | kUtf8Overlong2 | kUtf8Overlong4,
+    // ____0001 ________
+    kUtf8Carry | kUtf8Overlong2,
+    // ____001_ ________
+    kUtf8Carry,
+    kUtf8Carry,
+    // ____0100 ________
+    kUtf8Carry | kUtf8TooLarge,
+    // ____0101 ________
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    // ____011_ ________
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    // ____1___ ________
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    // ____1101 ________
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Surrogate,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+};
+
+static const uint8_t kUtf8Byte2High[16] = {
+    // ________ 0_______, ascii in byte 2
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    // ________ 1000____
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 |
+        kUtf8TooLarge1000 | kUtf8Overlong4,
+    // ________ 1001____
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 |
+        kUtf8TooLarge,
+    // ________ 101_____
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate |
+        kUtf8TooLarge,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate |
+        kUtf8TooLarge,
+    // ________ 11______, lead in byte 2
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+};
+
 template <size_t BLOK_SIZE>
 sonic_force_inline uint64_t GetEscapedBranchless(uint64_t &prev_escaped,
                                                  uint64_t backslash) {
-  static_assert(BLOK_SIZE == 32 || BLOK_SIZE == 64,
-                "escaped branchless block only support 32 or 64 bytes");
+  static_assert(BLOK_SIZE == 16 || BLOK_SIZE == 32 || BLOK_SIZE == 64,
+                "escaped branchless block only support 16, 32 or 64 bytes");
   backslash &= ~prev_escaped;
   uint64_t follows_escape = backslash << 1 | prev_escaped;
   const uint64_t even_bits = 0x5555555555555555ULL;
@@ -284,6 +364,11 @@ sonic_force_inline uint64_t GetEscapedBranchless(uint64_t &prev_escaped,
   } else if (BLOK_SIZE == 32) {
     prev_escaped = AddOverflow32(odd_sequence_starts, backslash,
                                  &sequences_starting_on_even_bits);
+  } else {
+    // the carry out of the 16-bit block
+    sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    prev_escaped = (sequences_starting_on_even_bits >> 16) & 1;
+    sequences_starting_on_even_bits &= 0xffff;
   }
   uint64_t invert_mask = sequences_starting_on_even_bits << 1;
   return (even_bits ^ invert_mask) & follows_escape;
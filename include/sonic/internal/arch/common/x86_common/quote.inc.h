@@ -52,6 +52,12 @@
 // #define VEC_LEN 32
 // #define VEC_FULL_MASK 0xFFFFFFFF
 
+// avx512 macros
+// #define VEC_LEN 64
+// #define VEC_FULL_MASK 0xFFFFFFFFFFFFFFFF
+
+// VecMaskType is the type of the bitmasks of VecType, it must be defined too.
+
 #define MOVE_N_CHARS(src, N) \
   {                          \
     (src) += (N);            \
@@ -61,16 +67,30 @@
 
 using common::handle_unicode_codepoint;
 
-sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+// parseStringImpl unescapes the string in place. If kValidateUtf8, the utf-8
+// chars are validated in the same loop, on the blocks being scanned or copied.
+// The escaped chars are ascii, so the chars between them are checked as
+// separate runs.
+template <bool kValidateUtf8>
+sonic_force_inline size_t parseStringImpl(uint8_t *&src, SonicError &err) {
 #define SONIC_REPEAT8(v) {v v v v v v v v}
 
   uint8_t *dst = src;
   uint8_t *sdst = src;
+  Utf8Checker utf8;
   while (1) {
   find:
     auto block = StringBlock::Find(src);
     if (block.HasQuoteFirst()) {
       int idx = block.QuoteIndex();
+      if (kValidateUtf8) {
+        utf8.UpdatePrefix(src, idx);
+        if (!utf8.Valid()) {
+          src += idx;
+          err = kParseErrorInvalidUTF8;
+          return 0;
+        }
+      }
       src += idx;
       *src++ = '\0';
       return src - sdst - 1;
@@ -80,12 +100,14 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
       return 0;
     }
     if (!block.HasBackslash()) {
+      if (kValidateUtf8) utf8.Update(src);
       src += VEC_LEN;
       goto find;
     }
 
     /* find out where the backspace is */
     auto bs_dist = block.BsIndex();
+    if (kValidateUtf8) utf8.UpdatePrefix(src, bs_dist);
     src += bs_dist;
     dst = src;
   cont:
@@ -114,12 +136,20 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
     // Copy the next n bytes, and find the backslash and quote in them.
     VecType v(src);
     block = StringBlock{
-        static_cast<uint32_t>((v == '\\').to_bitmask()),  // bs_bits
-        static_cast<uint32_t>((v == '"').to_bitmask()),   // quote_bits
-        static_cast<uint32_t>((v <= '\x1f').to_bitmask()),
+        static_cast<VecMaskType>((v == '\\').to_bitmask()),  // bs_bits
+        static_cast<VecMaskType>((v == '"').to_bitmask()),   // quote_bits
+        static_cast<VecMaskType>((v <= '\x1f').to_bitmask()),
     };
     // If the next thing is the end quote, copy and return
     if (block.HasQuoteFirst()) {
+      if (kValidateUtf8) {
+        utf8.UpdatePrefix(src, block.QuoteIndex());
+        if (!utf8.Valid()) {
+          src += block.QuoteIndex();
+          err = kParseErrorInvalidUTF8;
+          return 0;
+        }
+      }
       // we encountered quotes first. Move dst to point to quotes and exit
       while (1) {
         SONIC_REPEAT8(if (sonic_unlikely(*src == '"')) break;
@@ -136,11 +166,13 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
     if (!block.HasBackslash()) {
       /* they are the same. Since they can't co-occur, it means we
        * encountered neither. */
+      if (kValidateUtf8) utf8.Update(src);
       v.store(dst);
       src += VEC_LEN;
       dst += VEC_LEN;
       goto find_and_move;
     }
+    if (kValidateUtf8) utf8.UpdatePrefix(src, block.BsIndex());
     while (1) {
       SONIC_REPEAT8(if (sonic_unlikely(*src == '\\')) break;
                     else { *dst++ = *src++; });
@@ -151,16 +183,46 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
 #undef SONIC_REPEAT8
 }
 
-static sonic_force_inline int CopyAndGetEscapMask(const char *src, char *dst) {
+sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+  return parseStringImpl<false>(src, err);
+}
+
+// parseStringInplaceUtf8 is parseStringInplace that also validates the utf-8
+// chars, returns kParseErrorInvalidUTF8 if invalid.
+sonic_force_inline size_t parseStringInplaceUtf8(uint8_t *&src,
+                                                 SonicError &err) {
+  return parseStringImpl<true>(src, err);
+}
+
+static sonic_force_inline VecMaskType CopyAndGetEscapMask(const char *src,
+                                                          char *dst) {
   VecType v(reinterpret_cast<const uint8_t *>(src));
   v.store(reinterpret_cast<uint8_t *>(dst));
-  return ((v < '\x20') | (v == '\\') | (v == '"')).to_bitmask();
+  return static_cast<VecMaskType>(
+      ((v < '\x20') | (v == '\\') | (v == '"')).to_bitmask());
+}
+
+// The quoted buffer has only 32 bytes more than the escaped chars, so the
+// 64-byte vectors store the tail of nb bytes by mask.
+static sonic_force_inline VecMaskType CopyAndGetEscapMaskTail(const char *src,
+                                                              char *dst,
+                                                              size_t nb) {
+  VecMaskType mask = VEC_FULL_MASK >> (VEC_LEN - nb);
+#if VEC_LEN > 32
+  VecType v(reinterpret_cast<const uint8_t *>(src));
+  v.store_mask(reinterpret_cast<uint8_t *>(dst), mask);
+  return static_cast<VecMaskType>(
+             ((v < '\x20') | (v == '\\') | (v == '"')).to_bitmask()) &
+         mask;
+#else
+  return CopyAndGetEscapMask(src, dst) & mask;
+#endif
 }
 
 sonic_static_inline char *Quote(const char *src, size_t nb, char *dst) {
   *dst++ = '"';
   sonic_assert(nb < (1ULL << 32));
-  uint32_t mm;
+  VecMaskType mm;
   int cn;
 
   /* VEC_LEN-byte loop */
@@ -168,7 +230,7 @@ sonic_static_inline char *Quote(const char *src, size_t nb, char *dst) {
     /* check for matches */
     // TODO: optimize: exploit the simd bitmask in the escape block.
     if ((mm = CopyAndGetEscapMask(src, dst)) != 0) {
-      cn = __builtin_ctz(mm);
+      cn = TrailingZeroes(mm);
       MOVE_N_CHARS(src, cn);
       DoEscape(src, dst, nb);
     } else {
@@ -192,9 +254,9 @@ sonic_static_inline char *Quote(const char *src, size_t nb, char *dst) {
       src_r = tmp_src;
     }
     while (nb > 0) {
-      mm = CopyAndGetEscapMask(src_r, dst) & (VEC_FULL_MASK >> (VEC_LEN - nb));
+      mm = CopyAndGetEscapMaskTail(src_r, dst, nb);
       if (mm) {
-        cn = __builtin_ctz(mm);
+        cn = TrailingZeroes(mm);
         MOVE_N_CHARS(src_r, cn);
         DoEscape(src_r, dst, nb);
       } else {
@@ -43,7 +43,7 @@ sonic_force_inline uint8_t GetNextToken(const uint8_t *data, size_t &pos,
     for (size_t i = 0; i < N - 1; i++) {
       vor |= (v == (uint8_t)(tokens[i]));
     }
-    uint32_t next = static_cast<uint32_t>(vor.to_bitmask());
+    VecMaskType next = static_cast<VecMaskType>(vor.to_bitmask());
     if (next) {
       pos += TrailingZeroes(next);
       return data[pos];
@@ -77,7 +77,7 @@ sonic_force_inline int SkipString(const uint8_t *data, size_t &pos,
 
     // maybe has escaped quotes
     if (((quote_bits - 1) & bs_bits) || prev_escaped) {
-      escaped = common::GetEscapedBranchless<32>(prev_escaped, bs_bits);
+      escaped = common::GetEscapedBranchless<VEC_LEN>(prev_escaped, bs_bits);
       // NOTE: maybe mark the normal string as escaped, example "abc":"\\",
       // abc will marked as escaped.
       found = true;
@@ -114,6 +114,50 @@ sonic_force_inline int SkipString(const uint8_t *data, size_t &pos,
   return kUnclosed;
 }
 
+// ValidateString validates the string from pos, which is after the opening
+// quote, and updates pos to after the ending quote, or to the invalid char.
+// The utf-8 chars are validated by Utf8Checker in blocks. If there are errors,
+// the string is validated again by the scalar code to locate the invalid char.
+sonic_force_inline SonicError ValidateString(const uint8_t *data, size_t &pos,
+                                             size_t len) {
+  size_t start = pos;
+  Utf8Checker utf8;
+  uint8_t buf[VEC_LEN];
+  while (pos < len) {
+    const uint8_t *p = data + pos;
+    size_t left = len - pos;
+    if (left < VEC_LEN) {
+      // the padding zeros are control chars, so the block must stop there.
+      std::memset(buf, 0, VEC_LEN);
+      std::memcpy(buf, p, left);
+      p = buf;
+    }
+    VecUint8Type v(p);
+    VecMaskType quote = static_cast<VecMaskType>((v == '"').to_bitmask());
+    VecMaskType special =
+        quote |
+        static_cast<VecMaskType>(((v == '\\') | (v <= '\x1f')).to_bitmask());
+    if (!special) {
+      utf8.Update(p);
+      pos += VEC_LEN;
+      continue;
+    }
+    size_t n = TrailingZeroes(special);
+    if (n >= left) break;
+    utf8.UpdatePrefix(p, n);
+    if (!utf8.Valid()) break;
+    pos += n;
+    if ((quote >> n) & 1) {
+      pos++;
+      return kErrorNone;
+    }
+    SonicError err = common::ValidateStringChar(data, pos, len);
+    if (err) return err;
+  }
+  pos = start;
+  return common::ValidateStringScalar(data, pos, len);
+}
+
 // return true if container is closed.
 sonic_force_inline bool SkipContainer(const uint8_t *data, size_t &pos,
                                       size_t len, uint8_t left, uint8_t right) {
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// GetStructuralBits returns the structural bits of a 64-byte block. The
+// structural characters are the operators outside strings, the opening quote
+// of strings and the first byte of other scalars (numbers and literals).
+sonic_force_inline uint64_t GetStructuralBits(const uint8_t *data,
+                                              uint64_t &prev_instring,
+                                              uint64_t &prev_escaped,
+                                              uint64_t &prev_scalar) {
+  const simd::simd8x64<uint8_t> v(data);
+  uint64_t escaped = 0;
+  uint64_t bs_bits = v.eq('\\');
+  if (bs_bits) {
+    escaped = common::GetEscapedBranchless<64>(prev_escaped, bs_bits);
+  } else {
+    escaped = prev_escaped;
+    prev_escaped = 0;
+  }
+  uint64_t quote = v.eq('"') & ~escaped;
+  // in_string contains the opening quote, but not the closing quote.
+  uint64_t in_string = PrefixXor(quote) ^ prev_instring;
+  prev_instring = uint64_t(static_cast<int64_t>(in_string) >> 63);
+
+  uint64_t op = v.eq('{') | v.eq('}') | v.eq('[') | v.eq(']') | v.eq(':') |
+                v.eq(',');
+  uint64_t space = ~GetNonSpaceBits(data);
+  op &= ~in_string;
+
+  uint64_t scalar = ~(op | space | quote | in_string);
+  uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+  prev_scalar = scalar >> 63;
+  return op | (quote & in_string) | scalar_start;
+}
+
+// FlattenBits writes the positions of bits into out. It always writes 8
+// positions at once to avoid branch mispredictions, so the output buffer must
+// have 8 more entries.
+sonic_force_inline void FlattenBits(uint32_t *&out, uint32_t base,
+                                    uint64_t bits) {
+  if (bits == 0) return;
+  int cnt = CountOnes(bits);
+  uint32_t *p = out;
+  for (int i = 0; i < 8; i++) {
+    p[i] = base + TrailingZeroes(bits);
+    bits = ClearLowestBit(bits);
+  }
+  for (int i = 8; i < cnt; i += 8) {
+    for (int j = i; j < i + 8; j++) {
+      p[j] = base + TrailingZeroes(bits);
+      bits = ClearLowestBit(bits);
+    }
+  }
+  out += cnt;
+}
+
+// BuildStructuralIndex is the first stage of the two-stage parser. It writes
+// the positions of all structural characters in json into index, and returns
+// the count of them. The index must have the space for len + 8 entries.
+sonic_force_inline size_t BuildStructuralIndex(const uint8_t *data, size_t len,
+                                               uint32_t *index) {
+  uint64_t prev_instring = 0, prev_escaped = 0, prev_scalar = 0;
+  uint32_t *out = index;
+  size_t pos = 0;
+  for (; pos + 64 <= len; pos += 64) {
+    uint64_t bits =
+        GetStructuralBits(data + pos, prev_instring, prev_escaped, prev_scalar);
+    FlattenBits(out, pos, bits);
+  }
+  if (pos < len) {
+    // pad the remaining bytes with spaces, they are never structural.
+    uint8_t buf[64];
+    std::memset(buf, ' ', sizeof(buf));
+    std::memcpy(buf, data + pos, len - pos);
+    uint64_t bits =
+        GetStructuralBits(buf, prev_instring, prev_escaped, prev_scalar);
+    FlattenBits(out, pos, bits);
+  }
+  return out - index;
+}
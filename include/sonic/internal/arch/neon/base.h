@@ -21,6 +21,8 @@
 
 #include "sonic/macro.h"
 
+#include <cstring>
+
 #ifndef VEC_LEN
 #define VEC_LEN 16
 #endif
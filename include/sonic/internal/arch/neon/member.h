@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arm_neon.h>
+#include <sonic/macro.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base.h"
+
+namespace sonic_json {
+namespace internal {
+namespace neon {
+
+// the bitmask of the 8 tags equal to tag
+sonic_force_inline uint32_t EqTags8(const uint64_t* tags, uint64_t tag) {
+  uint64x2_t t = vdupq_n_u64(tag);
+  uint32_t bits = 0;
+  for (int i = 0; i < 4; i++) {
+    uint64x2_t eq = vceqq_u64(vld1q_u64(tags + i * 2), t);
+    // narrow the lanes to 32 bits, and take one bit of each
+    uint32x2_t n = vmovn_u64(eq);
+    bits |= ((vget_lane_u32(n, 0) & 1) | (vget_lane_u32(n, 1) & 2)) << (i * 2);
+  }
+  return bits;
+}
+
+// FindTag returns the index of the first tag equal to tag in [start, n), or n
+// if not found. The tags are padded to a multiple of 8.
+sonic_force_inline size_t FindTag(const uint64_t* tags, size_t start, size_t n,
+                                  uint64_t tag) {
+  for (size_t i = start & ~size_t(7); i < n; i += 8) {
+    uint32_t bits = EqTags8(tags + i, tag);
+    if (i < start) bits &= ~0u << (start - i);
+    if (bits) {
+      size_t j = i + TrailingZeroes(bits);
+      return j < n ? j : n;
+    }
+  }
+  return n;
+}
+
+}  // namespace neon
+}  // namespace internal
+}  // namespace sonic_json
@@ -69,16 +69,30 @@ namespace sonic_json {
 namespace internal {
 namespace neon {
 
-sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+// parseStringImpl unescapes the string in place. If kValidateUtf8, the utf-8
+// chars are validated in the same loop, on the blocks being scanned or copied.
+// The escaped chars are ascii, so the chars between them are checked as
+// separate runs.
+template <bool kValidateUtf8>
+sonic_force_inline size_t parseStringImpl(uint8_t *&src, SonicError &err) {
 #define SONIC_REPEAT8(v) {v v v v v v v v}
 
   uint8_t *dst = src;
   uint8_t *sdst = src;
+  Utf8Checker utf8;
   while (1) {
   find:
     auto block = StringBlock::Find(src);
     if (block.HasQuoteFirst()) {
       int idx = block.QuoteIndex();
+      if (kValidateUtf8) {
+        utf8.UpdatePrefix(src, idx);
+        if (!utf8.Valid()) {
+          src += idx;
+          err = kParseErrorInvalidUTF8;
+          return 0;
+        }
+      }
       src += idx;
       *src++ = '\0';
       return src - sdst - 1;
@@ -88,12 +102,14 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
       return 0;
     }
     if (!block.HasBackslash()) {
+      if (kValidateUtf8) utf8.Update(src);
       src += VEC_LEN;
       goto find;
     }
 
     /* find out where the backspace is */
     auto bs_dist = block.BsIndex();
+    if (kValidateUtf8) utf8.UpdatePrefix(src, bs_dist);
     src += bs_dist;
     dst = src;
   cont:
@@ -124,6 +140,14 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
     block = StringBlock::Find(v);
     // If the next thing is the end quote, copy and return
     if (block.HasQuoteFirst()) {
+      if (kValidateUtf8) {
+        utf8.UpdatePrefix(src, block.QuoteIndex());
+        if (!utf8.Valid()) {
+          src += block.QuoteIndex();
+          err = kParseErrorInvalidUTF8;
+          return 0;
+        }
+      }
       // we encountered quotes first. Move dst to point to quotes and exit
       while (1) {
         SONIC_REPEAT8(if (sonic_unlikely(*src == '"')) break;
@@ -140,11 +164,13 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
     if (!block.HasBackslash()) {
       /* they are the same. Since they can't co-occur, it means we
        * encountered neither. */
+      if (kValidateUtf8) utf8.Update(src);
       vst1q_u8(dst, v);
       src += VEC_LEN;
       dst += VEC_LEN;
       goto find_and_move;
     }
+    if (kValidateUtf8) utf8.UpdatePrefix(src, block.BsIndex());
     while (1) {
       SONIC_REPEAT8(if (sonic_unlikely(*src == '\\')) break;
                     else { *dst++ = *src++; });
@@ -155,6 +181,17 @@ sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
 #undef SONIC_REPEAT8
 }
 
+sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+  return parseStringImpl<false>(src, err);
+}
+
+// parseStringInplaceUtf8 is parseStringInplace that also validates the utf-8
+// chars, returns kParseErrorInvalidUTF8 if invalid.
+sonic_force_inline size_t parseStringInplaceUtf8(uint8_t *&src,
+                                                 SonicError &err) {
+  return parseStringImpl<true>(src, err);
+}
+
 static sonic_force_inline uint64_t CopyAndGetEscapMask128(const char *src,
                                                           char *dst) {
   uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(src));
@@ -121,6 +121,50 @@ sonic_force_inline int SkipString(const uint8_t *data, size_t &pos,
   return kUnclosed;
 }
 
+// ValidateString validates the string from pos, which is after the opening
+// quote, and updates pos to after the ending quote, or to the invalid char.
+// The utf-8 chars are validated by Utf8Checker in blocks. If there are errors,
+// the string is validated again by the scalar code to locate the invalid char.
+sonic_force_inline SonicError ValidateString(const uint8_t *data, size_t &pos,
+                                             size_t len) {
+  size_t start = pos;
+  Utf8Checker utf8;
+  uint8_t buf[VEC_LEN];
+  while (pos < len) {
+    const uint8_t *p = data + pos;
+    size_t left = len - pos;
+    if (left < VEC_LEN) {
+      // the padding zeros are control chars, so the block must stop there.
+      std::memset(buf, 0, VEC_LEN);
+      std::memcpy(buf, p, left);
+      p = buf;
+    }
+    uint8x16_t v = vld1q_u8(p);
+    uint64_t quote = to_bitmask(vceqq_u8(v, vdupq_n_u8('"')));
+    uint64_t special =
+        quote | to_bitmask(vorrq_u8(vceqq_u8(v, vdupq_n_u8('\\')),
+                                    vcleq_u8(v, vdupq_n_u8('\x1f'))));
+    if (!special) {
+      utf8.Update(p);
+      pos += VEC_LEN;
+      continue;
+    }
+    size_t n = TrailingZeroes(special) >> 2;
+    if (n >= left) break;
+    utf8.UpdatePrefix(p, n);
+    if (!utf8.Valid()) break;
+    pos += n;
+    if ((quote >> (n * 4)) & 1) {
+      pos++;
+      return kErrorNone;
+    }
+    SonicError err = common::ValidateStringChar(data, pos, len);
+    if (err) return err;
+  }
+  pos = start;
+  return common::ValidateStringScalar(data, pos, len);
+}
+
 // return true if container is closed.
 sonic_force_inline bool SkipContainer(const uint8_t *data, size_t &pos,
                                       size_t len, uint8_t left, uint8_t right) {
@@ -95,6 +95,70 @@ sonic_force_inline uint64_t GetNonSpaceBits(const uint8_t *data) {
   return to_bitmask(m8);
 }
 
+// Utf8Checker validates the utf-8 chars block by block with the lookup tables
+// in unicode_common.h. The errors are accumulated and checked at last by
+// Valid, so the check has no branch in the hot loop except for ascii blocks.
+struct Utf8Checker {
+ public:
+  sonic_force_inline Utf8Checker()
+      : error_(vdupq_n_u8(0)),
+        prev_input_(vdupq_n_u8(0)),
+        prev_incomplete_(vdupq_n_u8(0)) {}
+
+  // Check the 16 bytes from src, which follow the bytes checked last time.
+  sonic_force_inline void Update(const uint8_t *src) { check(vld1q_u8(src)); }
+
+  // Check the first n (n < 16) bytes from src. The chars must end before the
+  // n-th byte, and the next bytes to check are not following them.
+  sonic_force_inline void UpdatePrefix(const uint8_t *src, size_t n) {
+    static const uint8_t kIndex[16] = {0, 1, 2,  3,  4,  5,  6,  7,
+                                       8, 9, 10, 11, 12, 13, 14, 15};
+    uint8x16_t mask =
+        vcltq_u8(vld1q_u8(kIndex), vdupq_n_u8(static_cast<uint8_t>(n)));
+    check(vandq_u8(vld1q_u8(src), mask));
+    prev_input_ = vdupq_n_u8(0);
+  }
+
+  // Whether all the checked chars are valid and complete.
+  sonic_force_inline bool Valid() const {
+    return vmaxvq_u8(vorrq_u8(error_, prev_incomplete_)) == 0;
+  }
+
+ private:
+  sonic_force_inline void check(uint8x16_t input) {
+    if (vmaxvq_u8(input) < 0x80) {
+      // the ascii block, only check the incomplete chars before it.
+      error_ = vorrq_u8(error_, prev_incomplete_);
+    } else {
+      static const uint8_t kMaxValue[16] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                            0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                            0xff, 0xef, 0xdf, 0xbf};
+      uint8x16_t prev1 = vextq_u8(prev_input_, input, 16 - 1);
+      uint8x16_t special = vandq_u8(
+          vandq_u8(vqtbl1q_u8(vld1q_u8(common::kUtf8Byte1High),
+                              vshrq_n_u8(prev1, 4)),
+                   vqtbl1q_u8(vld1q_u8(common::kUtf8Byte1Low),
+                              vandq_u8(prev1, vdupq_n_u8(0x0f)))),
+          vqtbl1q_u8(vld1q_u8(common::kUtf8Byte2High), vshrq_n_u8(input, 4)));
+      // the 3rd and 4th bytes of the multi-byte chars must be continuations.
+      uint8x16_t prev2 = vextq_u8(prev_input_, input, 16 - 2);
+      uint8x16_t prev3 = vextq_u8(prev_input_, input, 16 - 3);
+      uint8x16_t must23 =
+          vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xe0 - 0x80)),
+                   vqsubq_u8(prev3, vdupq_n_u8(0xf0 - 0x80)));
+      must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+      error_ = vorrq_u8(error_, veorq_u8(must23, special));
+      // the multi-byte chars at the end of block are incomplete.
+      prev_incomplete_ = vqsubq_u8(input, vld1q_u8(kMaxValue));
+    }
+    prev_input_ = input;
+  }
+
+  uint8x16_t error_;
+  uint8x16_t prev_input_;
+  uint8x16_t prev_incomplete_;
+};
+
 }  // namespace neon
 }  // namespace internal
 }  // namespace sonic_json
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+// Convert num's each digit as a byte in uint64, the first digit is the lowest
+// byte. num's digits as abcdefgh (high digits is 0 if not enough). It divides
+// all parts in parallel by the multiplications, as the SIMD versions.
+sonic_force_inline uint64_t UtoaSwar(uint32_t num) {
+  // merged = {abcd, efgh} in 32-bit lanes
+  uint64_t merged = (num / 10000) | (uint64_t(num % 10000) << 32);
+  // divide by 100: {ab, cd, ef, gh} in 16-bit lanes
+  uint64_t top = ((merged * 10486) >> 20) & 0x0000007F0000007FULL;
+  uint64_t bot = merged - 100 * top;
+  uint64_t hundreds = (bot << 16) + top;
+  // divide by 10: {a, b, c, d, e, f, g, h} in 8-bit lanes
+  uint64_t tens = ((hundreds * 103) >> 10) & 0x000F000F000F000FULL;
+  tens += (hundreds - 10 * tens) << 8;
+  return tens;
+}
+
+static sonic_force_inline char *Utoa_8(uint32_t val, char *out) {
+  uint64_t digits = UtoaSwar(val) | 0x3030303030303030ULL;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  digits = __builtin_bswap64(digits);
+#endif
+  std::memcpy(out, &digits, 8);
+  return out + 8;
+}
+
+static sonic_force_inline char *Utoa_16(uint64_t val, char *out) {
+  Utoa_8((uint32_t)(val / 100000000), out);
+  return Utoa_8((uint32_t)(val % 100000000), out + 8);
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+// FindTag returns the index of the first tag equal to tag in [start, n), or n
+// if not found. The tags are padded to a multiple of 8.
+sonic_force_inline size_t FindTag(const uint64_t* tags, size_t start, size_t n,
+                                  uint64_t tag) {
+  for (size_t i = start; i < n; i++) {
+    if (tags[i] == tag) return i;
+  }
+  return n;
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
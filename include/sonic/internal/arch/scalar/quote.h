@@ -0,0 +1,133 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/error.h>
+#include <sonic/macro.h>
+
+#include <cstring>
+
+#include "../common/quote_common.h"
+#include "../common/quote_tables.h"
+#include "../common/skip_common.h"
+#include "base.h"
+#include "unicode.h"
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+// parseStringImpl unescapes the string in place, 8 bytes at once. It reads
+// beyond the ending quote as the SIMD kernels, so the json must be padded. If
+// kValidateUtf8, the non-ascii chars also stop the fast path and are checked
+// one by one.
+template <bool kValidateUtf8>
+sonic_force_inline size_t parseStringImpl(uint8_t *&src, SonicError &err) {
+  uint8_t *const sdst = src;
+  uint8_t *dst = nullptr;  // not null after the first escaped char
+  while (true) {
+    uint64_t bits = StringBits<kValidateUtf8>(LoadU64(src));
+    size_t n = bits ? ByteIndex(bits) : 8;
+    if (dst) {
+      std::memmove(dst, src, n);
+      dst += n;
+    }
+    src += n;
+    if (!bits) continue;
+
+    uint8_t c = *src;
+    if (c == '"') {
+      uint8_t *end = dst ? dst : src;
+      *end = '\0';
+      src++;
+      return end - sdst;
+    }
+    if (c == '\\') {
+      if (!dst) dst = src;
+      if (src[1] == 'u') {
+        if (!handle_unicode_codepoint(const_cast<const uint8_t **>(&src),
+                                      &dst)) {
+          err = kParseErrorEscapedUnicode;
+          return 0;
+        }
+      } else {
+        *dst = kEscapedMap[src[1]];
+        if (*dst == 0u) {
+          err = kParseErrorEscapedFormat;
+          return 0;
+        }
+        src += 2;
+        dst += 1;
+      }
+      continue;
+    }
+    if (c < 0x20) {
+      err = kParseErrorUnEscaped;
+      return 0;
+    }
+    // the first byte of a multi-byte utf-8 char, only if kValidateUtf8
+    size_t nc = 0;
+    if (!common::ValidateUtf8Char(src, nc, 4)) {
+      err = kParseErrorInvalidUTF8;
+      return 0;
+    }
+    if (dst) {
+      std::memmove(dst, src, nc);
+      dst += nc;
+    }
+    src += nc;
+  }
+}
+
+sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+  return parseStringImpl<false>(src, err);
+}
+
+// parseStringInplaceUtf8 is parseStringInplace that also validates the utf-8
+// chars, returns kParseErrorInvalidUTF8 if invalid.
+sonic_force_inline size_t parseStringInplaceUtf8(uint8_t *&src,
+                                                 SonicError &err) {
+  return parseStringImpl<true>(src, err);
+}
+
+sonic_static_inline char *Quote(const char *src, size_t nb, char *dst) {
+  *dst++ = '"';
+  sonic_assert(nb < (1ULL << 32));
+  while (nb >= 8) {
+    uint64_t bits = StringBits(LoadU64(src));
+    size_t n = bits ? ByteIndex(bits) : 8;
+    std::memcpy(dst, src, 8);
+    src += n;
+    dst += n;
+    nb -= n;
+    if (bits) DoEscape(src, dst, nb);
+  }
+  while (nb > 0) {
+    if (kNeedEscaped[*(uint8_t *)src]) {
+      DoEscape(src, dst, nb);
+    } else {
+      *dst++ = *src++;
+      nb--;
+    }
+  }
+  *dst++ = '"';
+  return dst;
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
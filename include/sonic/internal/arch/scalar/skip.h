@@ -0,0 +1,186 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../common/skip_common.h"
+#include "base.h"
+#include "quote.h"
+#include "sonic/dom/json_pointer.h"
+#include "sonic/error.h"
+#include "sonic/internal/utils.h"
+#include "sonic/macro.h"
+#include "unicode.h"
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+using sonic_json::internal::common::EqBytes4;
+using sonic_json::internal::common::SkipLiteral;
+
+// GetNextToken find the next characters in tokens and update the position to
+// it.
+template <size_t N>
+sonic_force_inline uint8_t GetNextToken(const uint8_t *data, size_t &pos,
+                                        size_t len, const char (&tokens)[N]) {
+  while (pos + 8 <= len) {
+    uint64_t v = LoadU64(data + pos);
+    uint64_t bits = 0;
+    for (size_t i = 0; i < N - 1; i++) {
+      bits |= EqBits(v, tokens[i]);
+    }
+    if (bits) {
+      pos += ByteIndex(bits);
+      return data[pos];
+    }
+    pos += 8;
+  }
+  while (pos < len) {
+    for (size_t i = 0; i < N - 1; i++) {
+      if (data[pos] == tokens[i]) {
+        return tokens[i];
+      }
+    }
+    pos++;
+  }
+  return '\0';
+}
+
+// pos is the after the ending quote
+sonic_force_inline int SkipString(const uint8_t *data, size_t &pos,
+                                  size_t len) {
+  const static int kEscaped = 2;
+  const static int kNormal = 1;
+  const static int kUnclosed = 0;
+  bool found = false;
+  while (pos + 8 <= len) {
+    uint64_t v = LoadU64(data + pos);
+    uint64_t bits = EqBits(v, '"') | EqBits(v, '\\');
+    if (!bits) {
+      pos += 8;
+      continue;
+    }
+    pos += ByteIndex(bits);
+    if (data[pos] == '"') {
+      pos++;
+      return found ? kEscaped : kNormal;
+    }
+    found = true;
+    pos += 2;
+  }
+
+  while (pos < len) {
+    if (data[pos] == '\\') {
+      if (pos + 1 >= len) {
+        return kUnclosed;
+      }
+      found = true;
+      pos += 2;
+      continue;
+    }
+    if (data[pos++] == '"') {
+      return found ? kEscaped : kNormal;
+    }
+  };
+  return kUnclosed;
+}
+
+// ValidateString validates the string from pos, which is after the opening
+// quote, and updates pos to after the ending quote, or to the invalid char.
+sonic_force_inline SonicError ValidateString(const uint8_t *data, size_t &pos,
+                                             size_t len) {
+  while (pos + 8 <= len) {
+    uint64_t bits = StringBits<true>(LoadU64(data + pos));
+    if (!bits) {
+      pos += 8;
+      continue;
+    }
+    pos += ByteIndex(bits);
+    if (data[pos] == '"') {
+      pos++;
+      return kErrorNone;
+    }
+    SonicError err = common::ValidateStringChar(data, pos, len);
+    if (err) return err;
+  }
+  return common::ValidateStringScalar(data, pos, len);
+}
+
+// return true if container is closed.
+sonic_force_inline bool SkipContainer(const uint8_t *data, size_t &pos,
+                                      size_t len, uint8_t left, uint8_t right) {
+  int depth = 1;
+  while (pos < len) {
+    if (pos + 8 <= len) {
+      uint64_t v = LoadU64(data + pos);
+      uint64_t bits = EqBits(v, '"') | EqBits(v, left) | EqBits(v, right);
+      if (!bits) {
+        pos += 8;
+        continue;
+      }
+      pos += ByteIndex(bits);
+    }
+    uint8_t c = data[pos++];
+    if (c == '"') {
+      if (!SkipString(data, pos, len)) return false;
+    } else if (c == left) {
+      depth++;
+    } else if (c == right && --depth == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+sonic_force_inline uint8_t skip_space(const uint8_t *data, size_t &pos,
+                                      size_t &, uint64_t &) {
+  // fast path for single space
+  if (!IsSpace(data[pos++])) return data[pos - 1];
+  if (!IsSpace(data[pos++])) return data[pos - 1];
+
+  // the padding chars are not spaces, so the loop always stops.
+  while (true) {
+    uint64_t nonspace = NonSpaceBits(LoadU64(data + pos));
+    if (nonspace) {
+      pos += ByteIndex(nonspace);
+      return data[pos++];
+    }
+    pos += 8;
+  }
+}
+
+sonic_force_inline uint8_t skip_space_safe(const uint8_t *data, size_t &pos,
+                                           size_t len, size_t &, uint64_t &) {
+  // fast path for no space
+  if (pos < len && !IsSpace(data[pos])) return data[pos++];
+  while (pos + 8 <= len) {
+    uint64_t nonspace = NonSpaceBits(LoadU64(data + pos));
+    if (nonspace) {
+      pos += ByteIndex(nonspace);
+      return data[pos++];
+    }
+    pos += 8;
+  }
+  while (pos < len && IsSpace(data[pos++]))
+    ;
+  // if not found, still return the space chars
+  return data[pos - 1];
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/internal/utils.h>
+#include <sonic/macro.h>
+
+#include <cstdint>
+
+#include "base.h"
+#include "unicode.h"
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+// BuildStructuralIndex is the first stage of the two-stage parser. It writes
+// the positions of all structural characters in json into index, and returns
+// the count of them. The index must have the space for len + 8 entries. It is
+// a byte-by-byte state machine that has the same results as the SIMD
+// GetStructuralBits, and skips the string bodies 8 bytes at once.
+sonic_force_inline size_t BuildStructuralIndex(const uint8_t *data, size_t len,
+                                               uint32_t *index) {
+  uint32_t *out = index;
+  bool in_string = false, escaped = false, prev_scalar = false;
+  size_t pos = 0;
+  while (pos < len) {
+    if (in_string && !escaped && pos + 8 <= len) {
+      uint64_t v = LoadU64(data + pos);
+      uint64_t bits = EqBits(v, '"') | EqBits(v, '\\');
+      if (!bits) {
+        pos += 8;
+        continue;
+      }
+      pos += ByteIndex(bits);
+    }
+    uint8_t c = data[pos];
+    bool quote = c == '"' && !escaped;
+    escaped = c == '\\' && !escaped;
+    if (in_string) {
+      // the closing quote is not structural
+      in_string = !quote;
+    } else if (quote) {
+      *out++ = pos;
+      in_string = true;
+      prev_scalar = false;
+    } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' ||
+               c == ',') {
+      *out++ = pos;
+      prev_scalar = false;
+    } else if (IsSpace(c)) {
+      prev_scalar = false;
+    } else {
+      // the first byte of numbers and literals
+      if (!prev_scalar) *out++ = pos;
+      prev_scalar = true;
+    }
+    pos++;
+  }
+  return out - index;
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "../common/unicode_common.h"
+#include "base.h"
+
+namespace sonic_json {
+namespace internal {
+namespace scalar {
+
+using common::handle_unicode_codepoint;
+
+// The scalar kernels scan 8 bytes at once in a uint64_t (SWAR). The helpers
+// below return the high bit of each matched byte. Except the exact ones, the
+// bits above the first match may be false positives because of the borrows, so
+// only the lowest bit can be used, as ByteIndex does.
+static constexpr uint64_t kLowBytes = 0x0101010101010101ULL;
+static constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+sonic_force_inline uint64_t LoadU64(const void *src) {
+  uint64_t v;
+  std::memcpy(&v, src, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  // make the first byte in memory to be the lowest byte
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+// The index of the first matched byte, bits must not be zero.
+sonic_force_inline size_t ByteIndex(uint64_t bits) {
+  return TrailingZeroes(bits) >> 3;
+}
+
+sonic_force_inline uint64_t EqBits(uint64_t v, uint8_t c) {
+  uint64_t x = v ^ (kLowBytes * c);
+  return (x - kLowBytes) & ~x & kHighBits;
+}
+
+// The bytes less than c, c must not be larger than 0x80.
+sonic_force_inline uint64_t LessBits(uint64_t v, uint8_t c) {
+  return (v - kLowBytes * c) & ~v & kHighBits;
+}
+
+// EqBitsExact has no false positives, but is slower than EqBits.
+sonic_force_inline uint64_t EqBitsExact(uint64_t v, uint8_t c) {
+  uint64_t x = v ^ (kLowBytes * c);
+  uint64_t t = (x & ~kHighBits) + ~kHighBits;
+  return ~(t | x | ~kHighBits);
+}
+
+// The quotes, backslashes and control chars in a string, and the non-ascii
+// chars if kWithUtf8.
+template <bool kWithUtf8 = false>
+sonic_force_inline uint64_t StringBits(uint64_t v) {
+  uint64_t bits = EqBits(v, '"') | EqBits(v, '\\') | LessBits(v, 0x20);
+  if (kWithUtf8) bits |= v & kHighBits;
+  return bits;
+}
+
+sonic_force_inline uint64_t NonSpaceBits(uint64_t v) {
+  uint64_t space = EqBitsExact(v, ' ') | EqBitsExact(v, '\t') |
+                   EqBitsExact(v, '\n') | EqBitsExact(v, '\r');
+  return ~space & kHighBits;
+}
+
+}  // namespace scalar
+}  // namespace internal
+}  // namespace sonic_json
@@ -25,17 +25,26 @@
 #if defined(SONIC_STATIC_DISPATCH)
 
 // clang-format off
-#if defined(SONIC_HAVE_AVX2)
+// The x86 kernels need PCLMUL. The scalar backend is used if
+// SONIC_FORCE_SCALAR is defined, or no SIMD kernel fits the compiler flags.
+#if defined(SONIC_FORCE_SCALAR)
+#define SONIC_USING_ARCH_FUNC(func) using scalar::func
+#define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(scalar/file)
+#elif defined(SONIC_HAVE_AVX512BW) && defined(__PCLMUL__)
+#define SONIC_USING_ARCH_FUNC(func) using avx512::func
+#define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(avx512/file)
+#elif defined(SONIC_HAVE_AVX2) && defined(__PCLMUL__)
 #define SONIC_USING_ARCH_FUNC(func) using avx2::func
 #define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(avx2/file)
-#elif defined(SONIC_HAVE_SSE)
+#elif defined(SONIC_HAVE_SSE4_2) && defined(__PCLMUL__)
 #define SONIC_USING_ARCH_FUNC(func) using sse::func
 #define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(sse/file)
-#endif
-
-#if defined(SONIC_HAVE_NEON)
+#elif defined(SONIC_HAVE_NEON)
 #define SONIC_USING_ARCH_FUNC(func) using neon::func
 #define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(neon/file)
+#else
+#define SONIC_USING_ARCH_FUNC(func) using scalar::func
+#define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(scalar/file)
 #endif
 
 #elif defined(SONIC_DYNAMIC_DISPATCH)
@@ -46,6 +55,9 @@
 #elif defined(SONIC_HAVE_NEON)
 #define SONIC_USING_ARCH_FUNC(func) using neon::func
 #define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(neon/file)
+#else
+#define SONIC_USING_ARCH_FUNC(func) using scalar::func
+#define INCLUDE_ARCH_FILE(file) SONIC_STRINGIFY(scalar/file)
 #endif
 
 #endif
@@ -24,6 +24,7 @@ namespace sonic_json {
 namespace internal {
 
 SONIC_USING_ARCH_FUNC(parseStringInplace);
+SONIC_USING_ARCH_FUNC(parseStringInplaceUtf8);
 SONIC_USING_ARCH_FUNC(Quote);
 
 }  // namespace internal
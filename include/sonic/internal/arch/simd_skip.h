@@ -17,6 +17,7 @@
 #pragma once
 
 #include "simd_dispatch.h"
+#include "simd_quote.h"
 
 #include INCLUDE_ARCH_FILE(skip.h)
 
@@ -28,6 +29,7 @@ SONIC_USING_ARCH_FUNC(SkipLiteral);
 SONIC_USING_ARCH_FUNC(GetNextToken);
 SONIC_USING_ARCH_FUNC(SkipString);
 SONIC_USING_ARCH_FUNC(SkipContainer);
+SONIC_USING_ARCH_FUNC(ValidateString);
 SONIC_USING_ARCH_FUNC(skip_space);
 SONIC_USING_ARCH_FUNC(skip_space_safe);
 
@@ -182,9 +184,9 @@ class SkipScanner {
     if (!skips) goto err_invalid_char;
     if (skips == 2) {
       // parse escaped key
-      kbuf.resize(sn + 32);
+      kbuf.resize(sn + SONICJSON_PADDING);
       uint8_t *nsrc = &kbuf[0];
-      std::memcpy(nsrc, sp, sn);
+      std::memcpy(nsrc, sp, sn + 1);  // with the ending quote
       sn = parseStringInplace(nsrc, err);
       if (err) {
         pos = (sp - data) + (nsrc - &kbuf[0]);
@@ -241,7 +243,162 @@ class SkipScanner {
     return -kParseErrorInvalidChar;
   }
 
+  // GetOnDemandMulti resolves all paths of the trie in one pass, and skips the
+  // values that no path needs. targets must be empty views at first, and
+  // targets[i] is set to the raw json of the i-th path if found. The scan
+  // stops as soon as all paths are found.
+  template <typename Trie>
+  SonicError GetOnDemandMulti(StringView json, size_t &pos, const Trie &trie,
+                              StringView *targets) {
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(json.data());
+    remain_ = trie.Size();
+    std::vector<uint8_t> kbuf(32);  // key buffer for escaped keys
+    return walkTrie(data, pos, json.size(), trie, 0, targets, kbuf);
+  }
+
  private:
+  template <typename Trie>
+  SonicError walkTrie(const uint8_t *data, size_t &pos, size_t len,
+                      const Trie &trie, size_t cur, StringView *targets,
+                      std::vector<uint8_t> &kbuf) {
+    const auto &node = trie.GetNode(cur);
+    uint8_t c = SkipSpaceSafe(data, pos, len);
+    size_t start = pos - 1;
+    SonicError err = kErrorNone;
+    if (c == '{' && !node.keys.empty()) {
+      err = walkObject(data, pos, len, trie, cur, targets, kbuf);
+    } else if (c == '[' && !node.indexes.empty()) {
+      err = walkArray(data, pos, len, trie, cur, targets, kbuf);
+    } else {
+      pos = start;
+      long s = SkipOne(data, pos, len);
+      if (s < 0) {
+        pos -= 1;
+        return SonicError(-s);
+      }
+    }
+    if (err || remain_ == 0) return err;
+    for (size_t i : node.paths) {
+      if (targets[i].data() == nullptr) {
+        targets[i] = StringView(reinterpret_cast<const char *>(data + start),
+                                pos - start);
+        remain_--;
+      }
+    }
+    return kErrorNone;
+  }
+
+  template <typename Trie>
+  SonicError walkObject(const uint8_t *data, size_t &pos, size_t len,
+                        const Trie &trie, size_t cur, StringView *targets,
+                        std::vector<uint8_t> &kbuf) {
+    const auto &node = trie.GetNode(cur);
+    // each key of the trie is counted once, as the keys may be duplicated
+    size_t matched = 0;
+    uint64_t seen_bits = 0;
+    std::vector<bool> seen(node.keys.size() > 64 ? node.keys.size() : 0);
+    SonicError err = kErrorNone;
+    uint8_t c = SkipSpaceSafe(data, pos, len);
+    if (c == '}') return kErrorNone;
+    while (true) {
+      if (c != '"') goto err_invalid_char;
+      {
+        const uint8_t *sp = data + pos;
+        int skips = SkipString(data, pos, len);
+        long sn = data + pos - 1 - sp;
+        if (!skips) goto err_invalid_char;
+        if (skips == 2) {
+          kbuf.resize(sn + SONICJSON_PADDING);
+          uint8_t *nsrc = &kbuf[0];
+          std::memcpy(nsrc, sp, sn + 1);  // with the ending quote
+          sn = parseStringInplace(nsrc, err);
+          if (err) {
+            pos = (sp - data) + (nsrc - &kbuf[0]);
+            return err;
+          }
+          sp = &kbuf[0];
+        }
+        if (SkipSpaceSafe(data, pos, len) != ':') goto err_invalid_char;
+        size_t child = 0;
+        size_t ki = 0;
+        for (; ki < node.keys.size(); ki++) {
+          const auto &k = node.keys[ki];
+          if (static_cast<long>(k.first.size()) == sn &&
+              std::memcmp(sp, k.first.data(), sn) == 0) {
+            child = k.second;
+            break;
+          }
+        }
+        if (child) {
+          if (ki < 64) {
+            matched += !((seen_bits >> ki) & 1);
+            seen_bits |= 1ull << ki;
+          } else {
+            matched += !seen[ki];
+            seen[ki] = true;
+          }
+          err = walkTrie(data, pos, len, trie, child, targets, kbuf);
+          if (err || remain_ == 0) return err;
+        } else {
+          long s = SkipOne(data, pos, len);
+          if (s < 0) {
+            pos -= 1;
+            return SonicError(-s);
+          }
+        }
+      }
+      c = SkipSpaceSafe(data, pos, len);
+      if (c == '}') return kErrorNone;
+      if (c != ',') goto err_invalid_char;
+      // all keys of the trie are visited, skip the remained fields
+      if (matched == node.keys.size()) {
+        return SkipObject(data, pos, len) ? kErrorNone
+                                          : kParseErrorInvalidChar;
+      }
+      c = SkipSpaceSafe(data, pos, len);
+    }
+  err_invalid_char:
+    pos -= 1;
+    return kParseErrorInvalidChar;
+  }
+
+  template <typename Trie>
+  SonicError walkArray(const uint8_t *data, size_t &pos, size_t len,
+                       const Trie &trie, size_t cur, StringView *targets,
+                       std::vector<uint8_t> &kbuf) {
+    const auto &indexes = trie.GetNode(cur).indexes;
+    size_t k = 0;
+    uint8_t c = SkipSpaceSafe(data, pos, len);
+    if (c == ']') return kErrorNone;
+    pos -= 1;
+    for (int idx = 0;; idx++) {
+      while (k < indexes.size() && indexes[k].first < idx) k++;
+      if (k < indexes.size() && indexes[k].first == idx) {
+        SonicError err =
+            walkTrie(data, pos, len, trie, indexes[k].second, targets, kbuf);
+        if (err || remain_ == 0) return err;
+        k++;
+      } else {
+        long s = SkipOne(data, pos, len);
+        if (s < 0) {
+          pos -= 1;
+          return SonicError(-s);
+        }
+      }
+      c = SkipSpaceSafe(data, pos, len);
+      if (c == ']') return kErrorNone;
+      if (c != ',') {
+        pos -= 1;
+        return kParseErrorInvalidChar;
+      }
+      // all indexes are visited, skip the remained elements
+      if (k == indexes.size()) {
+        return SkipArray(data, pos, len) ? kErrorNone : kParseErrorInvalidChar;
+      }
+    }
+  }
+
+  size_t remain_{0};
   size_t nonspace_bits_end_{0};
   uint64_t nonspace_bits_{0};
 };
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <sonic/internal/utils.h>
+#include <sonic/macro.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#include "simd_dispatch.h"
+
+#include INCLUDE_ARCH_FILE(structural.h)
+
+namespace sonic_json {
+namespace internal {
+
+SONIC_USING_ARCH_FUNC(BuildStructuralIndex);
+
+// StructuralScanner indexes all structural characters of the json text at
+// first, and then returns them one by one. It has the same SkipSpace interface
+// as SkipScanner, so the parser can be driven by the both.
+class StructuralScanner {
+ public:
+  StructuralScanner() noexcept = default;
+  StructuralScanner(const StructuralScanner &) = delete;
+  StructuralScanner &operator=(const StructuralScanner &) = delete;
+  StructuralScanner(StructuralScanner &&rhs) noexcept
+      : index_(rhs.index_), cap_(rhs.cap_), next_(rhs.next_), end_(rhs.end_) {
+    rhs.index_ = rhs.next_ = rhs.end_ = nullptr;
+    rhs.cap_ = 0;
+  }
+  StructuralScanner &operator=(StructuralScanner &&rhs) noexcept {
+    std::swap(index_, rhs.index_);
+    std::swap(cap_, rhs.cap_);
+    std::swap(next_, rhs.next_);
+    std::swap(end_, rhs.end_);
+    return *this;
+  }
+  ~StructuralScanner() noexcept { std::free(index_); }
+
+  // Index builds the structural index for json. Return false if json is too
+  // large for 32-bit positions or no memory.
+  bool Index(const uint8_t *data, size_t len) {
+    if (len >= UINT32_MAX) return false;
+    // stage 1 writes 8 more entries at most
+    if (len + 8 > cap_) {
+      uint32_t *index =
+          static_cast<uint32_t *>(std::realloc(index_, (len + 8) * 4));
+      if (!index) return false;
+      index_ = index;
+      cap_ = len + 8;
+    }
+    size_t n = BuildStructuralIndex(data, len, index_);
+    // the sentinel points to the padding chars after json.
+    index_[n] = static_cast<uint32_t>(len);
+    next_ = index_;
+    end_ = index_ + n;
+    return true;
+  }
+
+  sonic_force_inline uint8_t SkipSpace(const uint8_t *data, size_t &pos) {
+    size_t next = *next_;
+    // A scalar must end before a space or the next structural char, such as
+    // `1.2x` and `truex` are invalid.
+    if (sonic_unlikely(pos != next && !IsSpace(data[pos]))) {
+      return data[pos++];
+    }
+    if (sonic_likely(next_ != end_)) next_++;
+    pos = next + 1;
+    return data[next];
+  }
+
+ private:
+  uint32_t *index_{nullptr};
+  size_t cap_{0};
+  uint32_t *next_{nullptr};
+  uint32_t *end_{nullptr};
+};
+
+}  // namespace internal
+}  // namespace sonic_json
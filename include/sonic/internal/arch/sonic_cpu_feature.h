@@ -37,6 +37,9 @@
 #if defined(__AVX2__)
 #define SONIC_HAVE_AVX2
 #endif
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#define SONIC_HAVE_AVX512BW
+#endif
 #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
 #define SONIC_HAVE_NEON
 #elif defined(__ARM_FEATURE_SVE)
@@ -20,6 +20,8 @@
 #include <immintrin.h>
 #include <sonic/macro.h>
 
+#include <cstring>
+
 SONIC_PUSH_WESTMERE
 
 namespace sonic_json {
@@ -58,15 +60,10 @@ sonic_force_inline long long int CountOnes(uint64_t input_num) {
 }
 
 sonic_force_inline uint64_t PrefixXor(const uint64_t bitmask) {
-#if __PCLMUL__
   __m128i all_ones = _mm_set1_epi8('\xFF');
   __m128i result =
       _mm_clmulepi64_si128(_mm_set_epi64x(0ULL, bitmask), all_ones, 0);
   return _mm_cvtsi128_si64(result);
-#else
-#error "PCLMUL instruction set required. Missing option -mpclmul ?"
-  return 0;
-#endif
 }
 
 template <size_t ChunkSize>
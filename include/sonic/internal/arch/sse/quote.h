@@ -39,6 +39,7 @@ namespace sonic_json {
 namespace internal {
 namespace sse {
 
+using VecMaskType = uint32_t;
 using VecType = simd::simd128<uint8_t>;
 #include "../common/x86_common/quote.inc.h"
 
@@ -128,7 +128,13 @@ struct simd128<bool> : base128<bool> {
 template <typename T>
 struct num128 : base128<T> {
   using Base = base128<T>;
-  using Base::Base;
+  // using Base::Base;
+  sonic_force_inline num128() : base128<T>() {}
+  sonic_force_inline num128(const __m128i _value) : base128<T>(_value) {}
+  sonic_force_inline num128(const T _value) : base128<T>(splat(_value)) {}
+  sonic_force_inline num128(const T values[16]) : base128<T>(load(values)) {}
+  sonic_force_inline num128(REPEAT16_ARGS(T))
+      : base128<T>(_mm_setr_epi8(REPEAT16_ARGS())) {}
   static sonic_force_inline simd128<T> zero() { return _mm_setzero_si128(); }
 
   // Addition/subtraction are the same for signed and unsigned
@@ -176,7 +182,15 @@ struct simd128<int8_t> : num128<int8_t> {
 template <>
 struct simd128<uint8_t> : num128<uint8_t> {
   using Base = num128<uint8_t>;
-  using Base::Base;
+  // using Base::Base;
+  sonic_force_inline simd128() : num128<uint8_t>() {}
+  sonic_force_inline simd128(const __m128i _value) : num128<uint8_t>(_value) {}
+  sonic_force_inline simd128(const uint8_t _value)
+      : num128<uint8_t>(splat(_value)) {}
+  sonic_force_inline simd128(const uint8_t values[16])
+      : num128<uint8_t>(load(values)) {}
+  sonic_force_inline simd128(REPEAT16_ARGS(uint8_t))
+      : num128<uint8_t>(_mm_setr_epi8(REPEAT16_ARGS())) {}
 
   // Saturated math
   sonic_force_inline simd128<uint8_t> saturating_add(
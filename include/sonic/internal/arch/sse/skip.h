@@ -36,6 +36,7 @@ namespace sonic_json {
 namespace internal {
 namespace sse {
 
+using VecMaskType = uint32_t;
 using VecUint8Type = simd::simd128<uint8_t>;
 using VecBoolType = simd::simd128<bool>;
 using sonic_json::internal::common::EqBytes4;
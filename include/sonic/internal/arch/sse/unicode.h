@@ -98,6 +98,83 @@ sonic_force_inline uint64_t GetNonSpaceBits(const uint8_t *data) {
   return ~space;
 }
 
+// Utf8Checker validates the utf-8 chars block by block with the lookup tables
+// in unicode_common.h. The errors are accumulated and checked at last by
+// Valid, so the check has no branch in the hot loop except for ascii blocks.
+struct Utf8Checker {
+ public:
+  sonic_force_inline Utf8Checker()
+      : error_(_mm_setzero_si128()),
+        prev_input_(_mm_setzero_si128()),
+        prev_incomplete_(_mm_setzero_si128()) {}
+
+  // Check the 16 bytes from src, which follow the bytes checked last time.
+  sonic_force_inline void Update(const uint8_t *src) {
+    check(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+  }
+
+  // Check the first n (n < 16) bytes from src. The chars must end before the
+  // n-th byte, and the next bytes to check are not following them.
+  sonic_force_inline void UpdatePrefix(const uint8_t *src, size_t n) {
+    const __m128i idx =
+        _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i mask = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(n)), idx);
+    check(_mm_and_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), mask));
+    prev_input_ = _mm_setzero_si128();
+  }
+
+  // Whether all the checked chars are valid and complete.
+  sonic_force_inline bool Valid() const {
+    __m128i err = _mm_or_si128(error_, prev_incomplete_);
+    return _mm_testz_si128(err, err);
+  }
+
+ private:
+  static sonic_force_inline __m128i lookup(const uint8_t *table, __m128i idx) {
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table));
+    return _mm_shuffle_epi8(t, idx);
+  }
+
+  template <int N>
+  sonic_force_inline __m128i prev(__m128i input) const {
+    return _mm_alignr_epi8(input, prev_input_, 16 - N);
+  }
+
+  sonic_force_inline void check(__m128i input) {
+    if (_mm_movemask_epi8(input) == 0) {
+      // the ascii block, only check the incomplete chars before it.
+      error_ = _mm_or_si128(error_, prev_incomplete_);
+    } else {
+      const __m128i low4 = _mm_set1_epi8(0x0f);
+      __m128i prev1 = prev<1>(input);
+      __m128i special = _mm_and_si128(
+          _mm_and_si128(
+              lookup(common::kUtf8Byte1High,
+                     _mm_and_si128(_mm_srli_epi16(prev1, 4), low4)),
+              lookup(common::kUtf8Byte1Low, _mm_and_si128(prev1, low4))),
+          lookup(common::kUtf8Byte2High,
+                 _mm_and_si128(_mm_srli_epi16(input, 4), low4)));
+      // the 3rd and 4th bytes of the multi-byte chars must be continuations.
+      __m128i must23 = _mm_or_si128(
+          _mm_subs_epu8(prev<2>(input), _mm_set1_epi8(0xe0 - 0x80)),
+          _mm_subs_epu8(prev<3>(input), _mm_set1_epi8(0xf0 - 0x80)));
+      must23 = _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80)));
+      error_ = _mm_or_si128(error_, _mm_xor_si128(must23, special));
+      // the multi-byte chars at the end of block are incomplete.
+      const __m128i max_value =
+          _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                        0xf0 - 1, 0xe0 - 1, 0xc0 - 1);
+      prev_incomplete_ = _mm_subs_epu8(input, max_value);
+    }
+    prev_input_ = input;
+  }
+
+  __m128i error_;
+  __m128i prev_input_;
+  __m128i prev_incomplete_;
+};
+
 }  // namespace sse
 }  // namespace internal
 }  // namespace sonic_json
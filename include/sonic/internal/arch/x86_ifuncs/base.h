@@ -19,26 +19,27 @@
 #include <sonic/macro.h>
 
 #include "../avx2/base.h"
+#include "../scalar/base.h"
 #include "../sse/base.h"
 
 namespace sonic_json {
 namespace internal {
-using sse::ClearLowestBit;
-using sse::CountOnes;
-using sse::LeadingZeroes;
-using sse::PrefixXor;
-using sse::TrailingZeroes;
+using scalar::ClearLowestBit;
+using scalar::CountOnes;
+using scalar::LeadingZeroes;
+using scalar::PrefixXor;
+using scalar::TrailingZeroes;
 
-__attribute__((target("default"))) inline void Xmemcpy_32(void*, const void*,
-                                                          size_t) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return;
+__attribute__((target("default"))) inline void Xmemcpy_32(void* dst,
+                                                          const void* src,
+                                                          size_t chunks) {
+  return scalar::Xmemcpy<32>(dst, src, chunks);
 }
 
-__attribute__((target("default"))) inline void Xmemcpy_16(void*, const void*,
-                                                          size_t) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return;
+__attribute__((target("default"))) inline void Xmemcpy_16(void* dst,
+                                                          const void* src,
+                                                          size_t chunks) {
+  return scalar::Xmemcpy<16>(dst, src, chunks);
 }
 
 __attribute__((target(SONIC_WESTMERE))) inline void Xmemcpy_32(void* dst,
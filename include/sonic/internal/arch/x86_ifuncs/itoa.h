@@ -14,12 +14,46 @@
  * limitations under the License.
  */
 
-#include "../sse/itoa.h"
 #pragma once
 
+#include <sonic/macro.h>
+
+#include "../avx2/itoa.h"
+#include "../scalar/itoa.h"
+#include "../sse/itoa.h"
+
 namespace sonic_json {
 namespace internal {
-using sse::Utoa_16;
-using sse::Utoa_8;
+
+__attribute__((target("default"))) inline char* Utoa_8(uint32_t val,
+                                                       char* out) {
+  return scalar::Utoa_8(val, out);
+}
+
+__attribute__((target("default"))) inline char* Utoa_16(uint64_t val,
+                                                        char* out) {
+  return scalar::Utoa_16(val, out);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline char* Utoa_8(uint32_t val,
+                                                            char* out) {
+  return sse::Utoa_8(val, out);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline char* Utoa_16(uint64_t val,
+                                                             char* out) {
+  return sse::Utoa_16(val, out);
+}
+
+__attribute__((target(SONIC_HASWELL))) inline char* Utoa_8(uint32_t val,
+                                                           char* out) {
+  return avx2::Utoa_8(val, out);
+}
+
+__attribute__((target(SONIC_HASWELL))) inline char* Utoa_16(uint64_t val,
+                                                            char* out) {
+  return avx2::Utoa_16(val, out);
+}
+
 }  // namespace internal
 }  // namespace sonic_json
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include "../avx2/member.h"
+#include "../avx512/member.h"
+#include "../scalar/member.h"
+#include "../sse/member.h"
+
+namespace sonic_json {
+namespace internal {
+
+__attribute__((target("default"))) inline size_t FindTag(const uint64_t* tags,
+                                                         size_t start, size_t n,
+                                                         uint64_t tag) {
+  return scalar::FindTag(tags, start, n, tag);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline size_t FindTag(
+    const uint64_t* tags, size_t start, size_t n, uint64_t tag) {
+  return sse::FindTag(tags, start, n, tag);
+}
+
+__attribute__((target(SONIC_HASWELL))) inline size_t FindTag(
+    const uint64_t* tags, size_t start, size_t n, uint64_t tag) {
+  return avx2::FindTag(tags, start, n, tag);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline size_t FindTag(
+    const uint64_t* tags, size_t start, size_t n, uint64_t tag) {
+  return avx512::FindTag(tags, start, n, tag);
+}
+
+}  // namespace internal
+}  // namespace sonic_json
@@ -19,43 +19,100 @@
 #include <sonic/macro.h>
 
 #include "../avx2/quote.h"
+#include "../avx512/quote.h"
+#include "../scalar/quote.h"
 #include "../sse/quote.h"
 
 namespace sonic_json {
 namespace internal {
-__attribute__((target("default"))) inline size_t parseStringInplace(
-    uint8_t *&, SonicError &) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+__attribute__((target("default"))) inline size_t parseStringInplaceImpl(
+    uint8_t *&src, SonicError &err) {
+  return scalar::parseStringInplace(src, err);
 }
 
-__attribute__((target("default"))) inline char *Quote(const char *, size_t,
-                                                      char *) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+__attribute__((target("default"))) inline size_t parseStringInplaceUtf8Impl(
+    uint8_t *&src, SonicError &err) {
+  return scalar::parseStringInplaceUtf8(src, err);
 }
 
-__attribute__((target(SONIC_WESTMERE))) inline size_t parseStringInplace(
+__attribute__((target("default"))) inline char *Quote(const char *src,
+                                                      size_t nb, char *dst) {
+  return scalar::Quote(src, nb, dst);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline size_t parseStringInplaceImpl(
     uint8_t *&src, SonicError &err) {
   return sse::parseStringInplace(src, err);
 }
 
+__attribute__((target(SONIC_WESTMERE))) inline size_t
+parseStringInplaceUtf8Impl(uint8_t *&src, SonicError &err) {
+  return sse::parseStringInplaceUtf8(src, err);
+}
+
 __attribute__((target(SONIC_WESTMERE))) inline char *Quote(const char *src,
                                                            size_t nb,
                                                            char *dst) {
   return sse::Quote(src, nb, dst);
 }
 
-__attribute__((target(SONIC_HASWELL))) inline size_t parseStringInplace(
+__attribute__((target(SONIC_HASWELL))) inline size_t parseStringInplaceImpl(
     uint8_t *&src, SonicError &err) {
   return avx2::parseStringInplace(src, err);
 }
 
+__attribute__((target(SONIC_HASWELL))) inline size_t
+parseStringInplaceUtf8Impl(uint8_t *&src, SonicError &err) {
+  return avx2::parseStringInplaceUtf8(src, err);
+}
+
 __attribute__((target(SONIC_HASWELL))) inline char *Quote(const char *src,
                                                           size_t nb,
                                                           char *dst) {
   return avx2::Quote(src, nb, dst);
 }
 
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline size_t
+parseStringInplaceImpl(uint8_t *&src, SonicError &err) {
+  return avx512::parseStringInplace(src, err);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline size_t
+parseStringInplaceUtf8Impl(uint8_t *&src, SonicError &err) {
+  return avx512::parseStringInplaceUtf8(src, err);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline char *Quote(
+    const char *src, size_t nb, char *dst) {
+  return avx512::Quote(src, nb, dst);
+}
+
+// The calls of multiversioned functions are not inlined, so the short strings
+// are unescaped here, if the ending quote is in the first 8 bytes.
+template <bool kValidateUtf8>
+sonic_force_inline bool parseShortString(uint8_t *&src, size_t &n) {
+  uint64_t bits = scalar::StringBits<kValidateUtf8>(scalar::LoadU64(src));
+  if (!bits) return false;
+  size_t i = scalar::ByteIndex(bits);
+  if (src[i] != '"') return false;
+  src[i] = '\0';
+  src += i + 1;
+  n = i;
+  return true;
+}
+
+sonic_force_inline size_t parseStringInplace(uint8_t *&src, SonicError &err) {
+  size_t n;
+  if (parseShortString<false>(src, n)) return n;
+  return parseStringInplaceImpl(src, err);
+}
+
+sonic_force_inline size_t parseStringInplaceUtf8(uint8_t *&src,
+                                                 SonicError &err) {
+  size_t n;
+  if (parseShortString<true>(src, n)) return n;
+  return parseStringInplaceUtf8Impl(src, err);
+}
+
 }  // namespace internal
 }  // namespace sonic_json
@@ -19,6 +19,8 @@
 #include <sonic/macro.h>
 
 #include "../avx2/skip.h"
+#include "../avx512/skip.h"
+#include "../scalar/skip.h"
 #include "../sse/skip.h"
 
 namespace sonic_json {
@@ -26,78 +28,193 @@ namespace internal {
 
 using common::EqBytes4;
 using common::SkipLiteral;
-using sse::GetNextToken;  // !!!Not efficency
 
-__attribute__((target("default"))) inline int SkipString(const uint8_t*,
-                                                         size_t&, size_t) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+// The function templates can not be multiversioned, so GetNextToken pads the
+// tokens to 3 by repeating the first one, and calls GetNextToken3.
+__attribute__((target("default"))) inline uint8_t GetNextToken3(
+    const uint8_t* data, size_t& pos, size_t len, const char (&tokens)[4]) {
+  return scalar::GetNextToken(data, pos, len, tokens);
 }
 
-__attribute__((target("default"))) inline bool SkipContainer(const uint8_t*,
-                                                             size_t&, size_t,
-                                                             uint8_t, uint8_t) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+__attribute__((target("default"))) inline int SkipStringImpl(
+    const uint8_t* data, size_t& pos, size_t len) {
+  return scalar::SkipString(data, pos, len);
+}
+
+__attribute__((target("default"))) inline SonicError ValidateStringImpl(
+    const uint8_t* data, size_t& pos, size_t len) {
+  return scalar::ValidateString(data, pos, len);
+}
+
+__attribute__((target("default"))) inline bool SkipContainer(
+    const uint8_t* data, size_t& pos, size_t len, uint8_t left, uint8_t right) {
+  return scalar::SkipContainer(data, pos, len, left, right);
+}
+
+__attribute__((target("default"))) inline uint8_t skip_space_impl(
+    const uint8_t* data, size_t& pos, size_t& nonspace_bits_end,
+    uint64_t& nonspace_bits) {
+  return scalar::skip_space(data, pos, nonspace_bits_end, nonspace_bits);
 }
 
-__attribute__((target("default"))) inline uint8_t skip_space(const uint8_t*,
-                                                             size_t&, size_t&,
-                                                             uint64_t&) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+__attribute__((target("default"))) inline uint8_t skip_space_safe_impl(
+    const uint8_t* data, size_t& pos, size_t len, size_t& nonspace_bits_end,
+    uint64_t& nonspace_bits) {
+  return scalar::skip_space_safe(data, pos, len, nonspace_bits_end,
+                                 nonspace_bits);
 }
 
-__attribute__((target("default"))) inline uint8_t skip_space_safe(
-    const uint8_t*, size_t&, size_t, size_t&, uint64_t&) {
-  // TODO static_assert(!!!"Not Implemented!");
-  return 0;
+__attribute__((target(SONIC_WESTMERE))) inline uint8_t GetNextToken3(
+    const uint8_t* data, size_t& pos, size_t len, const char (&tokens)[4]) {
+  return sse::GetNextToken(data, pos, len, tokens);
 }
 
-__attribute__((target(SONIC_WESTMERE))) inline int SkipString(
+__attribute__((target(SONIC_WESTMERE))) inline int SkipStringImpl(
     const uint8_t* data, size_t& pos, size_t len) {
   return sse::SkipString(data, pos, len);
 }
 
+__attribute__((target(SONIC_WESTMERE))) inline SonicError ValidateStringImpl(
+    const uint8_t* data, size_t& pos, size_t len) {
+  return sse::ValidateString(data, pos, len);
+}
+
 __attribute__((target(SONIC_WESTMERE))) inline bool SkipContainer(
     const uint8_t* data, size_t& pos, size_t len, uint8_t left, uint8_t right) {
   return sse::SkipContainer(data, pos, len, left, right);
 }
 
-__attribute__((target(SONIC_WESTMERE))) inline uint8_t skip_space(
+__attribute__((target(SONIC_WESTMERE))) inline uint8_t skip_space_impl(
     const uint8_t* data, size_t& pos, size_t& nonspace_bits_end,
     uint64_t& nonspace_bits) {
   return sse::skip_space(data, pos, nonspace_bits_end, nonspace_bits);
 }
 
-__attribute__((target(SONIC_WESTMERE))) inline uint8_t skip_space_safe(
+__attribute__((target(SONIC_WESTMERE))) inline uint8_t skip_space_safe_impl(
     const uint8_t* data, size_t& pos, size_t len, size_t& nonspace_bits_end,
     uint64_t& nonspace_bits) {
   return sse::skip_space_safe(data, pos, len, nonspace_bits_end, nonspace_bits);
 }
 
-__attribute__((target(SONIC_HASWELL))) inline int SkipString(
+__attribute__((target(SONIC_HASWELL))) inline uint8_t GetNextToken3(
+    const uint8_t* data, size_t& pos, size_t len, const char (&tokens)[4]) {
+  return avx2::GetNextToken(data, pos, len, tokens);
+}
+
+__attribute__((target(SONIC_HASWELL))) inline int SkipStringImpl(
     const uint8_t* data, size_t& pos, size_t len) {
   return avx2::SkipString(data, pos, len);
 }
 
+__attribute__((target(SONIC_HASWELL))) inline SonicError ValidateStringImpl(
+    const uint8_t* data, size_t& pos, size_t len) {
+  return avx2::ValidateString(data, pos, len);
+}
+
 __attribute__((target(SONIC_HASWELL))) inline bool SkipContainer(
     const uint8_t* data, size_t& pos, size_t len, uint8_t left, uint8_t right) {
   return avx2::SkipContainer(data, pos, len, left, right);
 }
 
-__attribute__((target(SONIC_HASWELL))) inline uint8_t skip_space(
+__attribute__((target(SONIC_HASWELL))) inline uint8_t skip_space_impl(
     const uint8_t* data, size_t& pos, size_t& nonspace_bits_end,
     uint64_t& nonspace_bits) {
   return avx2::skip_space(data, pos, nonspace_bits_end, nonspace_bits);
 }
 
-__attribute__((target(SONIC_HASWELL))) inline uint8_t skip_space_safe(
+__attribute__((target(SONIC_HASWELL))) inline uint8_t skip_space_safe_impl(
     const uint8_t* data, size_t& pos, size_t len, size_t& nonspace_bits_end,
     uint64_t& nonspace_bits) {
   return avx2::skip_space_safe(data, pos, len, nonspace_bits_end,
                                nonspace_bits);
 }
 
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline uint8_t GetNextToken3(
+    const uint8_t* data, size_t& pos, size_t len, const char (&tokens)[4]) {
+  return avx512::GetNextToken(data, pos, len, tokens);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline int SkipStringImpl(
+    const uint8_t* data, size_t& pos, size_t len) {
+  return avx512::SkipString(data, pos, len);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline SonicError
+ValidateStringImpl(const uint8_t* data, size_t& pos, size_t len) {
+  return avx512::ValidateString(data, pos, len);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline bool SkipContainer(
+    const uint8_t* data, size_t& pos, size_t len, uint8_t left, uint8_t right) {
+  return avx512::SkipContainer(data, pos, len, left, right);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline uint8_t skip_space_impl(
+    const uint8_t* data, size_t& pos, size_t& nonspace_bits_end,
+    uint64_t& nonspace_bits) {
+  return avx512::skip_space(data, pos, nonspace_bits_end, nonspace_bits);
+}
+
+__attribute__((target(SONIC_SKYLAKE_AVX512))) inline uint8_t
+skip_space_safe_impl(const uint8_t* data, size_t& pos, size_t len,
+                     size_t& nonspace_bits_end, uint64_t& nonspace_bits) {
+  return avx512::skip_space_safe(data, pos, len, nonspace_bits_end,
+                                 nonspace_bits);
+}
+
+// The calls of multiversioned functions are not inlined, so the fast paths
+// are here: most tokens have no space before, and most strings are short.
+sonic_force_inline int SkipString(const uint8_t* data, size_t& pos,
+                                  size_t len) {
+  if (pos + 8 <= len) {
+    uint64_t v = scalar::LoadU64(data + pos);
+    uint64_t bits = scalar::EqBits(v, '"') | scalar::EqBits(v, '\\');
+    size_t i = bits ? scalar::ByteIndex(bits) : 0;
+    if (bits && data[pos + i] == '"') {
+      pos += i + 1;
+      return 1;
+    }
+  }
+  return SkipStringImpl(data, pos, len);
+}
+
+sonic_force_inline SonicError ValidateString(const uint8_t* data, size_t& pos,
+                                             size_t len) {
+  if (pos + 8 <= len) {
+    uint64_t bits = scalar::StringBits<true>(scalar::LoadU64(data + pos));
+    size_t i = bits ? scalar::ByteIndex(bits) : 0;
+    if (bits && data[pos + i] == '"') {
+      pos += i + 1;
+      return kErrorNone;
+    }
+  }
+  return ValidateStringImpl(data, pos, len);
+}
+
+sonic_force_inline uint8_t skip_space(const uint8_t* data, size_t& pos,
+                                      size_t& nonspace_bits_end,
+                                      uint64_t& nonspace_bits) {
+  if (!IsSpace(data[pos])) return data[pos++];
+  return skip_space_impl(data, pos, nonspace_bits_end, nonspace_bits);
+}
+
+sonic_force_inline uint8_t skip_space_safe(const uint8_t* data, size_t& pos,
+                                           size_t len,
+                                           size_t& nonspace_bits_end,
+                                           uint64_t& nonspace_bits) {
+  if (pos < len && !IsSpace(data[pos])) return data[pos++];
+  return skip_space_safe_impl(data, pos, len, nonspace_bits_end,
+                              nonspace_bits);
+}
+
+template <size_t N>
+sonic_force_inline uint8_t GetNextToken(const uint8_t* data, size_t& pos,
+                                        size_t len, const char (&tokens)[N]) {
+  static_assert(N >= 2 && N <= 4, "GetNextToken supports 1 to 3 tokens");
+  const char padded[4] = {tokens[0], tokens[N > 2 ? 1 : 0],
+                          tokens[N > 3 ? 2 : 0], '\0'};
+  return GetNextToken3(data, pos, len, padded);
+}
+
 }  // namespace internal
 }  // namespace sonic_json
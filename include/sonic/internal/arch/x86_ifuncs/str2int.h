@@ -16,10 +16,29 @@
 
 #pragma once
 
+#include <sonic/macro.h>
+
+#include "../avx2/str2int.h"
+#include "../scalar/str2int.h"
 #include "../sse/str2int.h"
 
 namespace sonic_json {
 namespace internal {
-using sse::simd_str2int;
+
+__attribute__((target("default"))) inline uint64_t simd_str2int(const char* c,
+                                                                int& man_nd) {
+  return scalar::simd_str2int(c, man_nd);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline uint64_t simd_str2int(
+    const char* c, int& man_nd) {
+  return sse::simd_str2int(c, man_nd);
 }
+
+__attribute__((target(SONIC_HASWELL))) inline uint64_t simd_str2int(
+    const char* c, int& man_nd) {
+  return avx2::simd_str2int(c, man_nd);
+}
+
+}  // namespace internal
 }  // namespace sonic_json
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <sonic/macro.h>
+
+#include "../avx2/structural.h"
+#include "../scalar/structural.h"
+#include "../sse/structural.h"
+
+namespace sonic_json {
+namespace internal {
+
+__attribute__((target("default"))) inline size_t BuildStructuralIndex(
+    const uint8_t* data, size_t len, uint32_t* index) {
+  return scalar::BuildStructuralIndex(data, len, index);
+}
+
+__attribute__((target(SONIC_WESTMERE))) inline size_t BuildStructuralIndex(
+    const uint8_t* data, size_t len, uint32_t* index) {
+  return sse::BuildStructuralIndex(data, len, index);
+}
+
+__attribute__((target(SONIC_HASWELL))) inline size_t BuildStructuralIndex(
+    const uint8_t* data, size_t len, uint32_t* index) {
+  return avx2::BuildStructuralIndex(data, len, index);
+}
+
+}  // namespace internal
+}  // namespace sonic_json
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+#include "sonic/error.h"
+#include "sonic/macro.h"
+
+namespace sonic_json {
+namespace internal {
+
+// MappedFile maps a file privately with SONICJSON_PADDING writable bytes after
+// it, so that it can be parsed in place. The pages of the file are mapped
+// copy-on-write, and the padding is in anonymous pages after the last page of
+// the file, so reading or writing the padding never touches the file.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() { Close(); }
+
+  /**
+   * @brief Map the file, and the old mapping is closed at first.
+   * @return kErrorOpenFile if the file can't be opened, stated or mapped.
+   */
+  SonicError Open(const char* path) {
+    Close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return kErrorOpenFile;
+    }
+    SonicError err = mapFd(fd);
+    ::close(fd);
+    return err;
+  }
+
+  void Close() {
+    if (addr_ != nullptr) {
+      ::munmap(addr_, cap_);
+    }
+    addr_ = nullptr;
+    len_ = 0;
+    cap_ = 0;
+  }
+
+  sonic_force_inline char* Data() const { return static_cast<char*>(addr_); }
+  // The file size.
+  sonic_force_inline size_t Size() const { return len_; }
+  // The writable bytes from Data(), at least Size() + SONICJSON_PADDING.
+  sonic_force_inline size_t Capacity() const { return cap_; }
+
+ private:
+  SonicError mapFd(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      return kErrorOpenFile;
+    }
+    size_t len = static_cast<size_t>(st.st_size);
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t cap = (len + SONICJSON_PADDING + page - 1) / page * page;
+    // Reserve the whole range with zeroed anonymous pages, and then map the
+    // file over the head of it. The tail of the last file page is zeroed by
+    // the kernel, and the pages after it stay anonymous.
+    void* addr = ::mmap(nullptr, cap, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      return kErrorOpenFile;
+    }
+    if (len != 0) {
+      void* file = ::mmap(addr, len, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, fd, 0);
+      if (file == MAP_FAILED) {
+        ::munmap(addr, cap);
+        return kErrorOpenFile;
+      }
+      ::madvise(addr, len, MADV_SEQUENTIAL);
+    }
+    addr_ = addr;
+    len_ = len;
+    cap_ = cap;
+    return kErrorNone;
+  }
+
+  void* addr_{nullptr};
+  size_t len_{0};
+  size_t cap_{0};
+};
+
+}  // namespace internal
+}  // namespace sonic_json
@@ -16,7 +16,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "sonic/macro.h"
 
 namespace sonic_json {
 namespace internal {
@@ -25,5 +31,78 @@ static sonic_force_inline bool IsSpace(uint8_t ch) {
   return ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t';
 }
 
+// HashBytes is a fast hash of the short strings, such as the object keys. It
+// is not designed against hash flooding, and the tables of untrusted keys
+// should pass a secret seed, such as HashSeed().
+static sonic_force_inline uint64_t HashBytes(const char *s, size_t n,
+                                             uint64_t seed = 0) {
+  constexpr uint64_t kMul = 0xff51afd7ed558ccdULL;
+  auto load64 = [](const char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+  };
+  auto load32 = [](const char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return uint64_t(v);
+  };
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ seed ^ n;
+  uint64_t v;
+  if (n > 8) {
+    for (size_t i = 0; i + 8 < n; i += 8) {
+      h = (h ^ load64(s + i)) * kMul;
+      h ^= h >> 32;
+    }
+    // the last 8 bytes may overlap the mixed ones
+    v = load64(s + n - 8);
+  } else if (n >= 4) {
+    v = (load32(s) << 32) | load32(s + n - 4);
+  } else if (n > 0) {
+    v = (uint64_t(uint8_t(s[0])) << 16) | (uint64_t(uint8_t(s[n >> 1])) << 8) |
+        uint8_t(s[n - 1]);
+  } else {
+    v = 0;
+  }
+  h = (h ^ v) * kMul;
+  // the low bits of products only depend on the low bits, so mix them again.
+  h ^= h >> 32;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  return h ^ (h >> 29);
+}
+
+// The random seed of the process, so that the colliding keys can't be
+// crafted for another process. It is not static, so all translation units
+// share the same seed.
+inline uint64_t HashSeed() {
+  static const uint64_t seed = [] {
+    static const char kAnchor = 0;
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // the address is randomized by ASLR
+    uint64_t v[2] = {static_cast<uint64_t>(now.count()),
+                     static_cast<uint64_t>(
+                         reinterpret_cast<uintptr_t>(&kAnchor))};
+    return HashBytes(reinterpret_cast<const char *>(v), sizeof(v));
+  }();
+  return seed;
+}
+
+// Copy the json into buf of at least len + SONICJSON_PADDING bytes, and add
+// the ending mask to support parsing invalid json.
+static sonic_force_inline void CopyPaddedJson(char *buf, const char *json,
+                                              size_t len) {
+  std::memcpy(buf, json, len);
+  buf[len] = 'x';
+  buf[len + 1] = '"';
+  buf[len + 2] = 'x';
+}
+
+// Copy the json into a padded buffer from malloc, or nullptr if no memory.
+static inline char *MallocPaddedJson(const char *json, size_t len) {
+  char *buf = static_cast<char *>(std::malloc(len + SONICJSON_PADDING));
+  if (buf) CopyPaddedJson(buf, json, len);
+  return buf;
+}
+
 }  // namespace internal
 }  // namespace sonic_json
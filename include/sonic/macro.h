@@ -52,7 +52,8 @@
 #endif
 
 #define SONIC_WESTMERE "pclmul,sse4.2"
-#define SONIC_HASWELL "avx2"
+#define SONIC_HASWELL "avx2,pclmul"
+#define SONIC_SKYLAKE_AVX512 "avx512f,avx512bw,avx2,pclmul"
 #define SONIC_WESTMERE_STR(s) "arch=westmere"
 #define SONIC_HASWELL_STR(s) "arch=haswell"
 
@@ -69,3 +70,4 @@
 
 #define SONIC_PUSH_WESTMERE SONIC_PUSH_TARGET(SONIC_WESTMERE)
 #define SONIC_PUSH_HASWELL SONIC_PUSH_TARGET(SONIC_HASWELL)
+#define SONIC_PUSH_SKYLAKE_AVX512 SONIC_PUSH_TARGET(SONIC_SKYLAKE_AVX512)
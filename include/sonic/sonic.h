@@ -16,8 +16,16 @@
 
 #pragma once
 
+#include "sonic/dom/compact_document.h"
+#include "sonic/dom/document_stream.h"
 #include "sonic/dom/dynamicnode.h"
 #include "sonic/dom/generic_document.h"
+#include "sonic/dom/json_cursor.h"
+#include "sonic/dom/json_path.h"
+#include "sonic/dom/lazy_document.h"
+#include "sonic/dom/parallel_stream.h"
+#include "sonic/dom/tape_document.h"
+#include "sonic/dom/validate.h"
 
 #define SONIC_MAJOR_VERSION 1
 #define SONIC_MINOR_VERSION 0
@@ -16,6 +16,8 @@
 
 #include "sonic/allocator.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 namespace {
@@ -43,4 +45,56 @@ TEST(Allocator, Free) {
   EXPECT_NE(ptr, nullptr);
 }
 
+TEST(Allocator, Rewind) {
+  MemoryPoolAllocator<> a(1024);
+  a.Malloc(1000);
+  a.Malloc(1000);
+  void *last = a.Malloc(1000);
+  EXPECT_EQ(a.Capacity(), 3072u);
+  a.Rewind();
+  // only the current chunk is kept, and it is reused
+  EXPECT_EQ(a.Capacity(), 1024u);
+  EXPECT_EQ(a.Size(), 0u);
+  EXPECT_EQ(a.Malloc(1000), last);
+  EXPECT_EQ(a.Capacity(), 1024u);
+
+  char buf[512];
+  MemoryPoolAllocator<> b(buf, sizeof(buf), 1024);
+  void *first = b.Malloc(100);
+  b.Rewind();
+  EXPECT_EQ(b.Malloc(100), first);
+  b.Malloc(1000);
+  b.Rewind();
+  EXPECT_EQ(b.Size(), 0u);
+  EXPECT_NE(b.Malloc(1000), nullptr);
+}
+
+TEST(Allocator, Absorb) {
+  MemoryPoolAllocator<> a(1024), b(1024);
+  a.Malloc(100);
+  char *p = static_cast<char *>(b.Malloc(1000));
+  b.Malloc(1000);
+  size_t cap = a.Capacity() + b.Capacity();
+  a.Absorb(b);
+  // all chunks of b are moved to a
+  EXPECT_EQ(a.Capacity(), cap);
+  EXPECT_EQ(b.Capacity(), 0u);
+  b.Clear();
+  // the memory from b is still alive
+  std::memset(p, 'a', 1000);
+  EXPECT_NE(a.Malloc(100), nullptr);
+  // nothing to absorb from a cleared allocator
+  a.Absorb(b);
+  EXPECT_EQ(a.Capacity(), cap);
+
+  // the user buffer is kept by its allocator
+  char buf[512];
+  MemoryPoolAllocator<> c(buf, sizeof(buf), 1024);
+  c.Malloc(1000);
+  a.Absorb(c);
+  EXPECT_EQ(a.Capacity(), cap + 1024);
+  EXPECT_GT(c.Capacity(), 0u);
+  EXPECT_LT(c.Capacity(), sizeof(buf));
+}
+
 }  // namespace
\ No newline at end of file
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+TEST(CompactDocument, NodeSize) { EXPECT_EQ(sizeof(CompactNode), 8); }
+
+TEST(CompactDocument, ParseScalars) {
+  CompactDocument doc;
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+
+  doc.Parse("null");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  doc.Parse(" true ");
+  EXPECT_TRUE(doc.GetRoot().IsTrue());
+  EXPECT_TRUE(doc.GetRoot().GetBool());
+  doc.Parse("false");
+  EXPECT_TRUE(doc.GetRoot().IsFalse());
+  doc.Parse("\"abc\"");
+  EXPECT_EQ(doc.GetRoot().GetType(), kStringInline);
+  EXPECT_EQ(doc.GetRoot().GetStringView(), "abc");
+  doc.Parse("\"hello world\"");
+  EXPECT_EQ(doc.GetRoot().GetType(), kStringCopy);
+  EXPECT_EQ(doc.GetRoot().GetString(), "hello world");
+
+  doc.Parse("123");
+  EXPECT_TRUE(doc.GetRoot().IsUint64());
+  EXPECT_EQ(doc.GetRoot().GetUint64(), 123);
+  EXPECT_EQ(doc.GetRoot().GetInt64(), 123);
+  EXPECT_EQ(doc.GetMemoryUsage(), 8);
+  doc.Parse("-7");
+  EXPECT_TRUE(doc.GetRoot().IsInt64());
+  EXPECT_EQ(doc.GetRoot().GetInt64(), -7);
+  EXPECT_EQ(doc.GetRoot().GetDouble(), -7.0);
+  doc.Parse("1.5");
+  EXPECT_TRUE(doc.GetRoot().IsDouble());
+  EXPECT_EQ(doc.GetRoot().GetDouble(), 1.5);
+  EXPECT_EQ(doc.GetMemoryUsage(), 8);
+}
+
+TEST(CompactDocument, ParseBoxedNumbers) {
+  // the numbers that do not fit in the 32-bit payload are in the arena
+  CompactDocument doc;
+  doc.Parse(
+      "[18446744073709551615,-9223372036854775808,4294967296,-2147483649,"
+      "0.1,1e300,-2147483648,4294967295]");
+  ASSERT_FALSE(doc.HasParseError());
+  const CompactNode& arr = doc.GetRoot();
+  ASSERT_EQ(arr.Size(), 8);
+  EXPECT_EQ(arr[0].GetUint64(), UINT64_MAX);
+  EXPECT_FALSE(arr[0].IsInt64());
+  EXPECT_EQ(arr[1].GetInt64(), INT64_MIN);
+  EXPECT_EQ(arr[2].GetInt64(), int64_t(1) << 32);
+  EXPECT_EQ(arr[3].GetInt64(), -2147483649LL);
+  EXPECT_EQ(arr[4].GetDouble(), 0.1);
+  EXPECT_EQ(arr[5].GetDouble(), 1e300);
+  EXPECT_EQ(arr[6].GetInt64(), INT32_MIN);
+  EXPECT_EQ(arr[7].GetUint64(), UINT32_MAX);
+  // 6 boxed numbers, 8 children and the root
+  EXPECT_EQ(doc.GetMemoryUsage(), (6 + 8 + 1) * 8);
+}
+
+TEST(CompactDocument, ReadContainers) {
+  CompactDocument doc;
+  doc.Parse(R"({"id":1,"name":"compact node","tags":["a","bcdefghij",[]],
+                "nested":{"k":{},"escaped":"line\nbreaké"},"id2":null})");
+  ASSERT_FALSE(doc.HasParseError());
+  const CompactNode& root = doc.GetRoot();
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(root.Size(), 5);
+  EXPECT_TRUE(root.HasMember("id"));
+  EXPECT_FALSE(root.HasMember("i"));
+  EXPECT_FALSE(root.HasMember("idx"));
+  EXPECT_TRUE(root.FindMember("unknown") == root.MemberEnd());
+  EXPECT_TRUE(root["unknown"].IsNull());
+  EXPECT_EQ(root["id"].GetInt64(), 1);
+  EXPECT_EQ(root["name"].GetStringView(), "compact node");
+  EXPECT_TRUE(root["id2"].IsNull());
+
+  const CompactNode& tags = root["tags"];
+  ASSERT_TRUE(tags.IsArray());
+  ASSERT_EQ(tags.Size(), 3);
+  EXPECT_EQ(tags[0].GetStringView(), "a");
+  EXPECT_EQ(tags[1].GetStringView(), "bcdefghij");
+  EXPECT_TRUE(tags[2].IsArray());
+  EXPECT_TRUE(tags[2].Empty());
+  size_t n = 0;
+  for (auto it = tags.Begin(); it != tags.End(); ++it) n++;
+  EXPECT_EQ(n, 3);
+
+  const CompactNode& nested = root["nested"];
+  EXPECT_TRUE(nested["k"].IsObject());
+  EXPECT_TRUE(nested["k"].Empty());
+  EXPECT_EQ(nested["escaped"].GetString(), "line\nbreak\xc3\xa9");
+
+  std::string names;
+  for (auto m = root.MemberBegin(); m != root.MemberEnd(); ++m) {
+    names += m->name.GetString() + ",";
+  }
+  EXPECT_EQ(names, "id,name,tags,nested,id2,");
+
+  const CompactNode* node = root.AtPointer(JsonPointer({"tags", 1}));
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetStringView(), "bcdefghij");
+  EXPECT_EQ(root.AtPointer(JsonPointer({"tags", 3})), nullptr);
+  EXPECT_EQ(root.AtPointer(JsonPointer({"id", "x"})), nullptr);
+}
+
+TEST(CompactDocument, ParseError) {
+  CompactDocument doc;
+  doc.Parse("[1,2] x");
+  EXPECT_EQ(doc.GetParseError(), kParseErrorInvalidChar);
+  EXPECT_EQ(doc.GetMemoryUsage(), 0);
+}
+
+TEST(CompactDocument, ParseLimits) {
+  // a string of 2^24 bytes keeps its length in the arena
+  std::string s(size_t(1) << 24, 'x');
+  CompactDocument doc;
+  doc.Parse("[\"" + s + "\"]");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.GetRoot()[0].Size(), s.size());
+  EXPECT_EQ(doc.GetRoot()[0].GetStringView(), s);
+
+  // an array of 2^24 children is over the 24-bit length
+  std::string json = "[";
+  for (size_t i = 0; i < (size_t(1) << 24); i++) json += "0,";
+  json.back() = ']';
+  doc.Parse(json);
+  EXPECT_EQ(doc.GetParseError(), kErrorCompactLimit);
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+}
+
+}  // namespace
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/document_stream.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+template <typename NodeType>
+class DocumentStreamTest : public testing::Test {};
+
+using NodeTypes =
+    testing::Types<DNode<MemoryPoolAllocator<>>, DNode<SimpleAllocator>>;
+TYPED_TEST_SUITE(DocumentStreamTest, NodeTypes);
+
+TYPED_TEST(DocumentStreamTest, Records) {
+  std::string json =
+      "{\"a\":1}\n"
+      "[1,2,\"x\"]\r\n"
+      "\n"
+      "  \t\n"
+      "\"str\"\n"
+      "{\"a\":[1, \n"  // the newline ends the record
+      "2]}\n"
+      "null";
+  GenericDocumentStream<TypeParam> stream(json);
+  std::vector<std::string> records;
+  std::vector<size_t> offsets;
+  std::vector<bool> errors;
+  while (stream.Next()) {
+    records.emplace_back(stream.Record().data(), stream.Record().size());
+    offsets.push_back(stream.Offset());
+    errors.push_back(stream.Doc().HasParseError());
+    if (stream.Doc().HasParseError()) continue;
+    GenericDocument<TypeParam> expect;
+    expect.Parse(stream.Record());
+    EXPECT_TRUE(stream.Doc() == expect) << records.back();
+  }
+  EXPECT_EQ(records,
+            std::vector<std::string>({"{\"a\":1}", "[1,2,\"x\"]\r", "\"str\"",
+                                      "{\"a\":[1, ", "2]}", "null"}));
+  EXPECT_EQ(offsets, std::vector<size_t>({0, 8, 24, 30, 40, 44}));
+  EXPECT_EQ(errors,
+            std::vector<bool>({false, false, false, true, true, false}));
+  EXPECT_TRUE(stream.Doc().IsNull());
+  EXPECT_FALSE(stream.Next());
+}
+
+TYPED_TEST(DocumentStreamTest, ErrorRecords) {
+  std::string json = "{\"a\":\n[1,2]]\n{\"b\":\"\\g\"}\n[true]\n";
+  GenericDocumentStream<TypeParam> stream(json);
+  ASSERT_TRUE(stream.Next());
+  EXPECT_EQ(stream.Doc().GetParseError(), kParseErrorInvalidChar);
+  ASSERT_TRUE(stream.Next());
+  EXPECT_EQ(stream.Doc().GetParseError(), kParseErrorInvalidChar);
+  EXPECT_EQ(stream.Doc().GetErrorOffset(), 5u);
+  ASSERT_TRUE(stream.Next());
+  EXPECT_TRUE(stream.Doc().HasParseError());
+  ASSERT_TRUE(stream.Next());
+  EXPECT_FALSE(stream.Doc().HasParseError());
+  EXPECT_TRUE(stream.Doc()[0].IsTrue());
+  EXPECT_FALSE(stream.Next());
+}
+
+TYPED_TEST(DocumentStreamTest, Reset) {
+  GenericDocumentStream<TypeParam> stream;
+  EXPECT_FALSE(stream.Next());
+  stream.Reset("");
+  EXPECT_FALSE(stream.Next());
+  stream.Reset("\n\n  \n");
+  EXPECT_FALSE(stream.Next());
+
+  // long records across the SIMD blocks
+  std::string json;
+  for (int i = 0; i < 100; i++) {
+    json += "{\"key\":\"" + std::string(i, 'x') + "\",\"id\":" +
+            std::to_string(i) + "}\n";
+  }
+  for (int round = 0; round < 2; round++) {
+    stream.Reset(json);
+    int i = 0;
+    while (stream.Next()) {
+      ASSERT_FALSE(stream.Doc().HasParseError()) << stream.Record().data();
+      EXPECT_EQ(stream.Doc()["id"].GetInt64(), i);
+      EXPECT_EQ(stream.Doc()["key"].GetString().size(), size_t(i));
+      i++;
+    }
+    EXPECT_EQ(i, 100);
+  }
+}
+
+TEST(DocumentStream, ReuseMemory) {
+  std::string json;
+  for (int i = 0; i < 1000; i++) {
+    json += "{\"id\":" + std::to_string(i) + ",\"list\":[1,2,3,4,5,6]}\n";
+  }
+  DocumentStream stream(json);
+  auto& own = stream.Doc().GetAllocator();
+  ASSERT_TRUE(stream.Next());
+  size_t cap = own.Capacity();
+  while (stream.Next()) {
+    ASSERT_FALSE(stream.Doc().HasParseError());
+  }
+  EXPECT_EQ(own.Capacity(), cap);
+
+  // the given allocator is not rewound, its other memory is kept
+  MemoryPoolAllocator<> alloc;
+  Document other(&alloc);
+  other.Parse("{\"a\":[\"a long string of the other document\"]}");
+  ASSERT_FALSE(other.HasParseError());
+  DocumentStream shared(json, &alloc);
+  size_t size = alloc.Size();
+  for (int i = 0; shared.Next(); i++) {
+    ASSERT_FALSE(shared.Doc().HasParseError());
+    EXPECT_EQ(shared.Doc()["id"].GetInt64(), i);
+  }
+  EXPECT_GT(alloc.Size(), size);
+  EXPECT_EQ(other["a"][0].GetString(), "a long string of the other document");
+}
+
+}  // namespace
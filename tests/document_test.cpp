@@ -14,12 +14,12 @@
  * limitations under the License.
  */
 
-#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-#include <fstream>
 #include <iostream>
 #include <map>
-#include <sstream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -27,6 +27,7 @@
 #include "sonic/dom/generic_document.h"
 #include "sonic/dom/parser.h"
 #include "sonic/sonic.h"
+#include "tests/test_util.h"
 
 namespace {
 
@@ -326,55 +327,525 @@ TYPED_TEST(DocumentTest, Parse) {
   }
 }
 
-static std::string get_json(const std::string& file) {
-  std::ifstream ifs;
-  std::stringstream ss;
-  ifs.open(file.data());
-  ss << ifs.rdbuf();
-  return ss.str();
+TYPED_TEST(DocumentTest, ParseFile) {
+  using Document = TypeParam;
+  auto jsons = test::GetAllJsons("./testdata/");
+  for (const auto& json : jsons) {
+    Document doc;
+    doc.Parse(json);
+    EXPECT_FALSE(doc.HasParseError());
+  }
 }
 
-static std::vector<std::string> get_all_jsons(const std::string& dirname) {
-  DIR* dir = opendir(dirname.c_str());
-  std::vector<std::string> jsons;
-  EXPECT_TRUE(dir != nullptr) << "Error open directory: " + dirname;
-  if (nullptr == dir) return jsons;
-  struct dirent* ent = nullptr;
-  while (nullptr != (ent = readdir(dir))) {
-    struct stat st;
-    std::string filename = dirname + ent->d_name;
-    int ret = lstat(filename.c_str(), &st);
-    if (ret == -1) {
-      goto return_label;
-    }
-    if (S_ISDIR(st.st_mode)) {
-      if (ent->d_name[0] == '.') {
-        continue;
-      }
-      auto sub_jsons = get_all_jsons(filename + '/');
-      jsons.insert(jsons.end(), sub_jsons.begin(), sub_jsons.end());
-    } else {
-      auto const pos = filename.find_last_of('.');
-      const auto extension = filename.substr(pos + 1);
-      if (extension == "json") {
-        jsons.push_back(get_json(filename));
+TYPED_TEST(DocumentTest, ParseInsitu) {
+  using Document = TypeParam;
+  auto jsons = test::GetAllJsons("./testdata/");
+  jsons.push_back(R"({"a\nb":["\u4e2d\"",""],"c":"x\\y"})");
+  for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    std::vector<char> buf(json.begin(), json.end());
+    buf.resize(json.size() + SONICJSON_PADDING);
+    Document doc;
+    doc.ParseInsitu(buf.data(), json.size(), buf.size());
+    EXPECT_FALSE(doc.HasParseError());
+    EXPECT_EQ(doc.GetErrorOffset(), expect.GetErrorOffset());
+    EXPECT_TRUE(doc == expect);
+  }
+
+  // the long strings point into the buffer, and the short ones are inline
+  std::string json = R"(["abcdefgh", "d\te"])";
+  std::vector<char> buf(json.begin(), json.end());
+  buf.resize(json.size() + SONICJSON_PADDING);
+  Document doc;
+  doc.ParseInsitu(buf.data(), json.size(), buf.size());
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc[0].GetStringView().data(), buf.data() + 2);
+  EXPECT_EQ(doc[1].GetString(), "d\te");
+  EXPECT_EQ(doc[1].GetType(), kStringInline);
+
+  // the errors are the same as Parse
+  json = "[1, \"a\", tru]";
+  buf.assign(json.begin(), json.end());
+  buf.resize(json.size() + SONICJSON_PADDING);
+  doc.ParseInsitu(buf.data(), json.size(), buf.size());
+  Document expect;
+  expect.Parse(json);
+  EXPECT_EQ(doc.GetParseError(), kParseErrorInvalidChar);
+  EXPECT_EQ(doc.GetErrorOffset(), expect.GetErrorOffset());
+
+  // the padding is checked
+  doc.ParseInsitu(buf.data(), json.size(), buf.size() - 1);
+  EXPECT_EQ(doc.GetParseError(), kParseErrorInsituPadding);
+  EXPECT_TRUE(doc.IsNull());
+  doc.ParseInsitu(buf.data(), buf.size(), buf.size());
+  EXPECT_EQ(doc.GetParseError(), kParseErrorInsituPadding);
+}
+
+TYPED_TEST(DocumentTest, ParseValidateUtf8) {
+  using Document = TypeParam;
+  auto jsons = test::GetAllJsons("./testdata/");
+  for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.template Parse<kParseValidateUtf8>(json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+  }
+
+  // the invalid chars are in different places of the blocks
+  std::vector<std::string> invalid = {
+      "\xff",
+      "\x80",
+      "\xc0\xaf",
+      "\xe0\x80\xaf",
+      "\xed\xa0\x80",
+      "\xf4\x90\x80\x80",
+      "\xf8\x88\x80\x80\x80",
+      "\xe4\xb8",
+      "\xe4\xb8\xad\xad",
+  };
+  for (const auto& bad : invalid) {
+    for (size_t pad = 0; pad < 70; pad++) {
+      for (const char* escaped : {"", "\\n", "\\u4e2d"}) {
+        std::string str = std::string(pad, 'x') + escaped + bad + "y";
+        std::string json = "[\"" + str + "\",\"\xe4\xb8\xad\"]";
+        Document doc;
+        doc.template Parse<kParseValidateUtf8>(json);
+        EXPECT_EQ(doc.GetParseError(), kParseErrorInvalidUTF8) << json;
+        json = "{\"" + str + "\":1}";
+        doc.template Parse<kParseValidateUtf8>(json);
+        EXPECT_EQ(doc.GetParseError(), kParseErrorInvalidUTF8) << json;
+        // the default parsing does not validate utf-8
+        doc.Parse(json);
+        EXPECT_FALSE(doc.HasParseError()) << json;
       }
     }
   }
 
-return_label:
-  closedir(dir);
-  return jsons;
+  // the valid chars cross the blocks
+  std::string str;
+  for (int i = 0; i < 40; i++) {
+    str += "\xc2\xa9\xe4\xb8\xad\xf0\x9f\x98\x80" + std::string(i % 3, 'a');
+    if (i % 7 == 0) str += "\\t";
+  }
+  for (size_t pad = 0; pad < 70; pad++) {
+    std::string json = "[\"" + std::string(pad, 'x') + str + "\"]";
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.template Parse<kParseValidateUtf8 | kParseTwoStage>(json);
+    EXPECT_FALSE(doc.HasParseError()) << json;
+    EXPECT_TRUE(doc == expect) << json;
+  }
 }
 
-TYPED_TEST(DocumentTest, ParseFile) {
+TYPED_TEST(DocumentTest, ParseInternKeys) {
   using Document = TypeParam;
-  auto jsons = get_all_jsons("./testdata/");
+  auto jsons = test::GetAllJsons("./testdata/");
   for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.template Parse<kParseInternKeys>(json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+    doc.template Parse<kParseInternKeys | kParseTwoStage>(json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+  }
+
+  // the same keys share one string, include the escaped keys. The short keys
+  // are inline and have nothing to share.
+  std::string json =
+      R"([{"identity":1,"username":"a","t\u0061g_name":"x"},)"
+      R"({"identity":2,"username":"b","tag_name":"y"},)"
+      R"({"username":"c","identity":3,"n":{"identity":4}}])";
+  for (int insitu = 0; insitu < 2; insitu++) {
     Document doc;
+    std::string buf = json + std::string(64, '\0');
+    if (insitu) {
+      doc.template ParseInsitu<kParseInternKeys>(&buf[0], json.size(),
+                                                 buf.size());
+    } else {
+      doc.template Parse<kParseInternKeys>(json);
+    }
+    ASSERT_FALSE(doc.HasParseError());
+    const auto& first = doc[0];
+    const char* id = first.MemberBegin()->name.GetStringView().data();
+    const char* tag = (first.MemberBegin() + 2)->name.GetStringView().data();
+    EXPECT_EQ(doc[1].MemberBegin()->name.GetStringView().data(), id);
+    EXPECT_EQ((doc[1].MemberBegin() + 2)->name.GetStringView().data(), tag);
+    EXPECT_EQ((doc[2].MemberBegin() + 1)->name.GetStringView().data(), id);
+    EXPECT_EQ(doc[2]["n"].MemberBegin()->name.GetStringView().data(), id);
+    EXPECT_EQ(doc[2]["identity"].GetInt64(), 3);
+    EXPECT_EQ(doc[1]["tag_name"].GetStringView(), "y");
+    EXPECT_EQ(doc[2]["n"].MemberBegin()->name.GetType(), kStringCopy);
+    // the keys are not interned by default
     doc.Parse(json);
-    EXPECT_FALSE(doc.HasParseError());
+    EXPECT_NE(doc[1].MemberBegin()->name.GetStringView().data(),
+              doc[0].MemberBegin()->name.GetStringView().data());
+  }
+
+  // the table is full of distinct keys, the later keys are still parsed
+  std::string many = "[{";
+  for (int i = 0; i < 2000; i++) {
+    if (i) many += ",";
+    many += "\"member_" + std::to_string(i) + "\":" + std::to_string(i);
+  }
+  many += "},{\"member_1\":1,\"member_1999\":1999}]";
+  Document doc;
+  doc.template Parse<kParseInternKeys>(many);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc[0]["member_1999"].GetInt64(), 1999);
+  EXPECT_EQ(doc[1].MemberBegin()->name.GetStringView().data(),
+            (doc[0].MemberBegin() + 1)->name.GetStringView().data());
+  EXPECT_EQ(doc[1]["member_1999"].GetInt64(), 1999);
+}
+
+TYPED_TEST(DocumentTest, ParseInlineStrings) {
+  using Document = TypeParam;
+  // the strings of at most 7 bytes are stored in the nodes
+  std::string json =
+      R"({"id":"US","ok":true,"":"","seven_b":"1234567",)"
+      R"("eight_by":"12345678","esc":"a\nbé","list":["x","yz"]})";
+  Document doc;
+  doc.Parse(json);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc["id"].GetType(), kStringInline);
+  EXPECT_EQ(doc["id"].GetStringView(), "US");
+  EXPECT_EQ(doc[""].GetType(), kStringInline);
+  EXPECT_EQ(doc[""].GetString(), "");
+  EXPECT_EQ(doc["seven_b"].GetType(), kStringInline);
+  EXPECT_EQ(doc["seven_b"].GetString(), "1234567");
+  EXPECT_STREQ(doc["seven_b"].GetStringView().data(), "1234567");
+  EXPECT_EQ(doc["eight_by"].GetType(), kStringCopy);
+  EXPECT_EQ(doc["eight_by"].GetStringView(), "12345678");
+  EXPECT_EQ(doc["esc"].GetStringView(), "a\nbé");
+  EXPECT_EQ(doc["list"][1].GetStringView(), "yz");
+  EXPECT_TRUE(doc.HasMember("seven_b"));
+  EXPECT_FALSE(doc.HasMember("seven"));
+  EXPECT_EQ(doc.Dump(), R"({"id":"US","ok":true,"":"","seven_b":"1234567",)"
+                        R"("eight_by":"12345678","esc":"a\nbé",)"
+                        R"("list":["x","yz"]})");
+
+  // the inline strings are kept when the nodes are copied or moved
+  Document copy;
+  copy.CopyFrom(doc, copy.GetAllocator(), true);
+  EXPECT_TRUE(copy == doc);
+  typename Document::NodeType moved(std::move(doc["list"]));
+  doc.RemoveMember("list");
+  EXPECT_EQ(moved[0].GetStringView(), "x");
+  EXPECT_EQ(copy["list"][0].GetStringView(), "x");
+
+  // the same with the chunked parsing, which copies the long strings
+  Document chunked;
+  for (size_t i = 0; i < json.size(); i += 5) {
+    chunked.ParseChunk(json.substr(i, 5));
   }
+  chunked.ParseChunkEnd();
+  ASSERT_FALSE(chunked.HasParseError());
+  EXPECT_EQ(chunked["seven_b"].GetType(), kStringInline);
+  EXPECT_EQ(chunked["eight_by"].GetType(), kStringFree);
+  EXPECT_TRUE(chunked == copy);
+
+  // a document of short strings only does not keep the parsed json
+  Document keys;
+  keys.template Parse<kParseInternKeys>(R"([{"a":1,"bc":"de"},{"a":2}])");
+  ASSERT_FALSE(keys.HasParseError());
+  EXPECT_EQ(keys[1]["a"].GetInt64(), 2);
+  EXPECT_EQ(keys[0]["bc"].GetStringView(), "de");
+}
+
+TYPED_TEST(DocumentTest, ParseCreateMap) {
+  using Document = TypeParam;
+  auto jsons = test::GetAllJsons("./testdata/");
+  for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.SetMapThreshold(4);
+    doc.template Parse<kParseCreateMap>(json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+    doc.template Parse<kParseCreateMap | kParseTwoStage | kParseInternKeys>(
+        json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+  }
+
+  // a large object with small ones and duplicated keys
+  std::string json = "{";
+  for (int i = 0; i < 1000; i++) {
+    json += "\"k" + std::to_string(i) + "\":{\"v\":" + std::to_string(i) +
+            "},";
+  }
+  json += "\"k7\":null}";
+  Document doc;
+  doc.template Parse<kParseCreateMap>(json);
+  ASSERT_FALSE(doc.HasParseError());
+  for (int i = 0; i < 1000; i++) {
+    std::string key = "k" + std::to_string(i);
+    EXPECT_EQ(doc[key]["v"].GetInt64(), i);
+  }
+  EXPECT_FALSE(doc.HasMember("k1000"));
+  // the map is kept up to date
+  doc.AddMember("new", typename Document::NodeType(1), doc.GetAllocator());
+  EXPECT_TRUE(doc.RemoveMember("k0"));
+  EXPECT_TRUE(doc.RemoveMember("k7"));
+  EXPECT_TRUE(doc["k7"].IsNull());
+  EXPECT_EQ(doc["new"].GetInt64(), 1);
+  EXPECT_EQ(doc["k999"]["v"].GetInt64(), 999);
+  EXPECT_FALSE(doc.HasMember("k0"));
+
+  // the medium objects get the key tags, and the keys share the first bytes
+  std::vector<std::string> keys = {"", "a", "ab", "abc", "abcd", "abcde"};
+  for (int i = 0; i < 30; i++) {
+    keys.push_back("abcdefgh" + std::string(i % 7, 'x') + std::to_string(i));
+  }
+  for (size_t n = 8; n <= keys.size(); n += 7) {
+    std::string obj = "{";
+    for (size_t i = 0; i < n; i++) {
+      obj += "\"" + keys[i] + "\":" + std::to_string(i) + ",";
+    }
+    obj += "\"abc\":null}";
+    Document tagged;
+    tagged.template Parse<kParseCreateMap>(obj);
+    ASSERT_FALSE(tagged.HasParseError());
+    for (size_t i = 0; i < n; i++) {
+      EXPECT_EQ(tagged[keys[i]].GetInt64(), int64_t(i)) << obj;
+    }
+    EXPECT_FALSE(tagged.HasMember("abcdefgh"));
+    EXPECT_FALSE(tagged.HasMember("abcdefgh0x"));
+    // the tags are kept up to date, or dropped when full
+    for (int i = 0; i < 12; i++) {
+      tagged.AddMember("new" + std::to_string(i),
+                       typename Document::NodeType(i), tagged.GetAllocator());
+      EXPECT_EQ(tagged["new" + std::to_string(i)].GetInt64(), i);
+    }
+    EXPECT_TRUE(tagged.RemoveMember(keys[0]));
+    EXPECT_TRUE(tagged.RemoveMember("abc"));
+    EXPECT_TRUE(tagged["abc"].IsNull());
+    EXPECT_FALSE(tagged.HasMember(keys[0]));
+    EXPECT_EQ(tagged["new11"].GetInt64(), 11);
+    EXPECT_EQ(tagged[keys[n - 1]].GetInt64(), int64_t(n - 1));
+    tagged.EraseMember(tagged.MemberBegin(), tagged.MemberBegin() + 2);
+    EXPECT_FALSE(tagged.HasMember(keys[1]));
+    EXPECT_EQ(tagged["new5"].GetInt64(), 5);
+    EXPECT_TRUE(tagged.CreateMap(tagged.GetAllocator()));
+    EXPECT_EQ(tagged["new5"].GetInt64(), 5);
+    EXPECT_EQ(tagged[keys[n - 1]].GetInt64(), int64_t(n - 1));
+  }
+
+  // the chunked parsing also creates the maps
+  Document chunked;
+  for (size_t i = 0; i < json.size(); i += 100) {
+    chunked.template ParseChunk<kParseCreateMap>(
+        StringView(json.data() + i, std::min<size_t>(100, json.size() - i)));
+  }
+  chunked.template ParseChunkEnd<kParseCreateMap>();
+  ASSERT_FALSE(chunked.HasParseError());
+  EXPECT_EQ(chunked["k500"]["v"].GetInt64(), 500);
+  EXPECT_EQ(chunked["k7"]["v"].GetInt64(), 7);
+}
+
+TEST(Document, ParseCreateMapCollidingKeys) {
+  // the keys of the same slot in the maps of up to 1024 slots, with the
+  // unseeded hash
+  std::vector<std::string> keys;
+  for (int i = 0; keys.size() < 300; i++) {
+    std::string key = "key" + std::to_string(i);
+    if (((HashBytes(key.data(), key.size()) >> 32) & 1023) == 0) {
+      keys.push_back(key);
+    }
+  }
+  std::string json = "{";
+  for (size_t i = 0; i < keys.size(); i++) {
+    json += "\"" + keys[i] + "\":" + std::to_string(i) + ",";
+  }
+  json.back() = '}';
+
+  Document doc;
+  doc.Parse<kParseCreateMap>(json);
+  ASSERT_FALSE(doc.HasParseError());
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(doc[keys[i]].GetInt64(), int64_t(i));
+  }
+  EXPECT_FALSE(doc.HasMember("key"));
+
+  // the hash of the map is seeded, and the keys are spread over the slots
+  std::set<uint32_t> slots;
+  for (const auto& key : keys) {
+    slots.insert(MemberIndex<SimpleAllocator>::Hash(key) & 1023);
+  }
+  EXPECT_GT(slots.size(), keys.size() / 2);
+}
+
+TYPED_TEST(DocumentTest, ParsePackNumbers) {
+  using Document = TypeParam;
+  using NodeType = typename Document::NodeType;
+  // the packed documents are the same as the normal ones
+  auto jsons = test::GetAllJsons("./testdata/");
+  for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.template Parse<kParsePackNumbers>(json);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError());
+    EXPECT_TRUE(doc == expect);
+    EXPECT_TRUE(expect == doc);
+    if (!doc.HasParseError()) {
+      EXPECT_EQ(doc.Dump(), expect.Dump());
+    }
+  }
+
+  std::string json =
+      R"({"reals":[1.5,-2.0,1e+300],"ints":[1,-2,9223372036854775807],)"
+      R"("uints":[1,18446744073709551615],"mixed":[1,2.5],"strs":["a",1],)"
+      R"("empty":[],"nested":[[0.5],[1]]})";
+  Document doc;
+  doc.template Parse<kParsePackNumbers>(json);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc["reals"].GetType(), kPackedReal);
+  EXPECT_TRUE(doc["reals"].IsArray());
+  EXPECT_TRUE(doc["reals"].IsPackedArray());
+  EXPECT_EQ(doc["reals"].Size(), 3);
+  EXPECT_EQ(doc["reals"].GetPackedDoubles()[1], -2.0);
+  EXPECT_EQ(doc["ints"].GetType(), kPackedInt);
+  EXPECT_EQ(doc["ints"].GetPackedInt64s()[2], INT64_MAX);
+  // the integers beyond int64 and the mixed numbers are not packed
+  EXPECT_EQ(doc["uints"].GetType(), kArray);
+  EXPECT_EQ(doc["mixed"].GetType(), kArray);
+  EXPECT_EQ(doc["strs"].GetType(), kArray);
+  EXPECT_EQ(doc["empty"].GetType(), kArray);
+  EXPECT_EQ(doc["nested"].GetType(), kArray);
+  EXPECT_EQ(doc["nested"][1].GetPackedInt64s()[0], 1);
+  EXPECT_EQ(doc.Dump(), json);
+
+  // the node APIs see no element nodes in a packed array
+  {
+    const NodeType& creals = doc["reals"];
+    EXPECT_TRUE(creals.Begin() == creals.End());
+    EXPECT_TRUE(doc["ints"].Begin() == doc["ints"].End());
+    EXPECT_TRUE(creals[1].IsNull());
+    EXPECT_TRUE(doc["ints"][2].IsNull());
+    EXPECT_TRUE(doc["ints"].Back().IsNull());
+    EXPECT_EQ(doc.AtPointer(JsonPointer({"reals", 0})), nullptr);
+    EXPECT_EQ(doc.AtPointer(JsonPointer({"nested", 1, 0})), nullptr);
+    EXPECT_NE(doc.AtPointer(JsonPointer({"nested", 1})), nullptr);
+    size_t n = 0;
+    for (auto it = creals.Begin(); it != creals.End(); ++it) n++;
+    EXPECT_EQ(n, 0);
+    EXPECT_EQ(doc.AtPointer("reals", 0), nullptr);
+    EXPECT_EQ(creals.AtPointer(1), nullptr);
+  }
+
+  // the packed elements are erased by the indexes
+  {
+    Document packed;
+    packed.template Parse<kParsePackNumbers>("[1.5,2.5,3.5,4.5]");
+    ASSERT_TRUE(packed.IsPackedArray());
+    packed.Erase(1, 3);
+    EXPECT_EQ(packed.Size(), 2);
+    EXPECT_EQ(packed.Dump(), "[1.5,4.5]");
+    packed.Erase(1, 1);
+    EXPECT_EQ(packed.Size(), 2);
+    packed.Erase(0, 2);
+    EXPECT_EQ(packed.Size(), 0);
+    EXPECT_EQ(packed.Dump(), "[]");
+  }
+
+  auto& alloc = doc.GetAllocator();
+  // the copies are packed too
+  NodeType copy(doc["reals"], alloc);
+  EXPECT_EQ(copy.GetType(), kPackedReal);
+  EXPECT_TRUE(copy == doc["reals"]);
+
+  // the same numbers are pushed into the packed array
+  NodeType& ints = doc["ints"];
+  for (int i = 0; i < 20; i++) {
+    ints.PushBack(NodeType(-i), alloc);
+  }
+  ints.PopBack();
+  EXPECT_EQ(ints.GetType(), kPackedInt);
+  EXPECT_EQ(ints.Size(), 22);
+  EXPECT_EQ(ints.GetPackedInt64s()[21], -18);
+  ints.Reserve(100, alloc);
+  EXPECT_EQ(ints.Capacity(), 100);
+  EXPECT_EQ(ints.GetPackedInt64s()[3], 0);
+  // and the others unpack it
+  ints.PushBack(NodeType(0.5), alloc);
+  EXPECT_EQ(ints.GetType(), kArray);
+  EXPECT_EQ(ints.Size(), 23);
+  EXPECT_TRUE(ints[0].IsUint64());
+  EXPECT_EQ(ints[1].GetInt64(), -2);
+  EXPECT_EQ(ints[21].GetInt64(), -18);
+  EXPECT_EQ(ints[22].GetDouble(), 0.5);
+
+  NodeType& reals = doc["reals"];
+  reals.Unpack(alloc);
+  EXPECT_EQ(reals.GetType(), kArray);
+  EXPECT_EQ(reals[2].GetDouble(), 1e300);
+  EXPECT_TRUE(copy == reals);
+  EXPECT_TRUE(reals == copy);
+  copy.Clear();
+  EXPECT_EQ(copy.GetType(), kArray);
+  copy.PushBack(NodeType("x"), alloc);
+  EXPECT_EQ(copy[0].GetStringView(), "x");
+
+  // the root array
+  doc.template Parse<kParsePackNumbers>("[1,2,3]");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc.IsPackedArray());
+  EXPECT_EQ(doc.Dump(), "[1,2,3]");
+  doc.template Parse<kParsePackNumbers>("[1e999]");
+  EXPECT_TRUE(doc.HasParseError());
+}
+
+TYPED_TEST(DocumentTest, ParseMappedFile) {
+  using Document = TypeParam;
+  for (const char* file :
+       {"./testdata/twitter.json", "./testdata/twitterescaped.json",
+        "./testdata/canada.json", "./testdata/citm_catalog.json"}) {
+    Document expect;
+    expect.Parse(test::GetJson(file));
+    Document doc;
+    doc.ParseFile(file);
+    EXPECT_FALSE(doc.HasParseError()) << file;
+    EXPECT_TRUE(doc == expect) << file;
+  }
+
+  // the file ends at the page boundary, and the padding is in the next page
+  char path[] = "/tmp/sonic_mapped_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  std::string json = "[\"" + std::string(4092, 'a') + "\"]";
+  ASSERT_EQ(write(fd, json.data(), json.size()), (ssize_t)json.size());
+  close(fd);
+  Document doc;
+  doc.ParseFile(std::string(path));
+  EXPECT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc[0].GetStringView().size(), 4092);
+
+  // the errors are the same as Parse
+  fd = open(path, O_WRONLY | O_TRUNC);
+  json = "[1, tru]";
+  ASSERT_EQ(write(fd, json.data(), json.size()), (ssize_t)json.size());
+  close(fd);
+  doc.ParseFile(path);
+  EXPECT_EQ(doc.GetParseError(), kParseErrorInvalidChar);
+  EXPECT_EQ(doc.GetErrorOffset(), Document().Parse(json).GetErrorOffset());
+  ASSERT_EQ(truncate(path, 0), 0);
+  doc.ParseFile(path);
+  EXPECT_EQ(doc.GetParseError(), Document().Parse("").GetParseError());
+  unlink(path);
+
+  doc.ParseFile(path);
+  EXPECT_EQ(doc.GetParseError(), kErrorOpenFile);
+  EXPECT_TRUE(doc.IsNull());
+  doc.ParseFile("./testdata/");
+  EXPECT_EQ(doc.GetParseError(), kErrorOpenFile);
 }
 
 TYPED_TEST(DocumentTest, ParseOnDemandFile) {
@@ -397,7 +868,7 @@ TYPED_TEST(DocumentTest, ParseOnDemandFile) {
     NodeWrapper wnode;
   };
 
-  auto jsons = get_all_jsons("./testdata/");
+  auto jsons = test::GetAllJsons("./testdata/");
   std::vector<OnDemandParseTest> tests = {
       {"twitter", {"statuses", 0, "favorited"}, CNode(false)},
       {"twitter",
@@ -410,8 +881,7 @@ TYPED_TEST(DocumentTest, ParseOnDemandFile) {
 
   for (const auto& t : tests) {
     Document doc;
-    std::string json =
-        get_json(std::string("./testdata/") + t.json_file + ".json");
+    std::string json = test::GetTestData(t.json_file);
     doc.ParseOnDemand(json, t.path);
     EXPECT_EQ(doc, t.wnode.node);
   }
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/json_cursor.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+TEST(JsonCursor, Scalars) {
+  int64_t i;
+  uint64_t u;
+  double d;
+  bool b;
+  std::string s;
+  StringView raw;
+
+  EXPECT_EQ(JsonCursor(" -12 ").GetInt64(i), kErrorNone);
+  EXPECT_EQ(i, -12);
+  EXPECT_EQ(JsonCursor("-12").GetUint64(u), kParseErrorMismatchType);
+  EXPECT_EQ(JsonCursor("18446744073709551615").GetUint64(u), kErrorNone);
+  EXPECT_EQ(u, 18446744073709551615ull);
+  EXPECT_EQ(JsonCursor("18446744073709551615").GetInt64(i),
+            kParseErrorMismatchType);
+  EXPECT_EQ(JsonCursor("1.5e3").GetDouble(d), kErrorNone);
+  EXPECT_EQ(d, 1500.0);
+  EXPECT_EQ(JsonCursor("7").GetDouble(d), kErrorNone);
+  EXPECT_EQ(d, 7.0);
+  EXPECT_EQ(JsonCursor("1.5").GetInt64(i), kParseErrorMismatchType);
+  EXPECT_EQ(JsonCursor("1.2x").GetDouble(d), kParseErrorInvalidChar);
+  std::string digits(100, '1');
+  EXPECT_EQ(JsonCursor(digits).GetDouble(d), kErrorNone);
+  EXPECT_DOUBLE_EQ(d, 1.1111111111111111e99);
+
+  EXPECT_EQ(JsonCursor("true").GetBool(b), kErrorNone);
+  EXPECT_TRUE(b);
+  EXPECT_EQ(JsonCursor("fals").GetBool(b), kParseErrorInvalidChar);
+  EXPECT_TRUE(JsonCursor(" null").IsNull());
+
+  EXPECT_EQ(JsonCursor(R"("abc")").GetString(s), kErrorNone);
+  EXPECT_EQ(s, "abc");
+  EXPECT_EQ(JsonCursor(R"("a\n中\"")").GetString(s), kErrorNone);
+  EXPECT_EQ(s, "a\n中\"");
+  EXPECT_EQ(JsonCursor(R"("a\g")").GetString(s), kParseErrorEscapedFormat);
+  EXPECT_EQ(JsonCursor("1").GetString(s), kParseErrorMismatchType);
+  EXPECT_EQ(JsonCursor("  ").GetString(s), kParseErrorEof);
+  EXPECT_EQ(JsonCursor("").GetRaw(raw), kParseErrorEof);
+}
+
+TEST(JsonCursor, FindField) {
+  std::string json = R"({
+    "a": {"x": 1, "y": [1, 2]},
+    "b": "str",
+    "cd": 3.5,
+    "e": [{"id": 1}, {"id": 2, "name": "n2"}, {"id": 3}]
+  })";
+  JsonCursor root(json);
+  JsonCursor v, w;
+  int64_t i;
+  double d;
+  std::string s;
+  StringView raw;
+
+  // in order
+  ASSERT_EQ(root.FindField("a", v), kErrorNone);
+  ASSERT_EQ(v.FindField("y", w), kErrorNone);
+  EXPECT_EQ(w.GetRaw(raw), kErrorNone);
+  EXPECT_EQ(raw, "[1, 2]");
+  ASSERT_EQ(root.FindField("b", v), kErrorNone);
+  EXPECT_EQ(v.GetString(s), kErrorNone);
+  EXPECT_EQ(s, "str");
+  ASSERT_EQ(root.FindField("cd", v), kErrorNone);
+  EXPECT_EQ(v.GetDouble(d), kErrorNone);
+  EXPECT_EQ(d, 3.5);
+
+  // out of order, wraps around
+  ASSERT_EQ(root.FindField("a", v), kErrorNone);
+  ASSERT_EQ(v.FindField("x", w), kErrorNone);
+  EXPECT_EQ(w.GetInt64(i), kErrorNone);
+  EXPECT_EQ(i, 1);
+  EXPECT_EQ(root.FindField("z", v), kParseErrorUnknownObjKey);
+  ASSERT_EQ(root.FindField("b", v), kErrorNone);
+  EXPECT_EQ(v.FindField("b", w), kParseErrorMismatchType);
+
+  // arrays
+  ASSERT_EQ(root.FindField("e", v), kErrorNone);
+  std::vector<int64_t> ids;
+  auto it = v.IterateArray();
+  while (it.Next()) {
+    JsonCursor id;
+    ASSERT_EQ(it.Value().FindField("id", id), kErrorNone);
+    ASSERT_EQ(id.GetInt64(i), kErrorNone);
+    ids.push_back(i);
+    if (i == 2) {
+      JsonCursor name;
+      EXPECT_EQ(it.Value().FindField("name", name), kErrorNone);
+    }
+  }
+  EXPECT_EQ(it.Error(), kErrorNone);
+  EXPECT_EQ(ids, std::vector<int64_t>({1, 2, 3}));
+  EXPECT_EQ(root.IterateArray().Error(), kParseErrorMismatchType);
+  EXPECT_EQ(JsonCursor("{}").FindField("a", v), kParseErrorUnknownObjKey);
+}
+
+TEST(JsonCursor, Invalid) {
+  JsonCursor v;
+  EXPECT_EQ(JsonCursor(R"({"a":1,})").FindField("b", v),
+            kParseErrorInvalidChar);
+  EXPECT_EQ(JsonCursor(R"({"a" 1})").FindField("a", v),
+            kParseErrorInvalidChar);
+  EXPECT_EQ(JsonCursor(R"({"a":1)").FindField("b", v), kParseErrorInvalidChar);
+
+  auto it = JsonCursor("[1, 2").IterateArray();
+  EXPECT_TRUE(it.Next());
+  EXPECT_TRUE(it.Next());
+  EXPECT_FALSE(it.Next());
+  EXPECT_EQ(it.Error(), kParseErrorInvalidChar);
+  it = JsonCursor("[1,").IterateArray();
+  EXPECT_TRUE(it.Next());
+  EXPECT_FALSE(it.Next());
+  EXPECT_EQ(it.Error(), kParseErrorEof);
+  it = JsonCursor("[]").IterateArray();
+  EXPECT_FALSE(it.Next());
+  EXPECT_EQ(it.Error(), kErrorNone);
+}
+
+}  // namespace
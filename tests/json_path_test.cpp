@@ -0,0 +1,161 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/json_path.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+void TestJsonPath(const std::string& json, const std::string& expr,
+                  const std::vector<std::string>& expect) {
+  std::vector<StringView> results;
+  auto ret = GetByJsonPath(json, expr, results);
+  EXPECT_EQ(ret.Error(), kErrorNone) << expr;
+  std::vector<std::string> got;
+  for (auto& r : results) {
+    got.emplace_back(r.data(), r.size());
+  }
+  EXPECT_EQ(got, expect) << expr;
+}
+
+TEST(JsonPath, ChildAndIndex) {
+  std::string json = R"({
+    "a": {"b": [1, {"c": "x"}, [2, 3]], "d": null},
+    "e\"f": true, "g": 1.5e3
+  })";
+  TestJsonPath(json, "$", {json.substr(0)});
+  TestJsonPath(json, "$.a.d", {"null"});
+  TestJsonPath(json, "$['a']['b'][1].c", {R"("x")"});
+  TestJsonPath(json, "$.a.b[2][1]", {"3"});
+  TestJsonPath(json, "$.g", {"1.5e3"});
+  TestJsonPath(json, "$.a.b[3]", {});
+  TestJsonPath(json, "$.x.y", {});
+  TestJsonPath(json, "$.a[0]", {});
+  TestJsonPath(R"({"e\"f":true})", R"($['e"f'])", {"true"});
+}
+
+TEST(JsonPath, WildcardAndSlice) {
+  std::string json = R"({"a":[{"b":1},{"c":2},{"b":[3]},4,{"b":5}]})";
+  TestJsonPath(json, "$.a[*].b", {"1", "[3]", "5"});
+  TestJsonPath(json, "$.a.*.b", {"1", "[3]", "5"});
+  TestJsonPath(json, "$.*[3]", {"4"});
+  TestJsonPath(json, "$.a[1:3]", {R"({"c":2})", R"({"b":[3]})"});
+  TestJsonPath(json, "$.a[::2].b", {"1", "[3]", "5"});
+  TestJsonPath(json, "$.a[3:]", {"4", R"({"b":5})"});
+  TestJsonPath(json, "$.a[:1]", {R"({"b":1})"});
+  TestJsonPath(json, "$.a[10:]", {});
+}
+
+TEST(JsonPath, Descendant) {
+  std::string json =
+      R"({"name":1,"a":{"name":{"name":2},"b":[{"name":3},"name"]}})";
+  TestJsonPath(json, "$..name", {"1", R"({"name":2})", "2", "3"});
+  TestJsonPath(json, "$.a..name", {R"({"name":2})", "2", "3"});
+  TestJsonPath(json, "$..b[0]", {R"({"name":3})"});
+  TestJsonPath(json, "$..[1]", {R"("name")"});
+  TestJsonPath(R"([[1,[2]],3])", "$..*", {"[1,[2]]", "1", "[2]", "2", "3"});
+}
+
+TEST(JsonPath, Filter) {
+  std::string json = R"({"items":[
+    {"id":1,"x":5,"tag":"a","ok":true},
+    {"id":2,"x":2,"tag":"b"},
+    {"id":3,"x":3.5,"tag":"ab","ok":false,"sub":[0,{"k":null}]},
+    {"id":4,"tag":"c"},
+    7
+  ]})";
+  TestJsonPath(json, "$.items[?(@.x > 3)].id", {"1", "3"});
+  TestJsonPath(json, "$.items[?(@.x <= 3)].id", {"2"});
+  TestJsonPath(json, "$.items[?(@.x >= 5)].id", {"1"});
+  TestJsonPath(json, "$.items[?(@.x < 2.5)].id", {"2"});
+  TestJsonPath(json, "$.items[?(@.x != 2)].id", {"1", "3"});
+  TestJsonPath(json, "$.items[?(@.tag == 'ab')].id", {"3"});
+  TestJsonPath(json, R"($.items[?(@.tag < "b")].id)", {"1", "3"});
+  TestJsonPath(json, "$.items[?(@.ok)].id", {"1", "3"});
+  TestJsonPath(json, "$.items[?(@.ok == false)].id", {"3"});
+  TestJsonPath(json, "$.items[?(@.sub[1].k == null)].id", {"3"});
+  TestJsonPath(json, "$.items[?(@['tag'] == 'c')].id", {"4"});
+  TestJsonPath(json, "$..[?(@.k == null)]", {R"({"k":null})"});
+  TestJsonPath(R"({"a":{"x":1},"b":{"x":2}})", "$[?(@.x == 2)]",
+               {R"({"x":2})"});
+}
+
+TEST(JsonPath, InvalidPath) {
+  std::vector<std::string> exprs = {
+      "",        "a",         "$.",       "$[",        "$[-1]",
+      "$[1:2:0]", "$['a'",    "$[?(@.a]", "$[?(@.a ~ 1)]", "$[?(@.a == x)]",
+      "$[?(a)]", "$..",       "$a",
+  };
+  for (const auto& expr : exprs) {
+    JsonPath path;
+    EXPECT_EQ(path.Parse(expr), kErrorInvalidJsonPath) << expr;
+    std::vector<StringView> results;
+    EXPECT_EQ(GetByJsonPath("{}", expr, results).Error(),
+              kErrorInvalidJsonPath)
+        << expr;
+  }
+  std::string expr = "$";
+  for (int i = 0; i < 64; i++) expr += ".a";
+  EXPECT_EQ(JsonPath(expr).Error(), kErrorInvalidJsonPath);
+}
+
+TEST(JsonPath, InvalidJson) {
+  std::vector<std::string> jsons = {
+      "", R"({"a":[1,x]})", R"({"a":)", R"({"a" 1})", R"({"a":[1,2})",
+  };
+  JsonPath path("$.a[*]");
+  for (const auto& json : jsons) {
+    std::vector<StringView> results;
+    EXPECT_NE(GetByJsonPath(json, path, results).Error(), kErrorNone) << json;
+    EXPECT_TRUE(results.empty()) << json;
+  }
+
+  // the errors of the skipped scalars are the same as the matched ones
+  for (std::string json : {"[\"abc", "[1, tru", "[x]"}) {
+    std::vector<StringView> results;
+    auto expect = GetByJsonPath(json, "$[*]", results);
+    EXPECT_NE(expect.Error(), kErrorNone) << json;
+    EXPECT_EQ(GetByJsonPath(json, "$..x", results).Error(), expect.Error())
+        << json;
+  }
+}
+
+TEST(JsonPath, DeepNesting) {
+  // the walker does not recurse on the nested values
+  const size_t depth = 200000;
+  std::string json = std::string(depth, '[') + "{\"x\":1}" +
+                     std::string(depth, ']');
+  std::vector<StringView> results;
+  auto ret = GetByJsonPath(json, "$..x", results);
+  ASSERT_EQ(ret.Error(), kErrorNone);
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0], "1");
+
+  json = std::string(depth, '{');
+  EXPECT_NE(GetByJsonPath(json, "$..x", results).Error(), kErrorNone);
+  json = std::string(depth, '[');
+  EXPECT_EQ(GetByJsonPath(json, "$..x", results).Error(), kParseErrorEof);
+  EXPECT_TRUE(results.empty());
+}
+
+}  // namespace
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+TEST(LazyDocument, ExpandOnAccess) {
+  LazyDocument doc;
+  doc.Parse(R"({"id":1,"name":"lazy node","tags":["a","bcdefghij",[]],
+               "nested":{"k":{},"escaped":"line\nbreaké"},"e\"k":null})");
+  ASSERT_FALSE(doc.HasParseError());
+  const LazyNode& root = doc.GetRoot();
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(root.Size(), 5);
+
+  // the keys are parsed, and the values are raw before the access
+  EXPECT_TRUE(root.HasMember("e\"k"));
+  EXPECT_FALSE(root.HasMember("unknown"));
+  EXPECT_TRUE(root["unknown"].IsNull());
+  const LazyNode& nested = root["nested"];
+  EXPECT_TRUE(nested.IsObject());
+  const LazyNode& tags = root.FindMember("tags")->value;
+  ASSERT_TRUE(tags.IsArray());
+  ASSERT_EQ(tags.Size(), 3);
+  EXPECT_EQ(tags[1].GetStringView(), "bcdefghij");
+  EXPECT_TRUE(tags[2].IsArray());
+  EXPECT_TRUE(tags[2].Empty());
+
+  // the expanded nodes are kept
+  EXPECT_EQ(&root["nested"], &nested);
+  EXPECT_TRUE(nested["escaped"].IsString());
+  EXPECT_EQ(nested["escaped"].GetString(), "line\nbreak\xc3\xa9");
+  EXPECT_EQ(nested["escaped"].GetString(), "line\nbreak\xc3\xa9");
+
+  std::string names;
+  for (auto m = root.MemberBegin(); m != root.MemberEnd(); ++m) {
+    EXPECT_FALSE(m->value.IsRaw());
+    names += m->name.GetString() + ",";
+  }
+  EXPECT_EQ(names, "id,name,tags,nested,e\"k,");
+  EXPECT_EQ(root["id"].GetInt64(), 1);
+  EXPECT_EQ(root["name"].GetStringView(), "lazy node");
+
+  size_t n = 0;
+  for (auto it = tags.Begin(); it != tags.End(); ++it) {
+    EXPECT_FALSE(it->IsRaw());
+    n++;
+  }
+  EXPECT_EQ(n, 3);
+
+  const LazyNode* node = root.AtPointer(JsonPointer({"tags", 0}));
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetStringView(), "a");
+  EXPECT_EQ(root.AtPointer(JsonPointer({"tags", 3})), nullptr);
+  EXPECT_EQ(root.AtPointer(JsonPointer({"id", "x"})), nullptr);
+}
+
+TEST(LazyDocument, SerializeRaw) {
+  // the untouched values are copied as they are, with the spaces
+  const std::string json = R"({"a" : [1, 2.50, {"b" : "A"}], "c": 1E2})";
+  LazyDocument doc;
+  doc.Parse(json);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.Dump(), R"({"a":[1, 2.50, {"b" : "A"}],"c":1E2})");
+
+  // the accessed values are serialized from the nodes
+  const LazyNode& a = doc.GetRoot()["a"];
+  EXPECT_EQ(a[1].GetDouble(), 2.5);
+  EXPECT_EQ(doc.Dump(), R"({"a":[1,2.5,{"b" : "A"}],"c":1E2})");
+  EXPECT_EQ(a[2]["b"].GetStringView(), "A");
+  EXPECT_EQ(doc.Dump(), R"({"a":[1,2.5,{"b":"A"}],"c":1E2})");
+}
+
+TEST(LazyDocument, ParseError) {
+  LazyDocument doc;
+  // the invalid values are found only when expanded, and kept raw
+  doc.Parse("[1,[-],-]");
+  ASSERT_FALSE(doc.HasParseError());
+  const LazyNode& root = doc.GetRoot();
+  EXPECT_TRUE(root[1].IsArray());
+  EXPECT_TRUE(root[1][0].IsRaw());
+  EXPECT_TRUE(root[2].IsRaw());
+  EXPECT_EQ(root[0].GetInt64(), 1);
+}
+
+}  // namespace
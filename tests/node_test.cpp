@@ -508,6 +508,65 @@ TYPED_TEST(NodeTest, RemoveMemberWithDupKey) {
   EXPECT_TRUE(node_map.Empty());
 }
 
+TYPED_TEST(NodeTest, MemberMap) {
+  using NodeType = TypeParam;
+  using Allocator = typename NodeType::alloc_type;
+  Allocator a;
+  NodeType obj(kObject);
+  EXPECT_TRUE(obj.CreateMap(a));
+
+  // the map grows with the added members
+  for (int i = 0; i < 1000; ++i) {
+    std::string key = "key" + std::to_string(i);
+    obj.AddMember(key, NodeType(i), a);
+    EXPECT_EQ(obj[key].GetInt64(), i);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    std::string key = "key" + std::to_string(i);
+    EXPECT_EQ(obj[key].GetInt64(), i);
+    EXPECT_FALSE(obj.HasMember("yek" + std::to_string(i)));
+  }
+
+  // the tail members are moved when removing, and still found by the map
+  for (int i = 0; i < 1000; i += 3) {
+    EXPECT_TRUE(obj.RemoveMember("key" + std::to_string(i)));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    std::string key = "key" + std::to_string(i);
+    if (i % 3 == 0) {
+      EXPECT_FALSE(obj.HasMember(key));
+      EXPECT_FALSE(obj.RemoveMember(key));
+    } else {
+      EXPECT_EQ(obj[key].GetInt64(), i);
+    }
+  }
+
+  // the first added one of the same keys is found
+  NodeType dup(kObject);
+  EXPECT_TRUE(dup.CreateMap(a));
+  for (int i = 0; i < 50; ++i) {
+    dup.AddMember("dup", NodeType(i), a);
+    dup.AddMember("key" + std::to_string(i), NodeType(i), a);
+  }
+  EXPECT_EQ(dup["dup"].GetInt64(), 0);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_TRUE(dup.RemoveMember("dup"));
+  }
+  EXPECT_FALSE(dup.HasMember("dup"));
+  EXPECT_EQ(dup.Size(), 50);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(dup["key" + std::to_string(i)].GetInt64(), i);
+  }
+
+  // create the map of a copied object
+  NodeType copied;
+  copied.CopyFrom(obj, a);
+  EXPECT_TRUE(copied.CreateMap(a));
+  EXPECT_TRUE(copied == obj);
+  copied.DestroyMap();
+  EXPECT_TRUE(copied == obj);
+}
+
 TYPED_TEST(NodeTest, Erase) {
   using NodeType = TypeParam;
   using Allocator = typename NodeType::alloc_type;
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/parallel_array.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+std::string GenArray(int n) {
+  std::string json = " [";
+  for (int i = 0; i < n; i++) {
+    if (i) json += i % 3 ? "," : " ,\n ";
+    json += "{\"id\":" + std::to_string(i) + ",\"s\":\"" +
+            std::string(i % 40, 'x') + "\\n\\u4e2d\",\"a\":[1,-2.5,null," +
+            (i % 2 ? "true" : "{}") + "],\"e\":[]}";
+  }
+  json += "]\n";
+  return json;
+}
+
+template <typename NodeType>
+class ParallelArrayTest : public testing::Test {};
+
+using NodeTypes =
+    testing::Types<DNode<MemoryPoolAllocator<>>, DNode<SimpleAllocator>>;
+TYPED_TEST_SUITE(ParallelArrayTest, NodeTypes);
+
+TYPED_TEST(ParallelArrayTest, ParseValid) {
+  std::string big = GenArray(20000);
+  std::vector<std::string> tests = {
+      big,
+      // not an array
+      "{\"a\":" + big + "}",
+      GenArray(3),
+      "[]",
+      "[1]",
+      "[[1,[2]],{\"a\":[3]}]",
+  };
+  for (auto& json : tests) {
+    GenericDocument<TypeParam> expect;
+    expect.Parse(json);
+    ASSERT_FALSE(expect.HasParseError());
+    for (size_t threads : {0, 1, 2, 4, 7}) {
+      GenericDocument<TypeParam> doc;
+      doc.ParseArrayParallel(json, threads);
+      EXPECT_FALSE(doc.HasParseError()) << threads;
+      EXPECT_EQ(doc.GetErrorOffset(), expect.GetErrorOffset());
+      EXPECT_TRUE(doc == expect) << threads;
+    }
+  }
+}
+
+TYPED_TEST(ParallelArrayTest, ParseInvalid) {
+  std::string big = GenArray(20000);
+  std::vector<std::string> tests = {
+      // the bad element is in a late group
+      big.substr(0, big.rfind("\"e\":[]")) + "\"e\":[}" +
+          big.substr(big.rfind("\"e\":[]") + 6),
+      big.substr(0, big.size() - 2),
+      big + "x",
+      big + "]",
+      "[1,2,]",
+      "",
+      "[",
+  };
+  for (auto& json : tests) {
+    GenericDocument<TypeParam> expect;
+    expect.Parse(json);
+    ASSERT_TRUE(expect.HasParseError());
+    for (size_t threads : {1, 2, 4}) {
+      GenericDocument<TypeParam> doc;
+      doc.ParseArrayParallel(json, threads);
+      EXPECT_EQ(doc.GetParseError(), expect.GetParseError()) << threads;
+      EXPECT_EQ(doc.GetErrorOffset(), expect.GetErrorOffset()) << threads;
+    }
+  }
+}
+
+TYPED_TEST(ParallelArrayTest, Reuse) {
+  std::string json = GenArray(20000);
+  GenericDocument<TypeParam> doc;
+  doc.Parse("{\"a\":1}");
+  doc.ParseArrayParallel(json, 4);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.Size(), 20000u);
+  EXPECT_EQ(doc[19999]["id"].GetInt64(), 19999);
+
+  // the nodes are owned by the document, and can be modified
+  TypeParam node;
+  node.SetString("new", doc.GetAllocator());
+  doc[0]["s"] = std::move(node);
+  doc.PushBack(TypeParam(1), doc.GetAllocator());
+  EXPECT_EQ(doc.Size(), 20001u);
+  EXPECT_EQ(doc[0]["s"].GetString(), "new");
+
+  doc.ParseArrayParallel(json, 2);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.Size(), 20000u);
+}
+
+TYPED_TEST(ParallelArrayTest, ParsePackNumbers) {
+  std::string ints = "[0";
+  std::string arrays = "[[0]";
+  for (int i = 1; i < 100000; i++) {
+    ints += "," + std::to_string(i * 7 - 300000);
+    arrays += ",[" + std::to_string(i) + ",2.5]";
+  }
+  std::vector<std::string> tests = {
+      ints + "]",
+      // the root is unpacked by the elements of the last group
+      ints + ",0.5]",
+      ints + ",\"s\"]",
+      "[0.5," + ints.substr(1) + "]",
+      arrays + "]",
+      GenArray(20000),
+  };
+  for (auto& json : tests) {
+    GenericDocument<TypeParam> expect;
+    expect.template Parse<kParsePackNumbers>(json);
+    ASSERT_FALSE(expect.HasParseError());
+    for (size_t threads : {2, 4}) {
+      GenericDocument<TypeParam> doc;
+      doc.template ParseArrayParallel<kParsePackNumbers>(json, threads);
+      EXPECT_FALSE(doc.HasParseError()) << threads;
+      EXPECT_EQ(doc.GetType(), expect.GetType()) << threads;
+      EXPECT_EQ(doc[1].GetType(), expect[1].GetType()) << threads;
+      EXPECT_EQ(doc.Size(), expect.Size()) << threads;
+      EXPECT_EQ(doc.Dump(), expect.Dump()) << threads;
+    }
+  }
+}
+
+TEST(ParallelArray, ParseCreateMap) {
+  std::string json = GenArray(20000);
+  Document plain;
+  plain.ParseArrayParallel(json, 4);
+  ASSERT_FALSE(plain.HasParseError());
+  Document doc;
+  doc.SetMapThreshold(2);
+  doc.ParseArrayParallel<kParseCreateMap>(json, 4);
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc == plain);
+  EXPECT_EQ(doc[19999]["id"].GetInt64(), 19999);
+  EXPECT_TRUE(doc[19999]["x"].IsNull());
+  // the objects of all groups have the maps
+  EXPECT_GT(doc.GetAllocator().Size(),
+            plain.GetAllocator().Size() + 20000 * sizeof(uint32_t));
+}
+
+TEST(ParallelArray, SplitArray) {
+  std::string json = GenArray(1000);
+  std::vector<std::pair<size_t, size_t>> groups;
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+  ASSERT_TRUE(internal::SplitArray(data, json.size(), 4096, groups));
+  EXPECT_GT(groups.size(), 1u);
+  EXPECT_EQ(json[groups.front().first - 1], '[');
+  EXPECT_EQ(json[groups.back().second], ']');
+  for (size_t i = 1; i < groups.size(); i++) {
+    EXPECT_EQ(json[groups[i].first - 1], ',');
+    EXPECT_EQ(groups[i].first, groups[i - 1].second + 1);
+    EXPECT_GE(groups[i - 1].second - groups[i - 1].first, 4096u);
+  }
+  groups.clear();
+  EXPECT_FALSE(internal::SplitArray(data, json.size() - 2, 4096, groups));
+}
+
+}  // namespace
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/parallel_stream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+std::string GenNdjson(int n) {
+  std::string json;
+  for (int i = 0; i < n; i++) {
+    if (i % 17 == 5) {
+      json += "{\"id\":" + std::to_string(i) + ",\"bad\":[}\n";
+    } else if (i % 23 == 7) {
+      json += "\n  \n";
+    } else {
+      json += "{\"id\":" + std::to_string(i) + ",\"s\":\"" +
+              std::string(i % 50, 'x') + "\",\"a\":[1,2.5,null]}\n";
+    }
+  }
+  return json;
+}
+
+// (offset, has error) of all records, from the sequential DocumentStream.
+std::vector<std::pair<size_t, bool>> Expect(const std::string& json) {
+  std::vector<std::pair<size_t, bool>> ret;
+  DocumentStream stream(json);
+  while (stream.Next()) {
+    ret.emplace_back(stream.Offset(), stream.Doc().HasParseError());
+  }
+  return ret;
+}
+
+template <typename NodeType>
+class ParallelStreamTest : public testing::Test {};
+
+using NodeTypes =
+    testing::Types<DNode<MemoryPoolAllocator<>>, DNode<SimpleAllocator>>;
+TYPED_TEST_SUITE(ParallelStreamTest, NodeTypes);
+
+TYPED_TEST(ParallelStreamTest, Unordered) {
+  std::string json = GenNdjson(2000);
+  auto expect = Expect(json);
+  for (size_t threads : {1, 2, 4, 7}) {
+    for (size_t shard : {1, 100, 4096, 1 << 20}) {
+      ParallelOptions opts;
+      opts.threads = threads;
+      opts.shard_size = shard;
+      GenericParallelDocumentStream<TypeParam> ps(opts);
+      std::mutex mu;
+      std::vector<std::pair<size_t, bool>> got;
+      std::atomic<size_t> mismatch{0};
+      ps.Parse(json, [&](size_t off, GenericDocument<TypeParam>& doc) {
+        if (!doc.HasParseError()) {
+          size_t end = json.find('\n', off);
+          GenericDocument<TypeParam> one;
+          one.Parse(json.data() + off, end - off);
+          if (!(one == doc)) mismatch++;
+        }
+        std::lock_guard<std::mutex> lk(mu);
+        got.emplace_back(off, doc.HasParseError());
+      });
+      std::sort(got.begin(), got.end());
+      EXPECT_EQ(got, expect) << threads << " " << shard;
+      EXPECT_EQ(mismatch, 0u);
+    }
+  }
+}
+
+TYPED_TEST(ParallelStreamTest, Ordered) {
+  std::string json = GenNdjson(2000);
+  auto expect = Expect(json);
+  for (size_t threads : {1, 2, 4, 7}) {
+    for (size_t shard : {1, 100, 4096, 1 << 20}) {
+      ParallelOptions opts;
+      opts.threads = threads;
+      opts.shard_size = shard;
+      opts.ordered = true;
+      opts.window = 2;
+      GenericParallelDocumentStream<TypeParam> ps(opts);
+      std::vector<std::pair<size_t, bool>> got;
+      int64_t last_id = -1;
+      bool in_order = true;
+      ps.Parse(json, [&](size_t off, GenericDocument<TypeParam>& doc) {
+        got.emplace_back(off, doc.HasParseError());
+        if (!doc.HasParseError()) {
+          int64_t id = doc["id"].GetInt64();
+          in_order = in_order && id > last_id;
+          last_id = id;
+        }
+      });
+      EXPECT_EQ(got, expect) << threads << " " << shard;
+      EXPECT_TRUE(in_order);
+    }
+  }
+}
+
+TEST(ParallelStream, Empty) {
+  ParallelDocumentStream ps;
+  size_t cnt = 0;
+  auto cb = [&](size_t, Document&) { cnt++; };
+  ps.Parse("", cb);
+  ps.Parse("\n \n\n", cb);
+  EXPECT_EQ(cnt, 0u);
+  ps.Parse("[1]", cb);
+  EXPECT_EQ(cnt, 1u);
+}
+
+}  // namespace
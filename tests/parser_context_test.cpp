@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/parser_context.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+template <typename NodeType>
+class ParserContextTest : public testing::Test {};
+
+using NodeTypes =
+    testing::Types<DNode<MemoryPoolAllocator<>>, DNode<SimpleAllocator>>;
+TYPED_TEST_SUITE(ParserContextTest, NodeTypes);
+
+TYPED_TEST(ParserContextTest, Reuse) {
+  using Document = GenericDocument<TypeParam>;
+  std::vector<std::string> jsons = {
+      R"({"a":[1,2,{"b":null}],"c":"x\ty"})",
+      "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+      R"("中")",
+      "[1, tru]",  // the error does not break the context
+      R"({"k":")" + std::string(1000, 'v') + R"("})",
+      "{}",
+  };
+  GenericParserContext<TypeParam> ctx;
+  Document doc;
+  for (const auto& json : jsons) {
+    Document expect;
+    expect.Parse(json);
+    doc.Parse(json, ctx);
+    EXPECT_EQ(doc.GetParseError(), expect.GetParseError()) << json;
+    EXPECT_EQ(doc.GetErrorOffset(), expect.GetErrorOffset()) << json;
+    if (!doc.HasParseError()) {
+      EXPECT_TRUE(doc == expect) << json;
+    }
+  }
+
+  doc.Parse("[]", ctx);
+  EXPECT_EQ(doc.Size(), 0u);
+}
+
+TYPED_TEST(ParserContextTest, SharedByDocuments) {
+  using Document = GenericDocument<TypeParam>;
+  GenericParserContext<TypeParam> ctx;
+  Document doc1, doc2;
+  doc1.Parse(R"({"a":"b"})", ctx);
+  EXPECT_EQ(doc1["a"].GetString(), "b");
+  doc2.Parse(R"(["c", 1])", ctx);
+  EXPECT_EQ(doc2[0].GetString(), "c");
+  EXPECT_EQ(doc2[1].GetInt64(), 1);
+}
+
+TYPED_TEST(ParserContextTest, InternKeys) {
+  using Document = GenericDocument<TypeParam>;
+  // the key table is sized by each json, and reused by the context
+  std::string big = "[{";
+  for (int i = 0; i < 600; i++) {
+    if (i) big += ",";
+    big += "\"member_" + std::to_string(i) + "\":" + std::to_string(i);
+  }
+  big += "},{\"member_0\":0}]";
+  std::string small = R"([{"identity":1},{"member_0":2},{"identity":3}])";
+  GenericParserContext<TypeParam> ctx;
+  for (const auto& json : {big, small, big, small}) {
+    Document expect;
+    expect.Parse(json);
+    Document doc;
+    doc.template Parse<kParseInternKeys>(json, ctx);
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_TRUE(doc == expect);
+    size_t last = doc.Size() - 1;
+    EXPECT_EQ(doc[last].MemberBegin()->name.GetStringView().data(),
+              doc[0].MemberBegin()->name.GetStringView().data());
+  }
+  Document doc;
+  doc.template Parse<kParseInternKeys>(small, ctx);
+  EXPECT_EQ(doc[1]["member_0"].GetInt64(), 2);
+  EXPECT_EQ(doc[2]["identity"].GetInt64(), 3);
+}
+
+TYPED_TEST(ParserContextTest, DocumentOwnsStrings) {
+  using Document = GenericDocument<TypeParam>;
+  // the strings are longer than the inline strings of the nodes
+  const std::string long1 = "the first long string\\twith an escape";
+  const std::string long2(100, 'x');
+  Document doc1, doc2;
+  {
+    GenericParserContext<TypeParam> ctx;
+    doc1.Parse(R"({"key of doc1":")" + long1 + R"("})", ctx);
+    ASSERT_FALSE(doc1.HasParseError());
+    // reuse the context, which must not change doc1
+    doc2.Parse(R"([")" + long2 + R"(", ")" + long2 + R"("])", ctx);
+    ASSERT_FALSE(doc2.HasParseError());
+    EXPECT_EQ(doc1["key of doc1"].GetString(),
+              "the first long string\twith an escape");
+  }
+  // and both documents are valid after the context is destroyed
+  EXPECT_EQ(doc1.Dump(), R"({"key of doc1":")" + long1 + R"("})");
+  EXPECT_EQ(doc2[1].GetString(), long2);
+}
+
+}  // namespace
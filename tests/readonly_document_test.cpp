@@ -0,0 +1,142 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+#include "tests/test_util.h"
+
+// The tests shared by the read-only documents, which must read and serialize
+// the same as Document.
+
+namespace {
+
+using namespace sonic_json;
+
+template <typename DocType>
+class ReadOnlyDocumentTest : public testing::Test {};
+
+using DocTypes = testing::Types<CompactDocument, TapeDocument, LazyDocument>;
+TYPED_TEST_SUITE(ReadOnlyDocumentTest, DocTypes);
+
+template <typename DocType>
+DocType& parseValidated(DocType& doc, const std::string& json) {
+  return doc.template Parse<kParseValidateUtf8>(json);
+}
+
+// LazyDocument has no parse flags.
+LazyDocument& parseValidated(LazyDocument& doc, const std::string& json) {
+  return doc.Parse(json);
+}
+
+// Visit all nodes, which expands all the values of LazyDocument.
+template <typename NodeType>
+size_t countAll(const NodeType& node) {
+  size_t n = 1;
+  if (node.IsObject()) {
+    for (auto m = node.MemberBegin(); m != node.MemberEnd(); ++m) {
+      n += countAll(m->value);
+    }
+  } else if (node.IsArray()) {
+    for (auto it = node.Begin(); it != node.End(); ++it) n += countAll(*it);
+  }
+  return n;
+}
+
+TYPED_TEST(ReadOnlyDocumentTest, ParseScalars) {
+  TypeParam doc;
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+
+  doc.Parse("null");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  doc.Parse(" true ");
+  EXPECT_TRUE(doc.GetRoot().IsTrue());
+  doc.Parse("-7");
+  EXPECT_EQ(doc.GetRoot().GetInt64(), -7);
+  doc.Parse("1.5");
+  EXPECT_EQ(doc.GetRoot().GetDouble(), 1.5);
+  doc.Parse("\"line\\nbreak\"");
+  EXPECT_EQ(doc.GetRoot().GetString(), "line\nbreak");
+  EXPECT_EQ(doc.Dump(), "\"line\\nbreak\"");
+}
+
+TYPED_TEST(ReadOnlyDocumentTest, Serialize) {
+  const std::string jsons[] = {
+      "null",
+      "-1.25",
+      "\"\"",
+      "[]",
+      "{}",
+      "[[],{},[[{}]]]",
+      R"({"a":[1,-2,3.5,true,false,null,"s",{"b":{}}],"long key name":"v"})",
+      R"([[[[]]],{"x":[18446744073709551615,-9223372036854775808,0.1]}])",
+      R"({"escaped":"\"\\\/\b\f\n\r\t","unicode":"中文"})",
+  };
+  for (const auto& json : jsons) {
+    TypeParam rdoc;
+    rdoc.Parse(json);
+    ASSERT_FALSE(rdoc.HasParseError()) << json;
+    Document doc;
+    doc.Parse(json);
+    ASSERT_FALSE(doc.HasParseError()) << json;
+    // LazyDocument copies the untouched values as they are
+    EXPECT_EQ(countAll(rdoc.GetRoot()), countAll<DNode<>>(doc)) << json;
+    EXPECT_EQ(rdoc.Dump(), doc.Dump()) << json;
+    if (rdoc.GetRoot().IsObject()) {
+      EXPECT_EQ(rdoc.GetRoot()["unknown"].Dump(), "null");
+    }
+  }
+}
+
+TYPED_TEST(ReadOnlyDocumentTest, ParseFiles) {
+  for (const char* file : {"twitter", "citm_catalog", "canada"}) {
+    std::string json = test::GetTestData(file);
+    TypeParam rdoc;
+    parseValidated(rdoc, json);
+    ASSERT_FALSE(rdoc.HasParseError()) << file;
+    Document doc;
+    doc.Parse(json);
+    ASSERT_FALSE(doc.HasParseError()) << file;
+    EXPECT_EQ(countAll(rdoc.GetRoot()), countAll<DNode<>>(doc)) << file;
+    EXPECT_EQ(rdoc.Dump(), doc.Dump()) << file;
+  }
+}
+
+TYPED_TEST(ReadOnlyDocumentTest, ParseError) {
+  TypeParam doc;
+  doc.Parse("{\"a\":[1,2}");
+  EXPECT_TRUE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  doc.Parse("tru");
+  EXPECT_TRUE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+
+  // reuse the document after errors
+  doc.Parse("[1,2]");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.Dump(), "[1,2]");
+
+  TypeParam moved(std::move(doc));
+  EXPECT_EQ(moved.GetRoot()[1].GetInt64(), 2);
+  EXPECT_EQ(moved.Dump(), "[1,2]");
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  doc = std::move(moved);
+  EXPECT_EQ(doc.Dump(), "[1,2]");
+}
+
+}  // namespace
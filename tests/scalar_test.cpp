@@ -0,0 +1,254 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/internal/arch/scalar/itoa.h"
+#include "sonic/internal/arch/scalar/member.h"
+#include "sonic/internal/arch/scalar/quote.h"
+#include "sonic/internal/arch/scalar/skip.h"
+#include "sonic/internal/arch/scalar/str2int.h"
+#include "sonic/internal/arch/scalar/structural.h"
+#include "sonic/internal/arch/simd_itoa.h"
+#include "sonic/internal/arch/simd_member.h"
+#include "sonic/internal/arch/simd_skip.h"
+#include "sonic/internal/arch/simd_str2int.h"
+#include "sonic/internal/arch/simd_structural.h"
+#include "sonic/sonic.h"
+#include "tests/test_util.h"
+
+// The scalar kernels are checked against the kernels of the compiled arch.
+
+namespace {
+
+using namespace sonic_json;
+namespace scalar = sonic_json::internal::scalar;
+
+std::vector<std::string> GetJsons() {
+  std::vector<std::string> jsons;
+  for (const char* file : {"book", "citm_catalog", "github_events", "lottie",
+                           "twitter", "twitterescaped"}) {
+    jsons.push_back(test::GetTestData(file));
+  }
+  jsons.push_back(R"( [ "\\", "\\\"", "\"\\\\\"" , {"a\"]" : [-1.5e3,true]} ] )");
+  jsons.push_back("[\"" + std::string(70, '\\') + "\"," +
+                  std::string(100, ' ') + "\"\xe4\xb8\xad\\u4e2d\"]");
+  return jsons;
+}
+
+std::vector<uint32_t> GetIndex(const std::string& json, bool use_scalar) {
+  std::vector<uint32_t> index(json.size() + 8);
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(json.data());
+  size_t n =
+      use_scalar
+          ? scalar::BuildStructuralIndex(data, json.size(), &index[0])
+          : internal::BuildStructuralIndex(data, json.size(), &index[0]);
+  index.resize(n);
+  return index;
+}
+
+TEST(Scalar, StructuralIndex) {
+  for (const auto& json : GetJsons()) {
+    EXPECT_EQ(GetIndex(json, true), GetIndex(json, false));
+  }
+  // escapes and scalars at all offsets of blocks
+  for (size_t pad = 0; pad < 70; pad++) {
+    std::string json = std::string(pad, ' ') + "[\"" + std::string(pad, '\\') +
+                       "\\\"\",123,true,\"" + std::string(pad, 'x') +
+                       "\"]\\\"";
+    EXPECT_EQ(GetIndex(json, true), GetIndex(json, false)) << json;
+  }
+}
+
+TEST(Scalar, Skip) {
+  for (const auto& json : GetJsons()) {
+    // the padding chars are not spaces, as the parser.
+    std::string padded = json + std::string(SONICJSON_PADDING * 2, 'x');
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(padded.data());
+    size_t len = json.size();
+    for (uint32_t i : GetIndex(json, false)) {
+      size_t p1 = i + 1, p2 = i + 1;
+      uint8_t c = data[i];
+      if (c == '"') {
+        int r1 = scalar::SkipString(data, p1, len);
+        int r2 = internal::SkipString(data, p2, len);
+        ASSERT_EQ(r1 != 0, r2 != 0) << i;
+        ASSERT_EQ(p1, p2) << i;
+        // the SIMD kernels may mark the normal strings as escaped.
+        if (r2 == 1) {
+          EXPECT_EQ(r1, 1) << i;
+        }
+
+        p1 = p2 = i + 1;
+        EXPECT_EQ(scalar::ValidateString(data, p1, len),
+                  internal::ValidateString(data, p2, len));
+        EXPECT_EQ(p1, p2) << i;
+      } else if (c == '{' || c == '[') {
+        uint8_t right = c + 2;
+        ASSERT_EQ(scalar::SkipContainer(data, p1, len, c, right),
+                  internal::SkipContainer(data, p2, len, c, right));
+        ASSERT_EQ(p1, p2) << i;
+      }
+
+      p1 = p2 = i;
+      EXPECT_EQ(scalar::GetNextToken(data, p1, len, "]},"),
+                internal::GetNextToken(data, p2, len, "]},"));
+      EXPECT_EQ(p1, p2) << i;
+
+      // the cached space bits are only valid when skipping forward
+      size_t end1 = 0, end2 = 0;
+      uint64_t bits1 = 0, bits2 = 0;
+      p1 = p2 = i + 1;
+      EXPECT_EQ(scalar::skip_space(data, p1, end1, bits1),
+                internal::skip_space(data, p2, end2, bits2));
+      EXPECT_EQ(p1, p2) << i;
+      p1 = p2 = i + 1;
+      end1 = end2 = bits1 = bits2 = 0;
+      EXPECT_EQ(scalar::skip_space_safe(data, p1, len, end1, bits1),
+                internal::skip_space_safe(data, p2, len, end2, bits2));
+      EXPECT_EQ(p1, p2) << i;
+    }
+  }
+}
+
+void TestParseString(const std::string& str) {
+  for (bool utf8 : {false, true}) {
+    std::string s1 = str + std::string(SONICJSON_PADDING, '\0');
+    std::string s2 = s1;
+    uint8_t* src1 = reinterpret_cast<uint8_t*>(&s1[0]);
+    uint8_t* src2 = reinterpret_cast<uint8_t*>(&s2[0]);
+    SonicError err1 = kErrorNone, err2 = kErrorNone;
+    size_t n1 = utf8 ? scalar::parseStringInplaceUtf8(src1, err1)
+                     : scalar::parseStringInplace(src1, err1);
+    size_t n2 = utf8 ? internal::parseStringInplaceUtf8(src2, err2)
+                     : internal::parseStringInplace(src2, err2);
+    EXPECT_EQ(err1, err2) << str;
+    if (err1 || err2) continue;
+    EXPECT_EQ(n1, n2) << str;
+    EXPECT_EQ(src1 - reinterpret_cast<uint8_t*>(&s1[0]),
+              src2 - reinterpret_cast<uint8_t*>(&s2[0]))
+        << str;
+    EXPECT_EQ(s1.substr(0, n1), s2.substr(0, n2)) << str;
+  }
+}
+
+TEST(Scalar, ParseString) {
+  for (const auto& json : GetJsons()) {
+    for (uint32_t i : GetIndex(json, false)) {
+      if (json[i] != '"') continue;
+      size_t end = i + 1;
+      scalar::SkipString(reinterpret_cast<const uint8_t*>(json.data()), end,
+                         json.size());
+      TestParseString(json.substr(i + 1, end - i - 1));
+    }
+  }
+  std::vector<std::string> tests = {
+      R"(abc\"\\\/\b\f\n\r\t中😀")",
+      "\xe4\xb8\xad\xf0\x9f\x98\x80\"",
+      "\xe4\xb8\"",
+      "\xc0\xaf\"",
+      "\xed\xa0\x80\"",
+      "\x80\"",
+      "a\tb\"",
+      R"(\a")",
+      R"(\u12G4")",
+  };
+  // the chars at all offsets of the 64-byte blocks
+  for (const auto& t : tests) {
+    for (size_t pad = 0; pad < 70; pad++) {
+      TestParseString(std::string(pad, 'x') + t);
+      TestParseString(std::string(pad, 'x') + "\\n" + t);
+    }
+  }
+}
+
+TEST(Scalar, Quote) {
+  std::vector<std::string> tests = {
+      "",
+      "\"",
+      "abcdefgh\\",
+      "景hello\b\f\n\r\t\\\"world",
+      std::string("\x01\x02\x1f\0", 4) + std::string(20, 'x') + "\"\"\x7f",
+  };
+  for (const auto& json : GetJsons()) tests.push_back(json);
+  for (size_t n = 1; n < 70; n++) tests.push_back(std::string(n, 'x') + "\n");
+  for (const auto& t : tests) {
+    size_t n = t.size();
+    std::vector<char> buf1(n * 6 + 32), buf2(n * 6 + 32);
+    char* end1 = scalar::Quote(t.data(), n, &buf1[0]);
+    char* end2 = internal::Quote(t.data(), n, &buf2[0]);
+    EXPECT_EQ(std::string(&buf1[0], end1), std::string(&buf2[0], end2));
+  }
+}
+
+TEST(Scalar, Itoa) {
+  uint64_t v = 1;
+  for (int i = 0; i < 10000; i++) {
+    v = v * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t v8 = (v >> 32) % 100000000;
+    uint64_t v16 = v % 10000000000000000ULL;
+    char buf1[32], buf2[32], expect[32];
+    snprintf(expect, sizeof(expect), "%08u", v8);
+    EXPECT_EQ(scalar::Utoa_8(v8, buf1) - buf1, 8);
+    internal::Utoa_8(v8, buf2);
+    EXPECT_EQ(std::string(buf1, 8), expect);
+    EXPECT_EQ(std::string(buf1, 8), std::string(buf2, 8));
+
+    snprintf(expect, sizeof(expect), "%016llu", (unsigned long long)v16);
+    EXPECT_EQ(scalar::Utoa_16(v16, buf1) - buf1, 16);
+    internal::Utoa_16(v16, buf2);
+    EXPECT_EQ(std::string(buf1, 16), expect);
+    EXPECT_EQ(std::string(buf1, 16), std::string(buf2, 16));
+  }
+}
+
+TEST(Scalar, Str2Int) {
+  std::vector<std::string> tests = {
+      "0",        "12345678",         "1234567890123456", "123.45",
+      "9e10",     "0000000000000001", "12345678901234567890",
+  };
+  for (const auto& t : tests) {
+    std::string s = t + std::string(32, '\0');
+    for (int nd = 1; nd <= 16; nd++) {
+      int nd1 = nd, nd2 = nd;
+      EXPECT_EQ(scalar::simd_str2int(s.data(), nd1),
+                internal::simd_str2int(s.data(), nd2))
+          << t;
+      EXPECT_EQ(nd1, nd2) << t;
+    }
+  }
+}
+
+TEST(Scalar, FindTag) {
+  std::vector<uint64_t> tags(72);
+  for (size_t i = 0; i < tags.size(); i++) tags[i] = i % 5;
+  tags[70] = 7;
+  for (size_t n = 0; n <= 72; n++) {
+    for (size_t start = 0; start <= n; start++) {
+      for (uint64_t tag : {0, 3, 4, 7, 9}) {
+        EXPECT_EQ(scalar::FindTag(tags.data(), start, n, tag),
+                  internal::FindTag(tags.data(), start, n, tag))
+            << n << " " << start << " " << tag;
+      }
+    }
+  }
+}
+
+}  // namespace
@@ -15,6 +15,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "sonic/dom/parser.h"
@@ -93,4 +94,66 @@ TEST(GetOnDemand, Failed) {
 
   TestGetOnDemandFailed(R"("\")", {}, ParseResult(kParseErrorInvalidChar, 3));
 }
+
+TEST(GetOnDemandMulti, Success) {
+  std::string json = R"({
+    "a": {"b": [10, {"c": "x"}, 12], "d\u0065": true},
+    "e": [[1, 2], [3, 4]],
+    "f": null,
+    "a": {"b": [0]}
+  })";
+  std::vector<JsonPointer> paths = {
+      {"a", "b", 1, "c"}, {"a", "de"}, {"e", 1, 0}, {"a", "b", 2},
+      {"e", 0},           {"f"},       {"a", "b"},  {},
+      {"e", 2},           {"f", "g"},  {"a", 0},    {"a", "b", 1, "c"},
+  };
+  std::vector<StringView> targets;
+  auto result = GetOnDemandMulti(json, paths, targets);
+  EXPECT_EQ(result.Error(), kErrorNone);
+  ASSERT_EQ(targets.size(), paths.size());
+  // the same as GetOnDemand, and the first one of duplicated keys is used
+  for (size_t i = 0; i < paths.size(); i++) {
+    StringView expect;
+    GetOnDemand(json, paths[i], expect);
+    EXPECT_EQ(targets[i], expect) << i;
+  }
+  EXPECT_EQ(targets[0], "\"x\"");
+  EXPECT_EQ(targets[6], R"([10, {"c": "x"}, 12])");
+  EXPECT_EQ(targets[7], json);
+  EXPECT_TRUE(targets[8].empty());
+  EXPECT_TRUE(targets[9].empty());
+  EXPECT_TRUE(targets[10].empty());
+
+  // the duplicated key before another wanted key is counted once
+  std::string dup = R"({"a":1,"a":2,"b":3})";
+  GetOnDemandMulti(dup, {{"a"}, {"b"}}, targets);
+  EXPECT_EQ(targets, std::vector<StringView>({"1", "3"}));
+  dup = R"({"x":{"a":1,"a":2,"b":3},"y":4})";
+  GetOnDemandMulti(dup, {{"x", "a"}, {"x", "b"}, {"y"}}, targets);
+  EXPECT_EQ(targets, std::vector<StringView>({"1", "3", "4"}));
+
+  // reuse the compiled paths
+  JsonPointerTrie trie;
+  EXPECT_EQ(trie.Add({"f"}), 0u);
+  EXPECT_EQ(trie.Add({"e", 1}), 1u);
+  GetOnDemandMulti(json, trie, targets);
+  EXPECT_EQ(targets, std::vector<StringView>({"null", "[3, 4]"}));
+}
+
+TEST(GetOnDemandMulti, Failed) {
+  std::vector<StringView> targets;
+  std::vector<JsonPointer> paths = {{"a"}, {"b", 1}};
+  auto result = GetOnDemandMulti(R"({"a":1,"b":[1,x]})", paths, targets);
+  EXPECT_EQ(result.Error(), kParseErrorInvalidChar);
+  EXPECT_EQ(result.Offset(), 14u);
+  EXPECT_EQ(targets, std::vector<StringView>(2));
+
+  // the text after all paths are found is not scanned
+  result = GetOnDemandMulti(R"({"a":1,"b":[1,2,x]})", paths, targets);
+  EXPECT_EQ(result.Error(), kErrorNone);
+  EXPECT_EQ(targets, std::vector<StringView>({"1", "2"}));
+
+  result = GetOnDemandMulti(R"({"\g":1})", {{"b"}}, targets);
+  EXPECT_EQ(result.Error(), kParseErrorEscapedFormat);
+}
 }  // namespace
\ No newline at end of file
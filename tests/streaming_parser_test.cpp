@@ -0,0 +1,187 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+#include "tests/test_util.h"
+
+namespace {
+
+using namespace sonic_json;
+
+template <typename DocType>
+DocType& ParseInChunks(DocType& doc, const std::string& json, size_t chunk) {
+  for (size_t i = 0; i < json.size(); i += chunk) {
+    // copy the chunk to make sure the parser does not keep it
+    std::string part = json.substr(i, chunk);
+    doc.ParseChunk(part);
+  }
+  return doc.ParseChunkEnd();
+}
+
+template <typename DocType>
+class StreamingParserTest : public testing::Test {};
+
+using DocTypes =
+    testing::Types<Document, GenericDocument<DNode<SimpleAllocator>>>;
+TYPED_TEST_SUITE(StreamingParserTest, DocTypes);
+
+TYPED_TEST(StreamingParserTest, ParseFiles) {
+  const char* files[] = {
+      "book",      "canada",      "citm_catalog", "github_events",
+      "gsoc-2018", "lottie",      "poet",         "twitter",
+      "twitterescaped",
+  };
+  for (const char* file : files) {
+    std::string json = test::GetTestData(file);
+    TypeParam expect;
+    expect.Parse(json);
+    ASSERT_FALSE(expect.HasParseError()) << file;
+    for (size_t chunk : {1, 7, 64, 4096, 1 << 30}) {
+      // 1-byte chunks are slow for large files
+      if (chunk == 1 && json.size() > (1 << 18)) continue;
+      TypeParam doc;
+      ParseInChunks(doc, json, chunk);
+      EXPECT_FALSE(doc.HasParseError()) << file << " chunk " << chunk;
+      EXPECT_TRUE(doc == expect) << file << " chunk " << chunk;
+    }
+  }
+}
+
+TYPED_TEST(StreamingParserTest, ParseValid) {
+  std::vector<std::string> tests = {
+      "true",
+      " false ",
+      "null",
+      "\"\"",
+      "-0.5e-3",
+      "123",
+      "18446744073709551615",
+      "{}",
+      "[]",
+      "[[[]]]",
+      R"({"a":{"b":[1,2,{"c":null}]},"d":"\u0041\n"})",
+      R"(  [ 1 , "x" , true , { } , [ ] ]  )",
+      R"(["\\", "\\\"", "\"\\", "\ud83d\ude00", "中文"])",
+      R"({"":"","\\":"\\\\","a\"b":1.5})",
+  };
+  for (auto& json : tests) {
+    TypeParam expect;
+    expect.Parse(json);
+    ASSERT_FALSE(expect.HasParseError()) << json;
+    for (size_t chunk = 1; chunk <= json.size(); chunk++) {
+      TypeParam doc;
+      ParseInChunks(doc, json, chunk);
+      EXPECT_FALSE(doc.HasParseError()) << json << " chunk " << chunk;
+      EXPECT_EQ(doc.GetErrorOffset(), json.size());
+      EXPECT_TRUE(doc == expect) << json << " chunk " << chunk;
+    }
+  }
+}
+
+TYPED_TEST(StreamingParserTest, ParseInvalid) {
+  std::vector<std::string> tests = {
+      "",          "   ",          "1.",        "truef",      "true:",
+      "tru",       "nullnull",     "[fase0]",   "[1.2x]",     "[1 x]",
+      "[truex]",   "[\"a\"b]",     "{\"\":1,}", "{:,}",       "{[]}",
+      "[[[[[[",    "[\"abc",       "[1,]",      "[1 2]",      "{\"a\" 1}",
+      "{\"a\":1 \"b\":2}", "[1]]", "\"\\g\"",   "[\"\x01\"]", "{\"a\":}",
+      "[1}",       "{\"a\":1]",    "\"abc\\",   "{\"a\"",     "1 2",
+  };
+  for (auto& json : tests) {
+    for (size_t chunk = 1; chunk <= json.size() + 1; chunk++) {
+      TypeParam doc;
+      ParseInChunks(doc, json, chunk);
+      EXPECT_TRUE(doc.HasParseError()) << json << " chunk " << chunk;
+      EXPECT_TRUE(doc.IsNull()) << json << " chunk " << chunk;
+    }
+  }
+}
+
+TYPED_TEST(StreamingParserTest, ErrorOffset) {
+  struct Case {
+    std::string json;
+    SonicError err;
+    size_t off;
+  };
+  std::vector<Case> tests = {
+      {"[1,2,]", kParseErrorInvalidChar, 5},
+      {"{\"a\":1,\"b\" 2}", kParseErrorInvalidChar, 11},
+      {"[\"abc\\g\"]", kParseErrorEscapedFormat, 5},
+      {"[1, tru]", kParseErrorInvalidChar, 5},
+      {"{\"a\":[1,2", kParseErrorEof, 9},
+      {"[\"abc", kParseErrorEof, 5},
+  };
+  for (auto& t : tests) {
+    for (size_t chunk = 1; chunk <= t.json.size(); chunk++) {
+      TypeParam doc;
+      ParseInChunks(doc, t.json, chunk);
+      EXPECT_EQ(doc.GetParseError(), t.err) << t.json << " chunk " << chunk;
+      EXPECT_EQ(doc.GetErrorOffset(), t.off) << t.json << " chunk " << chunk;
+    }
+  }
+}
+
+TYPED_TEST(StreamingParserTest, Reuse) {
+  TypeParam doc;
+  ParseInChunks(doc, "[1, 2", 2);
+  EXPECT_EQ(doc.GetParseError(), kParseErrorEof);
+  ParseInChunks(doc, "{\"a\": [true]}", 3);
+  EXPECT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc["a"][0].IsTrue());
+
+  // Parse drops the unfinished chunked parsing
+  doc.ParseChunk("[1, 2");
+  doc.Parse("\"abc\"");
+  EXPECT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.GetString(), "abc");
+  ParseInChunks(doc, "[null]", 1);
+  EXPECT_TRUE(doc[0].IsNull());
+
+  // the unfinished parsing is moved with the document
+  TypeParam other;
+  other.ParseChunk("[1, ");
+  doc = std::move(other);
+  doc.ParseChunk("2]");
+  doc.ParseChunkEnd();
+  EXPECT_FALSE(doc.HasParseError());
+  EXPECT_EQ(doc.Size(), 2u);
+}
+
+TEST(StreamingParser, SAXEvents) {
+  // The SAX events are the same as Parser's, so the handler is reused.
+  MemoryPoolAllocator<> alloc;
+  StreamSAXHandler<DNode<MemoryPoolAllocator<>>> sax(alloc);
+  StreamingParser parser;
+  std::string json = R"({"a":[1,-2,3.5,"s",null,false]})";
+  for (char c : json) {
+    ParseResult ret = parser.Feed(StringView(&c, 1), sax);
+    EXPECT_EQ(ret.Error(), kErrorNone);
+  }
+  ParseResult ret = parser.Finish(sax);
+  EXPECT_EQ(ret.Error(), kErrorNone);
+  EXPECT_EQ(ret.Offset(), json.size());
+
+  parser.Reset();
+  EXPECT_EQ(parser.Feed("[1, 2]", sax).Error(), kErrorNone);
+  EXPECT_EQ(parser.Feed("]", sax).Error(), kParseErrorInvalidChar);
+  EXPECT_EQ(parser.Finish(sax).Offset(), 6u);
+}
+
+}  // namespace
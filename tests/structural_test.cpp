@@ -0,0 +1,127 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/internal/arch/simd_structural.h"
+#include "sonic/sonic.h"
+#include "tests/test_util.h"
+
+namespace {
+
+using namespace sonic_json;
+
+std::vector<uint32_t> GetIndex(const std::string& json) {
+  std::vector<uint32_t> index(json.size() + 8);
+  size_t n = internal::BuildStructuralIndex(
+      reinterpret_cast<const uint8_t*>(json.data()), json.size(), &index[0]);
+  index.resize(n);
+  return index;
+}
+
+TEST(StructuralIndex, Basic) {
+  EXPECT_EQ(GetIndex(""), std::vector<uint32_t>());
+  EXPECT_EQ(GetIndex("  \t\r\n "), std::vector<uint32_t>());
+  EXPECT_EQ(GetIndex("123"), std::vector<uint32_t>({0}));
+  EXPECT_EQ(GetIndex(R"({"a":[1,true,"x\"y"]})"),
+            std::vector<uint32_t>({0, 1, 4, 5, 6, 7, 8, 12, 13, 19, 20}));
+  EXPECT_EQ(GetIndex(R"( [ -1.5e3 , null ] )"),
+            std::vector<uint32_t>({1, 3, 10, 12, 17}));
+  // structural chars in strings are ignored
+  EXPECT_EQ(GetIndex(R"(["{[:,]}", "\\", "\\\""])"),
+            std::vector<uint32_t>({0, 1, 9, 11, 15, 17, 23}));
+  // the scalar following a string is a new token
+  EXPECT_EQ(GetIndex(R"("a"b)"), std::vector<uint32_t>({0, 3}));
+}
+
+TEST(StructuralIndex, CrossBlocks) {
+  // strings, escapes and scalars across the 64-byte blocks
+  for (size_t pad = 0; pad < 130; pad++) {
+    std::string json = "[" + std::string(pad, ' ') + "\"" +
+                       std::string(pad, '\\') + std::string(pad, '\\') +
+                       "\\\"\",12345678901234567890,true]";
+    std::vector<uint32_t> expect = {0, uint32_t(pad + 1)};
+    size_t str_end = pad + 1 + 1 + pad * 2 + 2 + 1;
+    expect.push_back(str_end);
+    expect.push_back(str_end + 1);
+    expect.push_back(str_end + 21);
+    expect.push_back(str_end + 22);
+    expect.push_back(str_end + 26);
+    EXPECT_EQ(GetIndex(json), expect) << json;
+  }
+}
+
+TEST(StructuralIndex, ParseFiles) {
+  const char* files[] = {
+      "book",      "canada",      "citm_catalog", "github_events",
+      "gsoc-2018", "lottie",      "poet",         "twitter",
+      "twitterescaped",
+  };
+  for (const char* file : files) {
+    std::string json = test::GetTestData(file);
+    Document one, two;
+    one.Parse(json);
+    two.Parse<kParseTwoStage>(json);
+    EXPECT_FALSE(one.HasParseError()) << file;
+    EXPECT_FALSE(two.HasParseError()) << file;
+    EXPECT_TRUE(one == two) << file;
+  }
+}
+
+TEST(StructuralIndex, ParseValid) {
+  std::vector<std::string> tests = {
+      "true",
+      " false ",
+      "null",
+      "\"\"",
+      "-0.5e-3",
+      "{}",
+      "[]",
+      "[[[]]]",
+      R"({"a":{"b":[1,2,{"c":null}]},"d":"\u0041\n"})",
+      R"(  [ 1 , "x" , true , { } , [ ] ]  )",
+  };
+  for (auto& json : tests) {
+    Document one, two;
+    one.Parse(json);
+    two.Parse<kParseTwoStage>(json);
+    EXPECT_FALSE(two.HasParseError()) << json;
+    EXPECT_EQ(two.GetErrorOffset(), one.GetErrorOffset()) << json;
+    EXPECT_TRUE(one == two) << json;
+  }
+}
+
+TEST(StructuralIndex, ParseInvalid) {
+  std::vector<std::string> tests = {
+      "",          "   ",          "1.",        "truef",      "true:",
+      "tru",       "nullnull",     "[fase0]",   "[1.2x]",     "[1 x]",
+      "[truex]",   "[\"a\"b]",     "{\"\":1,}", "{:,}",       "{[]}",
+      "[[[[[[",    "[\"abc",       "[1,]",      "[1 2]",      "{\"a\" 1}",
+      "{\"a\":1 \"b\":2}", "[1]]", "\"\\g\"",   "[\"\x01\"]", "{\"a\":}",
+  };
+  for (auto& json : tests) {
+    Document one, two;
+    one.Parse(json);
+    two.Parse<kParseTwoStage>(json);
+    EXPECT_TRUE(one.HasParseError()) << json;
+    EXPECT_TRUE(two.HasParseError()) << json;
+  }
+}
+
+}  // namespace
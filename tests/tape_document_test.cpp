@@ -0,0 +1,109 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+
+namespace {
+
+using namespace sonic_json;
+
+TEST(TapeDocument, ParseScalars) {
+  TapeDocument doc;
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+
+  doc.Parse("null");
+  ASSERT_FALSE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  doc.Parse("true");
+  EXPECT_TRUE(doc.GetRoot().GetBool());
+  doc.Parse("\"short\"");
+  EXPECT_EQ(doc.GetRoot().GetStringView(), "short");
+  // the string buffer is released if all strings are inline
+  EXPECT_EQ(doc.GetMemoryUsage(), sizeof(TapeNode));
+  doc.Parse("\"hello world\"");
+  EXPECT_EQ(doc.GetRoot().GetString(), "hello world");
+  doc.Parse("-9223372036854775808");
+  EXPECT_EQ(doc.GetRoot().GetInt64(), INT64_MIN);
+  doc.Parse("18446744073709551615");
+  EXPECT_EQ(doc.GetRoot().GetUint64(), UINT64_MAX);
+  doc.Parse("0.1");
+  EXPECT_EQ(doc.GetRoot().GetDouble(), 0.1);
+}
+
+TEST(TapeDocument, ReadContainers) {
+  TapeDocument doc;
+  doc.Parse(R"({"id":1,"nested":{"a":[1,[2,3],{"b":4}],"c":{}},
+                "tags":["x",{"y":[]},"long string value"],"end":null})");
+  ASSERT_FALSE(doc.HasParseError());
+  const TapeNode& root = doc.GetRoot();
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(root.Size(), 4);
+  EXPECT_EQ(root["id"].GetInt64(), 1);
+  EXPECT_TRUE(root["end"].IsNull());
+  EXPECT_TRUE(root["unknown"].IsNull());
+  EXPECT_TRUE(root.HasMember("tags"));
+  EXPECT_FALSE(root.HasMember("nested2"));
+  EXPECT_TRUE(root.FindMember("unknown") == root.MemberEnd());
+
+  // the members are stepped over the subtrees of the values
+  std::string names;
+  for (auto m = root.MemberBegin(); m != root.MemberEnd(); ++m) {
+    names += m->name.GetString() + ",";
+  }
+  EXPECT_EQ(names, "id,nested,tags,end,");
+
+  const TapeNode& a = root["nested"]["a"];
+  ASSERT_TRUE(a.IsArray());
+  EXPECT_EQ(a.Size(), 3);
+  EXPECT_EQ(a[0].GetInt64(), 1);
+  EXPECT_EQ(a[1][1].GetInt64(), 3);
+  EXPECT_EQ(a[2]["b"].GetInt64(), 4);
+  size_t n = 0;
+  for (auto it = a.Begin(); it != a.End(); ++it) n++;
+  EXPECT_EQ(n, 3);
+  EXPECT_TRUE(root["nested"]["c"].IsObject());
+  EXPECT_TRUE(root["nested"]["c"].Empty());
+  EXPECT_EQ(root["tags"][2].GetStringView(), "long string value");
+
+  const TapeNode* node = root.AtPointer(JsonPointer({"tags", 1, "y"}));
+  ASSERT_NE(node, nullptr);
+  EXPECT_TRUE(node->IsArray());
+  EXPECT_EQ(root.AtPointer(JsonPointer({"tags", 3})), nullptr);
+  node = root.AtPointer("nested", "a", 2, "b");
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetInt64(), 4);
+}
+
+TEST(TapeDocument, ParseError) {
+  TapeDocument doc;
+  doc.Parse("{\"a\":[1,2}");
+  EXPECT_TRUE(doc.HasParseError());
+  EXPECT_TRUE(doc.GetRoot().IsNull());
+  EXPECT_EQ(doc.GetMemoryUsage(), 0);
+
+  // the moved strings are kept in the string buffer
+  doc.Parse("{\"key\":\"a long string value\"}");
+  ASSERT_FALSE(doc.HasParseError());
+  TapeDocument moved(std::move(doc));
+  EXPECT_EQ(moved.Dump(), "{\"key\":\"a long string value\"}");
+  EXPECT_EQ(doc.GetMemoryUsage(), 0);
+}
+
+}  // namespace
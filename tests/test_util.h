@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// The helpers to load the json files of the tests, which run in the root of
+// the repo.
+
+namespace sonic_json {
+namespace test {
+
+inline std::string GetJson(const std::string& file) {
+  std::ifstream ifs(file);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  return ss.str();
+}
+
+/**
+ * @brief Load ./testdata/<name>.json.
+ */
+inline std::string GetTestData(const std::string& name) {
+  return GetJson("./testdata/" + name + ".json");
+}
+
+/**
+ * @brief Load all json files in the directory and its sub-directories.
+ * @param dirname the directory name ending with '/'
+ */
+inline std::vector<std::string> GetAllJsons(const std::string& dirname) {
+  DIR* dir = opendir(dirname.c_str());
+  std::vector<std::string> jsons;
+  EXPECT_TRUE(dir != nullptr) << "Error open directory: " + dirname;
+  if (nullptr == dir) return jsons;
+  struct dirent* ent = nullptr;
+  while (nullptr != (ent = readdir(dir))) {
+    struct stat st;
+    std::string filename = dirname + ent->d_name;
+    if (lstat(filename.c_str(), &st) == -1) break;
+    if (S_ISDIR(st.st_mode)) {
+      if (ent->d_name[0] == '.') continue;
+      auto sub_jsons = GetAllJsons(filename + '/');
+      jsons.insert(jsons.end(), sub_jsons.begin(), sub_jsons.end());
+    } else {
+      auto const pos = filename.find_last_of('.');
+      if (filename.substr(pos + 1) == "json") {
+        jsons.push_back(GetJson(filename));
+      }
+    }
+  }
+  closedir(dir);
+  return jsons;
+}
+
+}  // namespace test
+}  // namespace sonic_json
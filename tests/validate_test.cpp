@@ -0,0 +1,136 @@
+/*
+ * Copyright 2022 ByteDance Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sonic/dom/validate.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sonic/sonic.h"
+#include "tests/test_util.h"
+
+namespace {
+
+using namespace sonic_json;
+
+TEST(Validate, TestData) {
+  for (const char* file : {"twitter", "twitterescaped", "canada",
+                           "citm_catalog", "github_events", "lottie"}) {
+    std::string json = test::GetTestData(file);
+    ASSERT_FALSE(json.empty()) << file;
+    auto ret = Validate(json);
+    EXPECT_EQ(ret.Error(), kErrorNone) << file;
+    EXPECT_EQ(ret.Offset(), json.size()) << file;
+  }
+}
+
+TEST(Validate, Valid) {
+  std::vector<std::string> jsons = {
+      "0",
+      " -1.5e+10 ",
+      "1E-2",
+      "true",
+      "null",
+      R"("")",
+      R"("\"\\\/\b\f\n\r\té😀")",
+      "\"\xc2\xa9\xe4\xb8\xad\xf0\x9f\x98\x80\xed\x9f\xbf\xf4\x8f\xbf\xbf\"",
+      "[]",
+      "{}",
+      R"({"a":[1,{"b":null},[[]],"c"],"d":{}})",
+      "[" + std::string(100, ' ') + "1]",
+      "\"" + std::string(100, 'x') + "\xe4\xb8\xad" + std::string(100, 'y') +
+          "\"",
+      std::string(5000, '[') + std::string(5000, ']'),
+  };
+  for (const auto& json : jsons) {
+    auto ret = Validate(json);
+    EXPECT_EQ(ret.Error(), kErrorNone) << json;
+    Document doc;
+    doc.Parse(json);
+    EXPECT_FALSE(doc.HasParseError()) << json;
+  }
+}
+
+TEST(Validate, Invalid) {
+  struct Case {
+    std::string json;
+    SonicError err;
+  };
+  std::vector<Case> cases = {
+      {"", kParseErrorEof},
+      {"  ", kParseErrorEof},
+      {"[", kParseErrorEof},
+      {"[1,", kParseErrorEof},
+      {R"({"a")", kParseErrorEof},
+      {R"("abc)", kParseErrorEof},
+      {"[1,]", kParseErrorInvalidChar},
+      {"[1 2]", kParseErrorInvalidChar},
+      {"{,}", kParseErrorInvalidChar},
+      {R"({"a":1,})", kParseErrorInvalidChar},
+      {R"({"a" 1})", kParseErrorInvalidChar},
+      {R"({1:1})", kParseErrorInvalidChar},
+      {"[}", kParseErrorInvalidChar},
+      {R"({"a":1])", kParseErrorInvalidChar},
+      {"[1]]", kParseErrorInvalidChar},
+      {"1 2", kParseErrorInvalidChar},
+      {"tru", kParseErrorInvalidChar},
+      {"nul1", kParseErrorInvalidChar},
+      {"01", kParseErrorInvalidChar},
+      {"-", kParseErrorInvalidChar},
+      {"1.", kParseErrorInvalidChar},
+      {".5", kParseErrorInvalidChar},
+      {"1e", kParseErrorInvalidChar},
+      {"[1.5x]", kParseErrorInvalidChar},
+      {"\"a\tb\"", kParseErrorUnEscaped},
+      {R"("\a")", kParseErrorEscapedFormat},
+      {R"("\u12G4")", kParseErrorEscapedUnicode},
+      {R"("\uD83D")", kParseErrorEscapedUnicode},
+      {R"("\uD83DA")", kParseErrorEscapedUnicode},
+      {"\"\xff\"", kParseErrorInvalidUTF8},
+      {"\"\xc0\xaf\"", kParseErrorInvalidUTF8},
+      {"\"\xe0\x80\xaf\"", kParseErrorInvalidUTF8},
+      {"\"\xed\xa0\x80\"", kParseErrorInvalidUTF8},
+      {"\"\xf4\x90\x80\x80\"", kParseErrorInvalidUTF8},
+      {"\"\xe4\xb8\"", kParseErrorInvalidUTF8},
+      {"\"" + std::string(100, 'x') + "\x80" + std::string(100, 'y') + "\"",
+       kParseErrorInvalidUTF8},
+      {std::string(5000, '[') + std::string(4999, ']'), kParseErrorEof},
+  };
+  for (const auto& c : cases) {
+    auto ret = Validate(c.json);
+    EXPECT_EQ(ret.Error(), c.err) << c.json;
+  }
+
+  // the NUL bytes are invalid chars, and not the end of the json
+  const std::string nul_jsons[] = {
+      std::string("[1]\0xx", 6), std::string("1\0", 2),
+      std::string("[1,\0]", 5),  std::string("{\0}", 3),
+      std::string("{\"a\"\0:1}", 8), std::string("[1\0]", 5),
+  };
+  for (const auto& json : nul_jsons) {
+    EXPECT_EQ(Validate(json).Error(), kParseErrorInvalidChar) << json;
+    Document doc;
+    doc.Parse(json);
+    EXPECT_TRUE(doc.HasParseError()) << json;
+  }
+
+  // the offset points to the invalid char
+  std::string json = "[\"" + std::string(100, 'x') + "\xff\"]";
+  EXPECT_EQ(Validate(json).Offset(), 102u);
+}
+
+}  // namespace